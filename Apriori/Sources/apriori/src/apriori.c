@@ -24,7 +24,12 @@ Instrutor: Luiz Camolesi
 #include <time.h>
 #include <assert.h>
 #include "scan.h"
+#include "random.h"
 #include "istree.h"
+#include "fpgrowth.h"
+#include "eclat.h"
+#include "lcm.h"
+#include "tidset.h"
 #ifdef STORAGE
 #include "storage.h"
 #endif
@@ -34,6 +39,8 @@ Instrutor: Luiz Camolesi
 #define TT_CLOSED   IST_CLOSED
 #define TT_MAXIMAL  IST_MAXIMAL
 #define TT_RULE     IST_EVAL
+#define TTOPT(t)    (((t) == TT_RULE)    ? "-tr" : ((t) == TT_MAXIMAL) \
+                    ? "-tm" : ((t) == TT_CLOSED) ? "-tc" : "-ts")
 
 /* --- error codes --- */
 #define E_OPTION     (-5)
@@ -47,7 +54,13 @@ Instrutor: Luiz Camolesi
 #define E_MEASURE   (-13)
 #define E_NOTRANS   (-14)
 #define E_NOFREQ    (-15)
-#define E_UNKNOWN   (-23)
+#define E_ALGO      (-21)
+#define E_TIDOUT    (-22)
+#define E_FUPOPT    (-23)
+#define E_OPTCMB    (-24)
+#define E_ALGOPT    (-25)
+#define E_ALGCMB    (-26)
+#define E_UNKNOWN   (-27)
 #define PRGNAME     "\n\nApriori"
 #define DESCRIPTION "\n*_________________________________________*\nDeveloped by Cristiano Benato & Adilson Perecin\n\n"
 #define VERSION     "Computer Science  \n" \
@@ -59,6 +72,14 @@ Instrutor: Luiz Camolesi
 #define MSG(...)
 #endif
 
+#define RDBUFSIZE     0x100000
+#define SMPERR        0.01
+#define DENSE         0.05
+#define MINLOC        10
+#define FUPTAG        "apriori-fup-1"
+#define FNVBASIS      2166136261UL
+#define FNVPRIME      16777619UL
+#define LOCEPS        1e-9
 #define SEC_SINCE(t)  ((clock()-(t)) /(double)CLOCKS_PER_SEC)
 #define RECCNT(s)     (ts_reccnt(ib_tabscan(s)) \
                       - ((ts_delim(ib_tabscan(s)) == TS_REC) ? 1 : 0))
@@ -91,8 +112,14 @@ static const char *errmsgs[] = {
                          "appearance indicator expected\n",
   /* E_UNKAPP  -20 */  "file %s, record %d: "
                          "unknown appearance indicator %s\n",
-  /*    -21 to -22 */  NULL, NULL,
-  /* E_UNKNOWN -23 */  "unknown error\n"
+  /* E_ALGO    -21 */  "invalid mining algorithm '%c'\n",
+  /* E_TIDOUT  -22 */  "transaction ids can only be written "
+                         "for frequent item sets with -Ar\n",
+  /* E_FUPOPT  -23 */  "option -%c cannot be combined with -F\n",
+  /* E_OPTCMB  -24 */  "option -%c cannot be combined with %s\n",
+  /* E_ALGOPT  -25 */  "option -%c cannot be combined with -A%c\n",
+  /* E_ALGCMB  -26 */  "option -A%c cannot be combined with %s\n",
+  /* E_UNKNOWN -27 */  "unknown error\n"
 };
 #endif
 
@@ -101,12 +128,18 @@ static char     *prgname;
 #endif
 static ITEMBASE *ibase  = NULL;
 static TABAG    *tabag  = NULL;
+static TABAG    *whole  = NULL;
+static TABAG    *cands  = NULL;
+static TABAG    *delta  = NULL;
+static TABAG    *state  = NULL;
 static TATREE   *tatree = NULL;
+static RANDOM   *rng    = NULL;
 static ISTREE   *istree = NULL;
 static ISREPORT *isrep  = NULL;
 static int      *map    = NULL;
 static FILE     *in     = NULL;
 static FILE     *out    = NULL;
+static FILE     *ftid   = NULL;
 
 static void help (void)
 {
@@ -137,6 +170,20 @@ static void help (void)
   printf("  n   maximum of individual measure values\n");
   printf("  a   average of individual measure values\n");
   printf("\n");
+  printf("mining algorithms (option -A#)\n");
+  printf("  a   apriori (item set tree, default)\n");
+  printf("  f   FP-growth (frequent pattern tree, item sets only)\n");
+  printf("  e   Eclat (transaction bit sets, on sparse data compressed\n"
+         "      tid sets, frequent item sets only)\n");
+  printf("  d   dEclat (tid lists/diffsets, frequent item sets only)\n");
+  printf("  r   Eclat (compressed tid sets, frequent item sets only,\n"
+         "      writes the transaction ids of the sets with -I#)\n");
+  printf("  h   apriori, switching to Eclat on compressed tid sets\n"
+         "      when this is estimated to be cheaper (item sets only)\n");
+  printf("  l   LCM (closure extension, closed item sets only)\n");
+  printf("  g   GenMax (tid lists/diffsets, maximal item sets only)\n");
+  printf("  x   automatic choice based on the density of the data\n");
+  printf("\n");
   printf("information output format characters (option -v#)\n");
   printf("  %%%%  a percent sign\n");
   printf("  %%a  absolute item set  support\n");
@@ -184,9 +231,15 @@ static void error (int code, ...)
   if (istree) ist_delete(istree);
   if (tatree) tt_delete(tatree, 0);
   if (tabag)  tb_delete(tabag, 0);
+  if (whole)  tb_delete(whole, 0);
+  if (cands)  tb_delete(cands, 0);
+  if (delta)  tb_delete(delta, 0);
+  if (state)  tb_delete(state, 0);
+  if (rng)    free(rng);
   if (ibase)  ib_delete(ibase);
   if (in  && (in  != stdin))  fclose(in);
   if (out && (out != stdout)) fclose(out);
+  if (ftid && (ftid != stdout)) fclose(ftid);
   #endif
   #ifdef STORAGE       
   showmem("at end of program"); 
@@ -196,6 +249,547 @@ static void error (int code, ...)
 
 /*--------------------------------------------------------------------*/
 
+static void mine (TABAG *bag, double supp, int max, int mode,
+                  int tree, int trim, int heap, int thcnt)
+{
+  int   i, k, n;
+  SUPP  wgt, smin;
+  SUPP  *frqs;
+  int   *items;
+  TRACT *t;
+
+  n    = ib_cnt(ibase);
+  frqs = (SUPP*)malloc((size_t)(n+1) *sizeof(SUPP));
+  if (!frqs) error(E_NOMEM);
+  for (i = n; --i >= 0; ) {
+    frqs[i] = ib_getfrq(ibase, i);
+    ib_setfrq(ibase, i, 0);
+  }
+  wgt = ib_getwgt(ibase);
+  for (i = tb_cnt(bag); --i >= 0; ) {
+    t = tb_tract(bag, i);
+    for (items = t_items(t); *items >= 0; items++)
+      ib_incfrq(ibase, *items, t_wgt(t));
+  }
+  ib_setwgt(ibase, tb_wgt(bag));
+  tb_sort(bag, 1, heap);
+  tb_reduce(bag);
+  if (tree) {
+    tatree = tt_create(bag);
+    if (!tatree) error(E_NOMEM);
+  }
+  smin   = (SUPP)ceil(supp *(double)tb_wgt(bag) *(1.0-LOCEPS));
+  istree = ist_create(ibase, mode, (smin > 0) ? smin : 1, tb_wgt(bag), 1);
+  if (!istree) error(E_NOMEM);
+  ist_setthcnt(istree, thcnt);
+  while (ist_height(istree) < max) {
+    k = ist_addlvl(istree);
+    if (k) { if (k > 0) break; error(E_NOMEM); }
+    if (tatree) ist_countx(istree, tatree);
+    else        ist_countb(istree, bag, trim);
+  }
+  ist_setsize(istree, 1, max, 1);
+  ist_init(istree);
+  items = t_items(ib_tract(ibase));
+  while ((k = ist_set(istree, items, NULL, NULL)) >= 0) {
+    if (k <= 0) continue;
+    t = t_create(items, k, 1);
+    if (!t || (tb_add(cands, t) != 0)) error(E_NOMEM);
+  }
+  ist_delete(istree); istree = NULL;
+  if (tatree) { tt_delete(tatree, 0); tatree = NULL; }
+  tb_sort(cands, 1, heap);
+  tb_reduce(cands);
+  for (i = n; --i >= 0; )
+    ib_setfrq(ibase, i, frqs[i]);
+  ib_setwgt(ibase, wgt);
+  free(frqs);
+}  /* mine() */
+
+/*--------------------------------------------------------------------*/
+
+static int partition (const char *fn_in, int part, double supp,
+                      int max, int mode, int tree, int trim,
+                      int heap, int thcnt)
+{
+  int   i, k, n = 0;
+  int   cnt, low;
+  int   size = 0;
+  SUPP  wgt  = 0;
+  SUPP  *frqs = NULL, *p;
+  TABAG *next;
+  TRACT *t;
+
+  low = (supp > 0) ? (int)ceil(MINLOC /supp) : 1;
+  if (part < low) {
+    MSG(stderr, "[partition size raised to %d] ", low);
+    part = low;
+  }
+  cands = tb_create(ibase);
+  if (!cands) error(E_NOMEM);
+  do {
+    for (i = ib_cnt(ibase); --i >= 0; )
+      ib_setfrq(ibase, i, 0);
+    ib_setwgt(ibase, 0);
+    next = tb_create(ibase);
+    if (!next) error(E_NOMEM);
+    while (tb_cnt(next) < part) {
+      k = ib_read(ibase, in);
+      if (k) { if (k > 0) break;
+        error(k, fn_in, RECCNT(ibase), BUFFER(ibase)); }
+      if (tb_add(next, NULL) != 0) error(E_NOMEM);
+    }
+    n += cnt = tb_cnt(next);
+    k = ib_cnt(ibase);
+    if (k > size) {
+      p = (SUPP*)realloc(frqs, (size_t)k *sizeof(SUPP));
+      if (!p) error(E_NOMEM);
+      for (frqs = p; size < k; ) frqs[size++] = 0;
+    }
+    for (i = k; --i >= 0; )
+      frqs[i] += ib_getfrq(ibase, i);
+    wgt += ib_getwgt(ibase);
+    if (tabag && (cnt < low)) {
+      for (i = 0; i < cnt; i++) {
+        t = t_clone(tb_tract(next, i));
+        if (!t || (tb_add(tabag, t) != 0)) error(E_NOMEM);
+      }
+      tb_delete(next, 0); next = NULL;
+    }
+    if (tabag) {
+      mine(tabag, supp, max, mode, tree, trim, heap, thcnt);
+      tb_delete(tabag, 0);
+    }
+    tabag = next;
+  } while (cnt >= part);
+  if (tabag) {
+    if (tb_cnt(tabag) > 0)
+      mine(tabag, supp, max, mode, tree, trim, heap, thcnt);
+    tb_delete(tabag, 0); tabag = NULL;
+  }
+  for (i = size; --i >= 0; )
+    ib_setfrq(ibase, i, frqs[i]);
+  ib_setwgt(ibase, wgt);
+  if (frqs) free(frqs);
+  return n;
+}  /* partition() */
+
+/*--------------------------------------------------------------------*/
+
+static double randu (void)
+{ return rng_double(rng); }
+
+/*--------------------------------------------------------------------*/
+
+static double smplow (double supp, int size)
+{
+  double low;
+
+  low = supp -sqrt(log(1/SMPERR) /(2.0 *size));
+  return (low > 0.5*supp) ? low : 0.5*supp;
+}  /* smplow() */
+
+/*--------------------------------------------------------------------*/
+
+static int smpsize (int size, double supp)
+{
+  int n;
+
+  n = tb_cnt(tabag);
+  while ((size < n) && (smplow(supp, size) *size < MINLOC))
+    size = (size < n/2) ? size+size : n;
+  return (size < n) ? size : n;
+}  /* smpsize() */
+
+/*--------------------------------------------------------------------*/
+
+static int sample (int size, unsigned int seed, double supp,
+                   int max, int mode, int tree, int trim,
+                   int heap, int thcnt)
+{
+  int          i;
+  unsigned int seeds[5];
+  TABAG        *smp;
+  TRACT        *t;
+
+  for (i = 0; i < 5; i++)
+    seeds[i] = seed = seed *69069 +1;
+  rng = rng_create(RNG_XORSHIFT, seeds);
+  if (!rng) error(E_NOMEM);
+  if (size > tb_cnt(tabag)) size = tb_cnt(tabag);
+  tb_select(tabag, size, randu);
+  free(rng); rng = NULL;
+  smp = tb_create(ibase);
+  if (!smp) error(E_NOMEM);
+  for (i = 0; i < size; i++) {
+    t = t_clone(tb_tract(tabag, i));
+    if (!t || (tb_add(smp, t) != 0)) error(E_NOMEM);
+  }
+  cands = tb_create(ibase);
+  if (!cands) error(E_NOMEM);
+  mine(smp, smplow(supp, size), max, mode, tree, trim, heap, thcnt);
+  tb_delete(smp, 0);
+  return tb_cnt(cands);
+}  /* sample() */
+
+/*--------------------------------------------------------------------*/
+
+static void rescan (const char *fn_in, int n, int all)
+{
+  int   i, k;
+  SUPP  wgt;
+  SUPP  *frqs;
+  TRACT *t;
+  int   *s, *d;
+
+  frqs = (SUPP*)malloc((size_t)n *sizeof(SUPP));
+  if (!frqs) error(E_NOMEM);
+  for (i = n; --i >= 0; )
+    frqs[i] = ib_getfrq(ibase, i);
+  wgt = ib_getwgt(ibase);
+  in  = fopen(fn_in, "r");
+  if (!in) error(E_FOPEN, fn_in);
+  setvbuf(in, NULL, _IOFBF, RDBUFSIZE);
+  if (all) ist_clear(istree);
+  while (1) {
+    k = ib_read(ibase, in);
+    if (k) { if (k > 0) break;
+      error(k, fn_in, RECCNT(ibase), BUFFER(ibase)); }
+    t = ib_tract(ibase);
+    for (s = d = t_items(t); *s >= 0; s++)
+      if (*s < n) *d++ = *s;
+    *d = -1;
+    t_size(t) = (int)(d -t_items(t));
+    if (all) ist_countall(istree, t_items(t), t_size(t), t_wgt(t));
+    else     ist_count   (istree, t_items(t), t_size(t), t_wgt(t));
+  }
+  fclose(in); in = NULL;
+  for (i = n; --i >= 0; )
+    ib_setfrq(ibase, i, frqs[i]);
+  ib_setwgt(ibase, wgt);
+  free(frqs);
+}  /* rescan() */
+
+/*--------------------------------------------------------------------*/
+
+static int fupinit (const char *fn, SUPP *supp, int *max,
+                    unsigned long *hash)
+{
+  int     i, d;
+  double  v[3];
+  char    *s;
+  FILE    *file;
+  TABSCAN *tsc;
+
+  file = fopen(fn, "r");
+  if (!file) return -1;
+  tsc = ts_create();
+  if (!tsc) { fclose(file); error(E_NOMEM); }
+  d = ts_next(tsc, file, NULL, 0);
+  if (strcmp(ts_buf(tsc), FUPTAG) != 0) d = TS_ERR;
+  for (i = 0; (i < 3) && (d == TS_FLD); i++) {
+    d = ts_next(tsc, file, NULL, 0);
+    v[i] = strtod(ts_buf(tsc), &s);
+    if ((s == ts_buf(tsc)) || *s || (v[i] < 0) || (v[i] != floor(v[i])))
+      break;
+  }
+  if ((i == 3) && (d == TS_FLD)) {
+    d = ts_next(tsc, file, NULL, 0);
+    *hash = strtoul(ts_buf(tsc), &s, 16);
+    if ((s == ts_buf(tsc)) || *s || (d == TS_FLD)) i = 0;
+  }
+  else i = 0;
+  ts_delete(tsc);
+  fclose(file);
+  if ((i < 3) || (v[1] <= 0) || (v[1] >= (double)SUPP_MAX)
+  ||  (v[0] > INT_MAX))
+    error(E_FREAD, fn);
+  *supp = (SUPP)v[1];
+  *max  = (v[2] < INT_MAX) ? (int)v[2] : INT_MAX;
+  return (int)v[0];
+}  /* fupinit() */
+
+/*--------------------------------------------------------------------*/
+
+static unsigned long fuphash (unsigned long hash)
+{
+  const int  *p;
+  const char *s;
+  TRACT      *t;
+
+  t = ib_tract(ibase);
+  for (p = t_items(t); *p >= 0; p++) {
+    for (s = ib_name(ibase, *p); *s; s++)
+      hash = ((hash ^ (unsigned char)*s) *FNVPRIME) & 0xffffffffUL;
+    hash = (hash *FNVPRIME) & 0xffffffffUL;
+  }
+  hash = ((hash ^ (unsigned long)t_wgt(t)) *FNVPRIME) & 0xffffffffUL;
+  return ((hash ^ '\n') *FNVPRIME) & 0xffffffffUL;
+}  /* fuphash() */
+
+/*--------------------------------------------------------------------*/
+
+static int fupload (const char *fn)
+{
+  int     i, k, n, d;
+  int     *items;
+  char    *s;
+  double  x;
+  SUPP    supp;
+  TABSCAN *tsc;
+  TRACT   *t;
+
+  state = tb_create(ibase);
+  if (!state) error(E_NOMEM);
+  n     = ib_cnt(ibase);
+  items = (int*)malloc((size_t)(n+1) *sizeof(int));
+  tsc   = ts_create();
+  if (!items || !tsc) error(E_NOMEM);
+  in = fopen(fn, "r");
+  if (!in) error(E_FOPEN, fn);
+  do d = ts_next(tsc, in, NULL, 0);
+  while (d == TS_FLD);
+  while (d == TS_REC) {
+    d    = ts_next(tsc, in, NULL, 0);
+    x = strtod(ts_buf(tsc), &s);
+    if ((d == TS_EOF) && (s == ts_buf(tsc))) break;
+    if ((s == ts_buf(tsc)) || *s || (x < 0) || (x != floor(x))
+    ||  (x >= (double)SUPP_MAX))
+      error(E_FREAD, fn);
+    supp = (SUPP)x;
+    for (k = 0; d == TS_FLD; ) {
+      d = ts_next(tsc, in, NULL, 0);
+      i = ib_item(ibase, ts_buf(tsc));
+      if ((i < 0) || (i >= n) || (k > n)) k = n+1;
+      else items[k++] = i;
+    }
+    if ((k < 2) || (k > n)) continue;
+    t = t_create(items, k, supp);
+    if (!t) error(E_NOMEM);
+    t_sort(t);
+    if (tb_add(state, t) != 0) error(E_NOMEM);
+  }
+  if (d == TS_ERR) error(E_FREAD, fn);
+  fclose(in); in = NULL;
+  free(items);
+  ts_delete(tsc);
+  return tb_cnt(state);
+}  /* fupload() */
+
+/*--------------------------------------------------------------------*/
+
+static int fupsave (const char *fn, int recs, SUPP supp, int max,
+                    unsigned long hash)
+{
+  int  n;
+  FILE *file;
+
+  file = fopen(fn, "w");
+  if (!file) error(E_FOPEN, fn);
+  fprintf(file, FUPTAG " %d " SUPP_FMT " %d %08lx\n",
+          recs, supp, max, hash);
+  n = ist_save(istree, file);
+  if ((fclose(file) != 0) || (n < 0)) error(E_FWRITE, fn);
+  return n;
+}  /* fupsave() */
+
+/*--------------------------------------------------------------------*/
+
+static void update (SUPP supp, int max, int trim)
+{
+  ist_countb(istree, delta, trim);
+  ist_fup(istree, state, (ist_height(istree) <= max) ? supp-1 : -1,
+          tatree, tabag);
+}  /* update() */
+
+/*--------------------------------------------------------------------*/
+
+static void rebuild (int lo, int hi, SUPP supp, SUPP low, SUPP smax,
+                     int max, int mode, int thcnt)
+{
+  int   i, k;
+  int   *items;
+  TRACT *t;
+
+  if (istree) { ist_delete(istree); istree = NULL; }
+  for (i = ib_cnt(ibase); --i >= 0; )
+    ib_setfrq(ibase, i, 0);
+  for (i = lo; i < hi; i++) {
+    t = tb_tract(tabag, i);
+    for (items = t_items(t); *items >= 0; items++)
+      ib_incfrq(ibase, *items, t_wgt(t));
+  }
+  istree = ist_create(ibase, mode, low, smax, 1);
+  if (!istree) error(E_NOMEM);
+  ist_setthcnt(istree, thcnt);
+  while (ist_height(istree) < max) {
+    k = ist_addlvl(istree);
+    if (k) { if (k > 0) break; error(E_NOMEM); }
+    for (i = lo; i < hi; i++)
+      ist_countt(istree, tb_tract(tabag, i));
+  }
+  ist_window(istree, 1);
+  ist_setsupp(istree, supp);
+}  /* rebuild() */
+
+/*--------------------------------------------------------------------*/
+
+static int slide (int size, int step, SUPP supp, SUPP smax,
+                  int min, int max, int mode, int thcnt, int *built)
+{
+  int   i, n, cnt = 0;
+  int   lo, hi, k;
+  SUPP  low;
+  TRACT *t;
+
+  n   = tb_cnt(tabag);
+  low = supp -(SUPP)step;
+  if (low < (supp+1)/2) low = (supp+1)/2;
+  *built = 0;
+  for (lo = 0; 1; lo = k) {
+    hi = lo +size;
+    if (!istree || (ist_window(istree, 0) > 0)) {
+      rebuild(lo, hi, supp, low, smax, max, mode, thcnt); (*built)++; }
+    fprintf(out, "# transactions %d-%d\n", lo+1, hi);
+    ist_setsize(istree, min, max, 0);
+    ist_init   (istree);
+    cnt += ist_report(istree, isrep);
+    if (hi >= n) break;
+    k = (n -hi > step) ? lo +step : n -size;
+    for (i = lo; i < k; i++) {
+      t = tb_tract(tabag, i);
+      ist_slide(istree, t_items(t), t_size(t), -t_wgt(t));
+    }
+    for (i = hi; i < k +size; i++) {
+      t = tb_tract(tabag, i);
+      ist_slide(istree, t_items(t), t_size(t),  t_wgt(t));
+    }
+  }
+  return cnt;
+}  /* slide() */
+
+/*--------------------------------------------------------------------*/
+
+static double density (SUPP supp)
+{
+  int    i, n;
+  double sum;
+
+  for (sum = 0, n = 0, i = ib_cnt(ibase); --i >= 0; ) {
+    if (ib_getfrq(ibase, i) < supp) continue;
+    sum += (double)ib_getfrq(ibase, i); n++;
+  }
+  if ((n <= 0) || (ib_getwgt(ibase) <= 0)) return 0;
+  return sum /((double)ib_getwgt(ibase) *n);
+}  /* density() */
+
+/*--------------------------------------------------------------------*/
+
+static int vertical (int h, clock_t tc)
+{
+  int    i, k, n;
+  double a, v, w, c, occ;
+  TRACT  *t;
+
+  if ((h < 2) || (tc < CLOCKS_PER_SEC/100))
+    return 0;
+  n = ist_check(istree, map);
+  if (n <= 0) return 0;
+  for (a = occ = 0, i = tb_cnt(tabag); --i >= 0; ) {
+    t = tb_tract(tabag, i);
+    occ += t_size(t);
+    for (c = 1, k = 0; (k <= h) && (c > 0); k++)
+      c *= (double)(t_size(t)-k) /(double)(k+1);
+    if (c > 0)
+      a += (c < ist_ccnt(istree, h-1)) ? c : ist_ccnt(istree, h-1);
+  }
+  w = occ /n /(tb_cnt(tabag)/TDS_CHUNK +1);
+  w = (w > TDS_MAXARR) ? tb_cnt(tabag)/32.0 : 0.5 *occ /n;
+  v = (double)ist_ccnt(istree, h-1) *(w +1)
+    * (1 +0.5 *ist_ccnt(istree, h-1) /ist_nodecnt(istree, h-1));
+  return (v < a);
+}  /* vertical() */
+
+/*--------------------------------------------------------------------*/
+
+static int descend (ECLAT *ecl, int *pfx, int n, int h,
+                    int *exts, SUPP *supps, SUPP supp)
+{
+  int  i, k, m, r;
+  SUPP s;
+
+  if (n >= h-1) {
+    for (m = 0, i = ist_next(istree, -1); i >= 0;
+         i = ist_next(istree, i)) {
+      s = ist_supp(istree, i);
+      if (s >= supp) { exts[m] = i; supps[m++] = s; }
+    }
+    return (m > 0) ? ecl_class(ecl, pfx, n, exts, supps, m) : 0;
+  }
+  for (r = 0, i = ist_next(istree, -1); i >= 0;
+       i = ist_next(istree, i)) {
+    s = ist_supp(istree, i);
+    if ((s < supp) || (ist_down(istree, i) < 0)) continue;
+    pfx[n] = i; isr_add(isrep, i, s);
+    k = descend(ecl, pfx, n+1, h, exts, supps, supp);
+    isr_remove(isrep, 1); ist_up(istree, 0);
+    if (k < 0) return -1;
+    r += k;
+  }
+  return r;
+}  /* descend() */
+
+/*--------------------------------------------------------------------*/
+
+static int finish (int h, SUPP supp)
+{
+  int   n, r;
+  int   *pfx;
+  SUPP  *supps;
+  ECLAT *ecl;
+
+  n     = ib_cnt(ibase);
+  pfx   = (int*) malloc((size_t)(h+n) *sizeof(int));
+  supps = (SUPP*)malloc((size_t) n    *sizeof(SUPP));
+  ecl   = ecl_create(tabag, supp, isrep);
+  r     = -1;
+  if (pfx && supps && ecl) {
+    ist_up(istree, 1);
+    r = descend(ecl, pfx, 0, h, pfx +h, supps, supp);
+  }
+  if (ecl)   ecl_delete(ecl);
+  if (supps) free(supps);
+  if (pfx)   free(pfx);
+  return r;
+}  /* finish() */
+
+/*--------------------------------------------------------------------*/
+
+static int project (int lo, int hi, int heap)
+{
+  int       i, k;
+  const int *items;
+  TRACT     *t;
+
+  tabag = tb_create(ibase);
+  if (!tabag) error(E_NOMEM);
+  for (i = 0; i < tb_cnt(whole); i++) {
+    t = tb_tract(whole, i);
+    for (items = t_items(t); (*items >= 0) && (*items < lo); items++);
+    if ((*items < 0) || (*items >= hi))
+      continue;
+    k = t_size(t) -(int)(items -t_items(t));
+    if (k < 2) continue;
+    t = t_create(items, k, t_wgt(t));
+    if (!t || (tb_add(tabag, t) != 0)) error(E_NOMEM);
+  }
+  if (tb_cnt(tabag) <= 0) return 0;
+  tb_sort(tabag, 1, heap);
+  return tb_reduce(tabag);
+}  /* project() */
+
+/*--------------------------------------------------------------------*/
+
 int main (int argc, char *argv[])
 {                              
   int     i, k = 0, n;          
@@ -204,6 +798,8 @@ int main (int argc, char *argv[])
   char    *fn_in   = NULL;      
   char    *fn_out  = NULL;    
   char    *fn_app  = NULL;     
+  char    *fn_tid  = NULL;
+  char    *fn_fup  = NULL;
   char    *blanks  = NULL;   
   char    *fldseps = NULL;     
   char    *recseps = NULL;      
@@ -213,6 +809,7 @@ int main (int argc, char *argv[])
   char    *dflt    = "  (%1S)"; 
   char    *format  = dflt;      
   int     target   = 's';     
+  int     algo     = 'a';       
   int     min      = 1;        
   int     max      = INT_MAX;   
   double  supp     = 0.1;       
@@ -226,14 +823,40 @@ int main (int argc, char *argv[])
   double  filter   = 0.1;       
   int     sort     = 2;         
   int     tree     = 1;         
+  int     trim     = 1;         
+  int     dhp      = 0;         
+  int     spec     = 0;         
+  int     thcnt    = 1;         
+  int     batch    = 0;         
+  int     part     = 0;         
+  int     stream   = 0;         
+  int     smpsz    = 0;         
+  int     topk     = 0;         
+  double  maxmem   = 0;         
+  unsigned int seed = 0;        
   int     heap     = 1;         
   int     post     = 0;        
   int     report   = 0;       
   int     mode     = APP_BODY|IST_PERFECT;  
-  int     size;               
-  int     wgt;                  
-  int     frq, body, head;     
+  int     size     = 0;         
+  int     m, lo, hi, cnt;
+  int     vert     = 0;       
+  int     fuprec   = -1;
+  unsigned long fuphsh   = 0;
+  unsigned long hash     = FNVBASIS, hpre = FNVBASIS;
+  int     fupmax   = 0;
+  SUPP    fupsupp  = 0;
+  int     umax;
+  int     winsz    = 0;
+  int     step     = 0;
+  SUPP    wgt;                  
+  SUPP    frq, body, head;     
+  SUPP    raised;               
+  SUPP    smx, low;
+  int     capped;
+  double  dens;                 
   int     *items;             
+  TRACT   *tract;               
   clock_t t, tt, tc, x;         
 
   #ifndef QUIET               
@@ -293,6 +916,18 @@ int main (int argc, char *argv[])
           case 'q': sort   = (int)strtol(s, &s, 0); break;
           case 'u': filter =      strtod(s, &s);    break;
           case 'h': tree   = 0;                     break;
+          case 'z': trim   = 0;                     break;
+          case 'w': dhp    = (int)strtol(s, &s, 0); break;
+          case 'M': spec   = (int)strtol(s, &s, 0); break;
+          case 'T': thcnt  = (int)strtol(s, &s, 0); break;
+          case 'D': batch  = (int)strtol(s, &s, 0); break;
+          case 'P': part   = (int)strtol(s, &s, 0); break;
+          case 'R': stream = 1;                     break;
+          case 'K': topk   = (int)strtol(s, &s, 0); break;
+          case 'B': maxmem =      strtod(s, &s);    break;
+          case 'Z': smpsz  = (int)strtol(s, &s, 0); break;
+          case 'A': algo   = (*s) ? *s++ : 'a';     break;
+          case 'X': seed   = (unsigned int)strtoul(s, &s, 0); break;
           case 'j': heap   = 0;                     break;
           case 'x': mode  &= ~IST_PERFECT;          break;
           case 'y': post   = 1;                     break;
@@ -300,6 +935,10 @@ int main (int argc, char *argv[])
           case 'f': optarg = &fldseps;              break;
           case 'r': optarg = &recseps;              break;
           case 'C': optarg = &comment;              break;
+          case 'I': optarg = &fn_tid;               break;
+          case 'F': optarg = &fn_fup;               break;
+          case 'W': winsz  = (int)strtol(s, &s, 0); break;
+          case 'V': step   = (int)strtol(s, &s, 0); break;
           default : error(E_OPTION, *--s);          break;
         }                       
         if (optarg && *s) { *optarg = s; optarg = NULL; break; }
@@ -325,6 +964,11 @@ int main (int argc, char *argv[])
     case 'r': target = TT_RULE;              break;
     default : error(E_TARGET, (char)target); break;
   }
+  switch (algo) {               
+    case 'a': case 'f': case 'e': case 'd': case 'r':
+    case 'h': case 'l': case 'g': case 'x': break;
+    default : error(E_ALGO,   (char)algo);   break;
+  }
   if (min < 0) error(E_SIZE, min); 
   if (max < 0) error(E_SIZE, max); 
   if (supp  > 1)                
@@ -359,6 +1003,117 @@ int main (int argc, char *argv[])
     mode |= APP_BOTH; conf = 1;}
   if ((filter <= -1) || (filter >= 1))
     filter = 0;                 
+  if (algo == 'x') {
+    if ((target == TT_RULE) || (smax < 1)
+    ||  ((eval > IST_NONE) && (eval != IST_LOGQ)))
+      algo = 'a'; }
+  else if (algo != 'a') {
+    if (target == TT_RULE) error(E_ALGCMB, (char)algo, "-tr");
+    if (smax   <  1)       error(E_ALGCMB, (char)algo, "-S");
+    if ((eval > IST_NONE) && (eval != IST_LOGQ))
+                           error(E_ALGCMB, (char)algo, "-e");
+  }
+  if ((algo == 'h') && (target != TT_SET))
+    error(E_ALGCMB, 'h', TTOPT(target));
+  if (((algo == 'e') || (algo == 'd') || (algo == 'r'))
+  &&  (target != TT_SET))
+    error(E_ALGCMB, (char)algo, TTOPT(target));
+  if (algo == 'l') {
+    if (target != TT_CLOSED) error(E_ALGCMB, 'l', TTOPT(target));
+    if (max    <  INT_MAX)   error(E_ALGCMB, 'l', "-n");
+  }
+  if (algo == 'g') {
+    if (target != TT_MAXIMAL) error(E_ALGCMB, 'g', TTOPT(target));
+    if (max    <  INT_MAX)    error(E_ALGCMB, 'g', "-n");
+  }
+  if (fn_fup) {
+    i = (prune  >  0)  ? 'p' : (algo   != 'a') ? 'A'
+      : (batch  >  0)  ? 'D' : (part   >  0)   ? 'P'
+      : (stream)       ? 'R' : (smpsz  >  0)   ? 'Z'
+      : (topk   >  0)  ? 'K' : (dhp    >  0)   ? 'w'
+      : (spec   >  0)  ? 'M' : (maxmem >  0)   ? 'B'
+      : (post)         ? 'y' : (winsz  >  0)   ? 'W' : 0;
+    if (i) error(E_FUPOPT, i);
+    if ((mode & IST_PERFECT) || (filter != 0))
+      MSG(stderr, "[-F implies -x -u0: no perfect extension pruning "
+                  "and no transaction filtering]\n");
+    filter = 0; mode &= ~IST_PERFECT;
+  }
+  umax = max;
+  if (winsz > 0) {
+    if (target != TT_SET)  error(E_OPTCMB, 'W', TTOPT(target));
+    if (eval > IST_NONE)   error(E_OPTCMB, 'W', "-e");
+    if (algo != 'a')       error(E_ALGOPT, 'W', (char)algo);
+    i = (batch  >  0) ? 'D' : (part   > 0) ? 'P' : (stream) ? 'R'
+      : (smpsz  >  0) ? 'Z' : (topk   > 0) ? 'K'
+      : (dhp    >  0) ? 'w' : (spec   > 0) ? 'M'
+      : (maxmem >  0) ? 'B' : (post)       ? 'y'
+      : (dir   !=  0) ? 'l' : 0;
+    if (i) error(E_OPTCMB, i, "-W");
+    if ((mode & IST_PERFECT) || (filter != 0))
+      MSG(stderr, "[-W implies -x -u0: no perfect extension pruning "
+                  "and no transaction filtering]\n");
+    filter = 0; tree = 0;
+    mode = (mode & ~IST_PERFECT) | IST_WINDOW; }
+  if (algo != 'a') {
+    i = (batch  >  0) ? 'D' : (part   > 0) ? 'P' : (stream) ? 'R'
+      : (smpsz  >  0) ? 'Z' : (topk   > 0) ? 'K'
+      : (dhp    >  0) ? 'w' : (spec   > 0) ? 'M' : 0;
+    if (i) error(E_ALGOPT, i, (char)algo);
+  }
+  if (fn_tid && (algo != 'r'))
+    error(E_TIDOUT);
+  if (topk > 0) {
+    if (target != TT_SET)  error(E_OPTCMB, 'K', TTOPT(target));
+    if (eval > IST_NONE)   error(E_OPTCMB, 'K', "-e");
+    i = (batch  >  0) ? 'D' : (part   > 0) ? 'P'
+      : (smpsz  >  0) ? 'Z' : (spec   > 0) ? 'M' : 0;
+    if (i) error(E_OPTCMB, i, "-K");
+    if (mode & IST_PERFECT)
+      MSG(stderr, "[-K implies -x: no perfect extension pruning]\n");
+    mode &= ~IST_PERFECT;
+  }
+  if (smpsz > 0) {
+    if (target == TT_RULE) error(E_OPTCMB, 'Z', "-tr");
+    if (prune  >  0)       error(E_OPTCMB, 'Z', "-p");
+    if (supp   <  0)       error(E_OPTCMB, 'Z', "an absolute support");
+    if (supp   <= 0)       error(E_OPTCMB, 'Z', "a zero support");
+    i = (batch  >  0) ? 'D' : (part   > 0) ? 'P' : (stream) ? 'R'
+      : (dhp    >  0) ? 'w' : (spec   > 0) ? 'M' : 0;
+    if (i) error(E_OPTCMB, i, "-Z");
+    if ((mode & IST_PERFECT) || (filter != 0))
+      MSG(stderr, "[-Z implies -x -u0: no perfect extension pruning "
+                  "and no transaction filtering]\n");
+  }
+  if (part > 0) {
+    if (target == TT_RULE) error(E_OPTCMB, 'P', "-tr");
+    if (prune  >  0)       error(E_OPTCMB, 'P', "-p");
+    if (supp   <  0)       error(E_OPTCMB, 'P', "an absolute support");
+    if (!fn_in || !*fn_in) error(E_OPTCMB, 'P', "standard input");
+    i = (batch  >  0) ? 'D' : (stream)     ? 'R'
+      : (dhp    >  0) ? 'w' : (spec   > 0) ? 'M' : 0;
+    if (i) error(E_OPTCMB, i, "-P");
+    if ((mode & IST_PERFECT) || (filter != 0))
+      MSG(stderr, "[-P implies -x -u0: no perfect extension pruning "
+                  "and no transaction filtering]\n");
+  }
+  if ((part > 0) || (smpsz > 0)) {
+    batch = dhp = spec = 0; filter = 0; mode &= ~IST_PERFECT; }
+  if (seed == 0) seed = (unsigned int)time(NULL);
+  if (stream) {
+    if (part   >  0)       error(E_OPTCMB, 'R', "-P");
+    if (!fn_in || !*fn_in) error(E_OPTCMB, 'R', "standard input");
+    if (filter != 0)
+      MSG(stderr, "[-R implies -u0: no transaction filtering]\n");
+    filter = 0;
+  }
+  if (batch > 0) {
+    if (target != TT_SET)
+      error(E_OPTCMB, 'D', TTOPT(target));
+    if ((eval > IST_NONE) && (eval < IST_LOGQ) && (aggm != IST_NONE))
+      error(E_OPTCMB, 'D', "-a");
+    filter = 0;
+  }
 
   ibase = ib_create(-1);       
   if (!ibase) error(E_NOMEM);  
@@ -388,67 +1143,167 @@ int main (int argc, char *argv[])
     in = stdin; fn_in = "<stdin>"; }   
   MSG(stderr, "reading %s ... ", fn_in);
   if (!in) error(E_FOPEN, fn_in);
-  tabag = tb_create(ibase);     
-  if (!tabag) error(E_NOMEM);   
-  while (1) {                
-    k = ib_read(ibase, in);     
-    if (k) { if (k > 0) break; 
-      error(k, fn_in, RECCNT(ibase), BUFFER(ibase)); }
-    if (tb_add(tabag, NULL) != 0) error(E_NOMEM);
-  }                            
+  if (part > 0)                 
+    k = partition(fn_in, part, supp, max, mode, tree, trim, heap, thcnt);
+  else if (stream) {            
+    for (k = size = 0; (i = ib_read(ibase, in)) == 0; k++)
+      if (t_size(ib_tract(ibase)) > size) size = t_size(ib_tract(ibase));
+    if (i < 0) error(i, fn_in, RECCNT(ibase), BUFFER(ibase));
+  }
+  else {                        
+    if (fn_fup) fuprec = fupinit(fn_fup, &fupsupp, &fupmax, &fuphsh);
+    if (fuprec >= 0) {
+      delta = tb_create(ibase);
+      if (!delta) error(E_NOMEM);
+    }
+    tabag = tb_create(ibase);     
+    if (!tabag) error(E_NOMEM);   
+    while (1) {                
+      k = ib_read(ibase, in);     
+      if (k) { if (k > 0) break; 
+        error(k, fn_in, RECCNT(ibase), BUFFER(ibase)); }
+      if (tb_add((delta && (tb_cnt(tabag) >= fuprec)) ? delta : tabag,
+                 NULL) != 0) error(E_NOMEM);
+      if (!fn_fup) continue;
+      hash = fuphash(hash);
+      if (!delta || (tb_cnt(delta) <= 0)) hpre = hash;
+    }                            
+    k = tb_cnt(tabag);         
+    if (delta && ((k < fuprec) || (hpre != fuphsh))) {
+      if (k >= fuprec)
+        MSG(stderr, "[%s does not match the data] ", fn_fup);
+      for (i = 0; i < tb_cnt(delta); i++) {
+        tract = t_clone(tb_tract(delta, i));
+        if (!tract || (tb_add(tabag, tract) != 0)) error(E_NOMEM);
+      }
+      k = tb_cnt(tabag);
+      tb_delete(delta, 0); delta = NULL;
+    }
+    if (delta) k += tb_cnt(delta);
+    fuprec = k;
+  }
   if (in != stdin) fclose(in);  
   in  = NULL;                  
   n   = ib_cnt(ibase);          
-  k   = tb_cnt(tabag);         
-  wgt = tb_wgt(tabag);          
+  wgt = ib_getwgt(ibase);       
   MSG(stderr, "[%d item(s), ", n);
   if (k == wgt) MSG(stderr,    "%d transaction(s)]", k);
-  else          MSG(stderr, "%d/%d transaction(s)]", k, wgt);
+  else          MSG(stderr, "%d/" SUPP_FMT " transaction(s)]", k, wgt);
   MSG(stderr, " done [%.2fs].", SEC_SINCE(t));
   if ((n <= 0) || (wgt <= 0))  
     error(E_NOTRANS);           
   MSG(stderr, "\n");            
+  if (winsz > 0) {
+    if (winsz > k) winsz = k;
+    if ((step <= 0) || (step > winsz)) step = winsz;
+    ib_setwgt(ibase, wgt = (SUPP)winsz);
+  }
   if (format == dflt) {       
     if (target != TT_RULE) format = (supp < 0) ? "  (%a)" : "  (%1S)";
     else format = (supp < 0) ? "  (%b, %1C)" : "  (%1X, %1C)";
   }                            
   supp = ceil (((supp < 0) ? -100 : wgt) *supp);
   smax = floor(((smax < 0) ? -100 : wgt) *smax);
+  if (algo == 'x') {            
+    dens = density((SUPP)supp); 
+    if (target == TT_SET) algo = (dens >= DENSE) ? 'e' : 'a';
+    else if ((target == TT_CLOSED) && (max >= INT_MAX))
+                          algo = (dens >= DENSE) ? 'l' : 'f';
+    else                  algo = (dens >= DENSE) ? 'a' : 'f';
+    MSG(stderr, "density %.3f: mining with %s\n", dens,
+        (algo == 'e') ? "Eclat" : (algo == 'f') ? "FP-growth"
+      : (algo == 'l') ? "LCM"   : "apriori");
+  }                             
+  if (algo == 'h') {            
+    tree = 0; dir = 0; maxmem = 0; mode &= ~IST_PERFECT; }
+  else if (algo != 'a') {       
+    tree = (algo == 'f'); filter = 0; dir = 0;
+    if (algo != 'l') sort = -sort; }
 
   
   t = clock();                  
   MSG(stderr, "filtering, sorting and recoding items ... ");
   map = (int*)malloc(n *sizeof(int));
   if (!map) error(E_NOMEM);     
-  k = (int)((mode & APP_HEAD) ? supp : ceil(supp *conf));
-  n = ib_recode(ibase, k, sort, map);
-  tb_recode(tabag, map);       
-  tb_itsort(tabag, 1, heap);    
+  n = ib_recode(ibase, (SUPP)((mode & APP_HEAD) ? supp : ceil(supp *conf)),
+                sort, map);
+  if (cands) {                  
+    for (i = tb_cnt(cands); --i >= 0; ) {
+      items = t_items(tb_tract(cands, i));
+      while ((*items >= 0) && (map[*items] >= 0)) items++;
+      if (*items >= 0) t_wgt(tb_tract(cands, i)) = 0;
+    }                           
+    tb_recode(cands, map);      
+    tb_itsort(cands, 1, heap);  
+    tb_sort  (cands, 1, heap);  
+    tb_reduce(cands); }         
+  else if (tabag) {             
+    tb_recode(tabag, map);       
+    tb_itsort(tabag, 1, heap); }
+  if (delta) {
+    tb_recode(delta, map);
+    tb_itsort(delta, 1, heap);
+  }
   free(map); map = NULL;        
   MSG(stderr, "[%d item(s)] done [%.2fs].", n, SEC_SINCE(t));
   if (n <= 0) error(E_NOFREQ); 
   MSG(stderr, "\n");            
-  k   = tb_max(tabag);         
+
+  if (smpsz > 0) {
+    k = smpsize(smpsz, supp /wgt);
+    if (k >= tb_cnt(tabag)) {
+      MSG(stderr, "sample too small for the minimum support, "
+                  "mining all transactions\n");
+      smpsz = 0; }
+    else if (k > smpsz) {
+      MSG(stderr, "sample size raised to %d transaction(s)\n", k);
+      smpsz = k;
+    }
+  }
+  if (smpsz > 0) {              
+    t = clock();                
+    MSG(stderr, "mining a sample of %d transaction(s) ... ", smpsz);
+    k = sample(smpsz, seed, supp /wgt, max, mode, tree, trim, heap, thcnt);
+    MSG(stderr, "[%d set(s)] done [%.2fs].\n", k, SEC_SINCE(t));
+  }
+  if (delta) {
+    t = clock();
+    MSG(stderr, "reading %s ... ", fn_fup);
+    k = fupload(fn_fup);
+    MSG(stderr, "[%d set(s), %d new transaction(s)] done [%.2fs].\n",
+        k, tb_cnt(delta), SEC_SINCE(t));
+  }
+  k   = (cands) ? tb_max(cands) : (tabag) ? tb_max(tabag) : size;
+  if (delta && (tb_max(delta) > k)) k = tb_max(delta);
   if (max > k) max = k;         
 
 
-  t = clock();                  
-  MSG(stderr, "reducing transactions ... ");
-  tb_filter(tabag, min, NULL);  
-  tb_sort(tabag, 1, heap);      
-  k = tb_reduce(tabag);         
-  if (k == wgt) MSG(stderr,    "[%d transaction(s)]", k);
-  else          MSG(stderr, "[%d/%d transaction(s)]", k, wgt);
-  MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  if (tabag && (winsz <= 0)) {
+    t = clock();                  
+    MSG(stderr, "reducing transactions ... ");
+    tb_filter(tabag, (fn_fup) ? 0 : min, NULL);
+    if (fn_tid) k = tb_cnt(tabag);
+    else {                      
+      tb_sort(tabag, 1, heap);  
+      k = tb_reduce(tabag);     
+    }
+    if (delta) {
+      tb_sort(delta, 1, heap);
+      k += tb_reduce(delta);
+    }
+    if (k == wgt) MSG(stderr,    "[%d transaction(s)]", k);
+    else          MSG(stderr, "[%d/" SUPP_FMT " transaction(s)]", k, wgt);
+    MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+  }
 
   
   tt = 0;                      
-  if (tree) {                   
+  if (tree && tabag && (batch <= 0)) {
     t = clock();               
     MSG(stderr, "building transaction tree ... ");
     tatree = tt_create(tabag);  
     if (!tatree) error(E_NOMEM);
-    if (filter == 0) {          
+    if ((filter == 0) && !cands) {
       tb_delete(tabag, 0);      
       tabag = NULL;             
     }
@@ -458,133 +1313,303 @@ int main (int argc, char *argv[])
   }                             
 
 
-  t = clock(); tc = 0;         
-  istree = ist_create(ibase, mode, (int)supp, (int)smax, conf);
-  if (!istree) error(E_NOMEM);  
-  ist_seteval(istree, eval, aggm, minval, prune);
-
-  /* --- check item subsets --- */
-  MSG(stderr, "checking subsets of size 1");
-  map = (int*)malloc(n *sizeof(int));
-  if (!map) error(E_NOMEM);     
-  while (1) {                   
-    size = ist_height(istree);  
-    if (size >= max) break;     
-    if ((filter != 0)        
-    &&  (ist_check(istree, map) <= size))
-      break;                  
-    if (post)                  
-      ist_prune(istree);       
-    k = ist_addlvl(istree);     
-    if (k) { if (k > 0) break;
-             error(E_NOMEM);  } 
-    if (((filter < 0)           
-    &&   (i < -filter *n))      
-    ||  ((filter > 0)          
-    &&   (i < n) && (i *(double)tt < filter *n *tc))) {
-      n = i;                   
-      x = clock();             
-      tb_filter(tabag, size+1, map);
-      tb_sort(tabag, 0, heap);  
-      tb_reduce(tabag);         
-      if (tatree) {             
-        tt_delete(tatree, 0);   
-        tatree = tt_create(tabag);
-        if (!tatree) error(E_NOMEM);
-      }                         
-      tt = clock() -x;          
-    }
-    MSG(stderr, " %d", ++size); 
-    x = clock();             
-    if (tatree) ist_countx(istree, tatree);
-    else        ist_countb(istree, tabag);
-    tc = clock() -x;           
-  }                             
-  free(map); map = NULL;        
-  MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
-
-  if ((target == TT_CLOSED) || (target == TT_MAXIMAL)) {
-    t = clock();               
-    MSG(stderr, "filtering for %s item sets ... ",
-        (target == TT_MAXIMAL) ? "maximal" : "closed");
-    k = target | ((prune < 0) ? IST_EVAL : 0);
-    ist_mark(istree, k);        
-    MSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
-  }      
-
-  t = clock();                  
   if (fn_out && *fn_out)        
-    out = fopen(fn_out, "w");  
+    out = fopen(fn_out, "w");   
   else {                        
-    out = stdout; fn_out = "<stdout>"; }    
-  MSG(stderr, "writing %s ... ", fn_out);
+    out = stdout; fn_out = "<stdout>"; }
   if (!out) error(E_FOPEN, fn_out);
   if (eval == IST_LOGQ) report |= ISR_LOGS;
   if ((target == TT_CLOSED) || (target == TT_MAXIMAL))
-    report |= ISR_CLOSED;      
+    report |= ISR_CLOSED;       
   isrep = isr_create(ibase, out, report, isep, impl);
-  if (!isrep) error(E_NOMEM);  
+  if (!isrep) error(E_NOMEM);   
   isr_setfmt (isrep, format);   
   isr_setsize(isrep,  min, max);
-  ist_setsize(istree, min, max, dir);
-  ist_init   (istree);          
-  items = t_items(ib_tract(ibase));
-  if ((target <= TT_MAXIMAL)    
-  &&  (dir == 0)) {            
-    if      (eval == IST_LOGQ)  
-      isr_seteval(isrep, isr_logq,  NULL,   minval);
-    else if (eval >  IST_NONE)  
-      isr_seteval(isrep, ist_evalx, istree, minval);
-    n = ist_report(istree, isrep); } 
-  else if (target <= TT_MAXIMAL) { 
-    for (n = 0; 1; ) {         
-      k = ist_set(istree, items, &frq, &minval);
-      if (k < 0) break;         
-      if (k > 0) fputs(isr_name(isrep, items[0]), out);
-      for (i = 0; ++i < k; ) {  
-        fputs(isep, out); fputs(isr_name(isrep, items[i]), out); }
-      if (format)               
-        isr_sinfo(isrep, frq, minval);
-      fputc('\n', out); n++;    
-    } }                       
-  else if (target == TT_RULE) { 
-    for (n = 0; 1; ) {          
-      k = ist_rule(istree, items, &frq, &body, &head, &minval);
-      if (k < 0) break;         
-      fputs(isr_name(isrep, items[0]), out);
-      fputs(impl, out);         
-      if (k > 1) fputs(isr_name(isrep, items[1]), out);
-      for (i = 1; ++i < k; ) {  
-        fputs(isep, out); fputs(isr_name(isrep, items[i]), out); }
-      if (format)               
-        isr_rinfo(isrep, frq, body, head, minval);
-      fputc('\n', out); n++;    
-    }                           
-  }  /
+  if (fn_tid) {                 
+    ftid = (*fn_tid) ? fopen(fn_tid, "w") : stdout;
+    if (!ftid) error(E_FOPEN, fn_tid);
+    isr_setftid(isrep, ftid);   
+  }
+
+  m = n; cnt = 0;               
+  if ((batch > 0) && (batch < m) && tabag) {
+    whole = tabag; tabag = NULL; }
+  if (algo == 'f') {            
+    t = clock();                
+    if (eval == IST_LOGQ)       
+      isr_seteval(isrep, isr_logq, NULL, minval);
+    MSG(stderr, "mining with FP-growth and writing %s ... ", fn_out);
+    k   = (target == TT_CLOSED)  ? FPG_CLOSED
+        : (target == TT_MAXIMAL) ? FPG_MAXIMAL : FPG_FREQUENT;
+    cnt = fpg_mine(tatree, (SUPP)supp, k, isrep);
+    if (cnt < 0) error(E_NOMEM);
+    MSG(stderr, "[%d set(s)] done [%.2fs].\n", cnt, SEC_SINCE(t));
+    m = 0;                      
+  }
+  else if ((algo == 'e') || (algo == 'd') || (algo == 'r')
+  ||       (algo == 'g')) {
+    t = clock();                
+    if (eval == IST_LOGQ)       
+      isr_seteval(isrep, isr_logq, NULL, minval);
+    MSG(stderr, "mining with %s and writing %s ... ",
+        (algo == 'g') ? "GenMax"
+      : (algo == 'd') ? "dEclat" : "Eclat", fn_out);
+    k   = (algo == 'g') ? ECL_MAXIMAL
+        : (algo == 'r') ? ECL_ROARING
+        : (algo == 'd') ? ECL_DIFFSET : ECL_BITSET;
+    cnt = ecl_mine(tabag, (SUPP)supp, k, isrep);
+    if (cnt < 0) error(E_NOMEM);
+    MSG(stderr, "[%d set(s)] done [%.2fs].\n", cnt, SEC_SINCE(t));
+    m = 0;                      
+  }
+  else if (algo == 'l') {       
+    t = clock();                
+    if (eval == IST_LOGQ)       
+      isr_seteval(isrep, isr_logq, NULL, minval);
+    MSG(stderr, "mining with LCM and writing %s ... ", fn_out);
+    cnt = lcm_mine(tabag, (SUPP)supp, isrep);
+    if (cnt < 0) error(E_NOMEM);
+    MSG(stderr, "[%d set(s)] done [%.2fs].\n", cnt, SEC_SINCE(t));
+    m = 0;                      
+  }
+  else if (winsz > 0) {
+    t = clock();
+    MSG(stderr, "mining windows of %d transaction(s) and writing %s ... ",
+        winsz, fn_out);
+    cnt = slide(winsz, step, (SUPP)supp, (SUPP)smax, min, max, mode,
+                thcnt, &k);
+    MSG(stderr, "[%d set(s), %d rebuild(s)] done [%.2fs].\n",
+        cnt, k, SEC_SINCE(t));
+    m = 0;
+  }
+  for (lo = 0; lo < m; lo = hi) {
+    hi = ((batch > 0) && (batch < m-lo)) ? lo+batch : m;
+    if (istree) { ist_delete(istree); istree = NULL; }
+    t = clock(); tc = 0;         
+    if (whole) {
+      if (tatree) { tt_delete(tatree, 0); tatree = NULL; }
+      if (tabag)  { tb_delete(tabag,  0); tabag  = NULL; }
+      if ((project(lo, hi, heap) > 0) && tree) {
+        tatree = tt_create(tabag);
+        if (!tatree) error(E_NOMEM);
+      }
+    }
+    istree = ist_create(ibase, mode, (SUPP)supp, (SUPP)smax, conf);
+    if (!istree) error(E_NOMEM);  
+    ist_seteval(istree, eval, aggm, minval, prune);
+    ist_setthcnt(istree, thcnt);  
+    ist_setroot(istree, lo, hi);  
+    ist_setmaxmem(istree, (size_t)((maxmem > 0) ? maxmem *1048576.0 : 0));
+    raised = 0; capped = 0;       
+    if (ist_topk(istree, topk, min) != 0) error(E_NOMEM);
+    if (dhp > 0) {                
+      if (ist_dhp(istree, dhp) != 0) error(E_NOMEM);
+      if      (tatree) ist_countx(istree, tatree);
+      else if (tabag)  ist_countb(istree, tabag, 0);
+      else             rescan(fn_in, m, 0);
+    }                             
+
+    /* --- check item subsets --- */
+    if (hi-lo < m) MSG(stderr, "[items %d-%d] ", lo, hi-1);
+    if (whole)     MSG(stderr, "[%d transaction(s)] ", tb_cnt(tabag));
+    MSG(stderr, "checking subsets of size 1");
+    map = (int*)malloc(m *sizeof(int));
+    if (!map) error(E_NOMEM);     
+    frq = ist_raise(istree);      
+    for (smx = 0, i = 0; i < m; i++)
+      if (ib_getfrq(ibase, i) > smx) smx = ib_getfrq(ibase, i);
+    while (1) {                   
+      size = ist_height(istree);  
+      if (size >= max) break;     
+      if ((filter != 0)        
+      &&  (ist_check(istree, map) <= size))
+        break;                  
+      if (post)                  
+        ist_prune(istree);       
+      low = raised;
+      k = ist_addlvl(istree);     
+      while (k == 2) {            
+        frq = ist_getsupp(istree);
+        if (frq < smx) {          
+          frq += frq/2 +1;        
+          ist_setsupp(istree, (frq < smx) ? frq : smx);
+          MSG(stderr, " [support " SUPP_FMT "]", ist_getsupp(istree));
+          k = ist_addlvl(istree); 
+          if (k != 1) { raised = ist_getsupp(istree); continue; }
+        }                         
+        ist_setsupp(istree, (low > 0) ? low : (SUPP)supp);
+        raised = low; capped = size; k = 1;
+        MSG(stderr, " [size capped at %d]", size);
+      }                           
+      if (k) { if (k > 0) break;
+               error(E_NOMEM);  } 
+      if (((filter < 0)           
+      &&   (i < -filter *n))      
+      ||  ((filter > 0)          
+      &&   (i < n) && (i *(double)tt < filter *n *tc))) {
+        n = i;                   
+        x = clock();             
+        tb_filter(tabag, size+1, map);
+        tb_sort(tabag, 0, heap);  
+        tb_reduce(tabag);         
+        if (tatree) {             
+          tt_delete(tatree, 0);   
+          tatree = tt_create(tabag);
+          if (!tatree) error(E_NOMEM);
+        }                         
+        tt = clock() -x;          
+      }
+      MSG(stderr, " %d", ++size); 
+      if ((spec > 0) && (size < max)) {
+        k = ist_addspec(istree, spec);
+        if (k < 0) error(E_NOMEM);
+        if (k == 0) MSG(stderr, " %d", ++size);
+      }                           
+      x = clock();             
+      if      (cands)  ist_cands (istree, cands);
+      else if (delta)  update(fupsupp, fupmax, trim);
+      else if (tatree) ist_countx(istree, tatree);
+      else if (tabag)  ist_countb(istree, tabag, trim);
+      else             rescan(fn_in, m, 0);
+      tc = clock() -x;           
+      ist_commit(istree);         
+      frq = ist_raise(istree);    
+      if ((algo == 'h') && (size < max) && vertical(size, tc)) {
+        MSG(stderr, " [switching to Eclat]");
+        vert = size; break;     
+      }
+    }                             
+    free(map); map = NULL;        
+    if (fn_fup) {
+      x = clock();
+      MSG(stderr, " [writing %s ... ", fn_fup);
+      k = fupsave(fn_fup, fuprec,
+                  (SUPP)((mode & APP_HEAD) ? supp : ceil(supp *conf)), umax,
+                  hash);
+      MSG(stderr, "%d set(s)] [%.2fs]", k, SEC_SINCE(x));
+    }
+    if (cands && tabag) {         
+      ist_clear(istree);          
+      for (i = tb_cnt(tabag); --i >= 0; ) {
+        tract = tb_tract(tabag, i);
+        ist_countall(istree, t_items(tract), t_size(tract), t_wgt(tract));
+      } }                         
+    else if (cands)               
+      rescan(fn_in, m, 1);        
+    if (cands && ((k = ist_border(istree)) > 0)) {
+      MSG(stderr, " [%d missed set(s)] failed [%.2fs].\n", k, SEC_SINCE(t));
+      tb_delete(cands, 0); cands = NULL;
+      hi = lo; continue;          
+    }                             
+    if (topk > 0) MSG(stderr, " [support " SUPP_FMT "]", frq);
+    MSG(stderr, " done [%.2fs].\n", SEC_SINCE(t));
+
+    if ((target == TT_CLOSED) || (target == TT_MAXIMAL)) {
+      t = clock();               
+      MSG(stderr, "filtering for %s item sets ... ",
+          (target == TT_MAXIMAL) ? "maximal" : "closed");
+      k = target | ((prune < 0) ? IST_EVAL : 0);
+      ist_mark(istree, k);        
+      MSG(stderr, "done [%.2fs].\n", SEC_SINCE(t));
+    }      
+
+    t = clock();                  
+    if ((raised > 0) || (capped > 0)) {
+      fprintf(out, "# memory budget of %g MB: ", maxmem);
+      if (raised > 0)
+        fprintf(out, "minimum support raised to " SUPP_FMT " (%.1f%%), ",
+                raised, 100.0 *(double)raised /(double)wgt);
+      fprintf(out, "at most %d item(s) per set%s\n", ist_height(istree),
+              (capped > 0) ? " (set size capped)" : "");
+    }
+    MSG(stderr, "writing %s ... ", fn_out);
+    ist_setsize(istree, min, max, dir);
+    ist_init   (istree);          
+    items = t_items(ib_tract(ibase));
+    if ((target <= TT_MAXIMAL)    
+    &&  (dir == 0)) {            
+      if      (eval == IST_LOGQ)  
+        isr_seteval(isrep, isr_logq,  NULL,   minval);
+      else if (eval >  IST_NONE)  
+        isr_seteval(isrep, ist_evalx, istree, minval);
+      if (vert > 0) isr_setsize(isrep, min, vert-1);
+      n = ist_report(istree, isrep);
+      if (vert > 0) {           
+        isr_setsize(isrep, min, max);
+        k = finish(vert, (SUPP)supp);
+        if (k < 0) error(E_NOMEM);
+        n += k;                 
+      } }                       
+    else if (target <= TT_MAXIMAL) { 
+      for (n = 0; 1; ) {         
+        k = ist_set(istree, items, &frq, &minval);
+        if (k < 0) break;         
+        if (k > 0) fputs(isr_name(isrep, items[0]), out);
+        for (i = 0; ++i < k; ) {  
+          fputs(isep, out); fputs(isr_name(isrep, items[i]), out); }
+        if (format)               
+          isr_sinfo(isrep, frq, minval);
+        fputc('\n', out); n++;    
+      } }                       
+    else if (target == TT_RULE) { 
+      for (n = 0; 1; ) {          
+        k = ist_rule(istree, items, &frq, &body, &head, &minval);
+        if (k < 0) break;         
+        fputs(isr_name(isrep, items[0]), out);
+        fputs(impl, out);         
+        if (k > 1) fputs(isr_name(isrep, items[1]), out);
+        for (i = 1; ++i < k; ) {  
+          fputs(isep, out); fputs(isr_name(isrep, items[i]), out); }
+        if (format)               
+          isr_rinfo(isrep, frq, body, head, minval);
+        fputc('\n', out); n++;    
+      }                           
+    }
+    cnt += n;                     
+    MSG(stderr, "[%d %s(s)] done ", n,
+                (target == TT_RULE) ? "rule" : "set");
+    MSG(stderr, "[%.2fs].\n", SEC_SINCE(t));
+  }                             
   if (fflush(out) != 0) error(E_FWRITE, fn_out);
   if (out != stdout) fclose(out);
   out = NULL;                   
-  MSG(stderr, "[%d %s(s)] done ", n,
-              (target == TT_RULE) ? "rule" : "set");
-  MSG(stderr, "[%.2fs].\n", SEC_SINCE(t));
+  if (ftid) {                   
+    if (fflush(ftid) != 0) error(E_FWRITE, fn_tid);
+    if (ftid != stdout) fclose(ftid);
+    ftid = NULL;                
+  }
+  if (batch > 0) MSG(stderr, "[%d set(s) in total]\n", cnt);
   #ifdef BENCH
-  printf("number of created nodes    : %d\n", istree->ndcnt);
-  printf("number of pruned  nodes    : %d\n", istree->ndprn);
-  printf("number of item map elements: %d\n", istree->mapsz);
-  printf("number of support counters : %d\n", istree->sccnt);
-  printf("necessary support counters : %d\n", istree->scnec);
-  printf("pruned    support counters : %d\n", istree->scprn);
-  printf("number of child pointers   : %d\n", istree->cpcnt);
-  printf("necessary child pointers   : %d\n", istree->cpnec);
-  printf("pruned    child pointers   : %d\n", istree->cpprn);
+  if (istree) {                 
+    printf("number of created nodes    : %d\n", istree->ndcnt);
+    printf("number of pruned  nodes    : %d\n", istree->ndprn);
+    printf("number of item map elements: %d\n", istree->mapsz);
+    printf("number of support counters : %d\n", istree->sccnt);
+    printf("necessary support counters : %d\n", istree->scnec);
+    printf("pruned    support counters : %d\n", istree->scprn);
+    printf("number of child pointers   : %d\n", istree->cpcnt);
+    printf("necessary child pointers   : %d\n", istree->cpnec);
+    printf("pruned    child pointers   : %d\n", istree->cpprn);
+    printf("DHP pruned support counters: %d (%.1f%%)\n", istree->dhprn,
+           100.0 *istree->dhprn /(istree->dhprn +istree->scnec));
+    printf("memory used by item set tree: %lu\n",
+           (unsigned long)istree->memsz);
+    printf("memory used by counters    : %lu\n",
+           (unsigned long)istree->cntsz);
+    printf("memory per support counter : %.1f\n",
+           (double)istree->memsz /istree->sccnt); }
   #endif
 
  
   #ifndef NDEBUG                
   isr_delete(isrep, 0);            
-  ist_delete(istree);              
+  if (istree) ist_delete(istree);  
   if (tatree) tt_delete(tatree, 0);
   if (tabag)  tb_delete(tabag, 0); 
+  if (whole)  tb_delete(whole, 0); 
+  if (cands)  tb_delete(cands, 0); 
+  if (delta)  tb_delete(delta, 0); 
+  if (state)  tb_delete(state, 0); 
   ib_delete(ibase);              
   #endif
   #ifdef STORAGE                
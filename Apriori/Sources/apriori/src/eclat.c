@@ -0,0 +1,924 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "eclat.h"
+#include "tidset.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+
+#define BLKBITS       32        /* number of bits in a bit block */
+#define DIFFTHR      0.5        /* density threshold for diffsets */
+#define TDSTHR     0.007        /* density threshold for bit sets */
+
+/* Eclat works on a vertical representation of the transactions: for */
+/* each item it stores the set of (indices of) transactions that     */
+/* contain it as a bit set. The support of an item set is obtained by */
+/* intersecting the bit sets of its items and summing the weights of */
+/* the transactions in the intersection. If all transactions have     */
+/* weight 1 (which is the common case), this sum is a population count */
+/* of the bit blocks, otherwise the weights of the set bits are added. */
+/* Alternatively the transaction sets are stored as sorted lists of    */
+/* transaction indices (tid lists). If the extensions of an item set   */
+/* are dense (contain, on average, more than DIFFTHR of the prefix's  */
+/* transactions), the lists are replaced by difference sets (diffsets, */
+/* the transactions of the prefix that do not contain the item), which */
+/* are then propagated: d(PXY) = d(PY) - d(PX), supp(PXY) = supp(PX)  */
+/* - wgt(d(PXY)) (M.J. Zaki and K. Gouda, "Fast Vertical Mining Using */
+/* Diffsets", 2003). Dense data thus yields short lists at all depths. */
+/* Finally, the transaction sets may be stored as compressed tid sets */
+/* (see tidset.c), which combine arrays, bitmaps and runs, so that    */
+/* rare items do not need a full bit set on sparse data and frequent  */
+/* items are still intersected word by word. In this representation  */
+/* the transaction ids of the item sets can also be written. They are */
+/* also used instead of bit sets if the data is too sparse (density  */
+/* below TDSTHR), because then most bit blocks are empty, but still   */
+/* have to be stored and intersected.                                 */
+/* Maximal item sets are mined with tid lists/diffsets in the way of  */
+/* GenMax (K. Gouda and M.J. Zaki, "GenMax: An Efficient Algorithm  */
+/* for Mining Maximal Frequent Itemsets", 2005): the extensions of a  */
+/* set (its tail) are sorted by increasing support, and before a node */
+/* is expanded, the union of the set and its tail is checked against */
+/* the maximal sets found so far that contain the set (local maximal */
+/* sets, progressive focusing) and, with a lookahead intersection of  */
+/* all tail lists, for being frequent itself (as in MaxMiner). If it */
+/* is contained in a known maximal set or frequent, the subtree is   */
+/* skipped, so that long patterns do not require all their subsets. */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef unsigned int BITBLK;    /* a block of bits (32 transactions) */
+
+typedef struct {                /* --- item with transaction set --- */
+  int      item;                /* item identifier (item base code) */
+  SUPP     supp;                /* support of the item (set) */
+  BITBLK   *bits;               /* bit set of containing transactions */
+  int      cnt;                 /* number of transaction indices */
+  int      *tids;               /* transaction indices (or diffset) */
+  TIDSET   *set;                /* compressed tid set */
+} ECITEM;                       /* (item with transaction set) */
+
+struct _eclat {                 /* --- Eclat miner --- */
+  SUPP     supp;                /* minimum support of an item set */
+  ISREPORT *rep;                /* item set reporter */
+  int      blkcnt;              /* number of blocks per bit set */
+  SUPP     *wgts;               /* transaction weights (NULL: all 1) */
+  int      *buf;                /* buffer for a tid list */
+  unsigned int *work;           /* work buffer for tid sets */
+  int      cnt;                 /* number of items (ecl_create()) */
+  TIDSET   **sets;              /* tid sets of the items */
+  int      *aux;                /* second buffer for a tid list */
+  int      *marks;              /* item markers for subset tests */
+  int      stamp;               /* current item marker value */
+  int      mcnt;                /* number of maximal item sets */
+  int      mmax;                /* size of the offset array */
+  int      *moffs;              /* offsets of the maximal item sets */
+  int      msize;               /* size of the item array */
+  int      *mitems;             /* items of the maximal item sets */
+  int      lsize;               /* size of the local set stack */
+  int      *lmfi;               /* stack of local maximal set indices */
+};                              /* (Eclat miner) */
+
+/*----------------------------------------------------------------------
+  Bit Set Functions
+----------------------------------------------------------------------*/
+
+static SUPP _isect (ECLAT *ecl, BITBLK *dst,
+                    const BITBLK *a, const BITBLK *b)
+{                               /* --- intersect two bit sets */
+  int        i;                 /* loop variable */
+  BITBLK     x;                 /* intersection of two blocks */
+  SUPP       s = 0;             /* support of the intersection */
+  const SUPP *w;                /* to traverse the trans. weights */
+
+  assert(ecl && dst && a && b); /* check the function arguments */
+  if (!ecl->wgts) {             /* if all transactions have weight 1, */
+    for (i = ecl->blkcnt; --i >= 0; ) {   /* count the set bits */
+      dst[i] = x = a[i] & b[i]; s += tds_popcnt(x); }
+    return s;                   /* intersect the blocks and */
+  }                             /* return the number of set bits */
+  for (i = ecl->blkcnt; --i >= 0; ) {
+    dst[i] = x = a[i] & b[i];   /* intersect the blocks and */
+    for (w = ecl->wgts +i *BLKBITS; x; x >>= 1, w++)
+      if (x & 1) s += *w;       /* sum the weights of the */
+  }                             /* transactions in the intersection */
+  return s;                     /* return the weight of the trans. */
+}  /* _isect() */
+
+/*----------------------------------------------------------------------
+  Tid List Functions
+----------------------------------------------------------------------*/
+
+static SUPP _wgt (ECLAT *ecl, const int *tids, int n)
+{                               /* --- sum transaction weights */
+  SUPP s = 0;                   /* sum of the transaction weights */
+
+  assert(ecl && (tids || (n <= 0)));   /* check the arguments */
+  if (!ecl->wgts) return (SUPP)n;   /* if all weights are 1, */
+  while (--n >= 0)              /* the weight is the list length, */
+    s += ecl->wgts[*tids++];    /* otherwise sum the weights */
+  return s;                     /* return the sum of the weights */
+}  /* _wgt() */
+
+/*--------------------------------------------------------------------*/
+
+static int _inter (int *dst, const int *a, int na, const int *b, int nb)
+{                               /* --- intersect two tid lists */
+  int       *d = dst;           /* to traverse the destination */
+  const int *ea = a +na;        /* end of the first  list */
+  const int *eb = b +nb;        /* end of the second list */
+
+  assert(dst && a && b);        /* check the function arguments */
+  while ((a < ea) && (b < eb)) {/* while both lists are not empty */
+    if      (*a < *b) a++;      /* skip indices that are */
+    else if (*a > *b) b++;      /* only in one of the lists */
+    else { *d++ = *a++; b++; }  /* copy indices in both lists */
+  }
+  return (int)(d -dst);         /* return the size of the result */
+}  /* _inter() */
+
+/*--------------------------------------------------------------------*/
+
+static int _minus (int *dst, const int *a, int na, const int *b, int nb)
+{                               /* --- subtract two tid lists */
+  int       *d = dst;           /* to traverse the destination */
+  const int *ea = a +na;        /* end of the first  list */
+  const int *eb = b +nb;        /* end of the second list */
+
+  assert(dst && a && b);        /* check the function arguments */
+  while (a < ea) {              /* traverse the first list */
+    if      ((b >= eb) || (*a < *b)) *d++ = *a++;
+    else if (*a > *b) b++;      /* copy indices not in second list, */
+    else { a++; b++; }          /* skip indices only in second list */
+  }                             /* and indices in both lists */
+  return (int)(d -dst);         /* return the size of the result */
+}  /* _minus() */
+
+/*--------------------------------------------------------------------*/
+
+static int _union (int *dst, const int *a, int na, const int *b, int nb)
+{                               /* --- unite two tid lists */
+  int       *d = dst;           /* to traverse the destination */
+  const int *ea = a +na;        /* end of the first  list */
+  const int *eb = b +nb;        /* end of the second list */
+
+  assert(dst && a && b);        /* check the function arguments */
+  while ((a < ea) && (b < eb)) {/* while both lists are not empty */
+    if      (*a < *b) *d++ = *a++;
+    else if (*a > *b) *d++ = *b++;
+    else { *d++ = *a++; b++; }  /* copy the smaller index or */
+  }                             /* an index that is in both lists */
+  while (a < ea) *d++ = *a++;   /* copy the rest of the lists */
+  while (b < eb) *d++ = *b++;
+  return (int)(d -dst);         /* return the size of the result */
+}  /* _union() */
+
+/*----------------------------------------------------------------------
+  Eclat Functions
+----------------------------------------------------------------------*/
+
+static int _bitrec (ECLAT *ecl, ECITEM *list, int n)
+{                               /* --- find frequent item sets */
+  int    i, k, m, r = 0;        /* loop variables, number of sets */
+  SUPP   s;                     /* support of an item set */
+  ECITEM *proj;                 /* projected items (extensions) */
+  BITBLK *bits;                 /* to traverse the bit sets */
+
+  assert(ecl && list && (n > 0));  /* check the function arguments */
+  proj = (ECITEM*)malloc((size_t)n *sizeof(ECITEM)
+                       + (size_t)n *(size_t)ecl->blkcnt *sizeof(BITBLK));
+  if (!proj) return -1;         /* allocate the projected items */
+  for (i = n; --i >= 0; ) {     /* traverse the items backwards */
+    isr_add(ecl->rep, list[i].item, list[i].supp);
+    m = 0; bits = (BITBLK*)(proj +n);
+    if (isr_xable(ecl->rep)) {  /* if the set can be extended */
+      for (k = 0; k < i; k++) { /* traverse the preceding items */
+        s = _isect(ecl, bits, list[i].bits, list[k].bits);
+        if      (s >= list[i].supp)         /* collect the perfect */
+          isr_addpex(ecl->rep, list[k].item);   /* extensions */
+        else if (s >= ecl->supp) {          /* and the other */
+          proj[m].item = list[k].item;      /* frequent extensions */
+          proj[m].supp = s;
+          proj[m].bits = bits; bits += ecl->blkcnt; m++;
+        }                       /* (the bit set of an infrequent */
+      }                         /* item is overwritten by the next) */
+    }
+    r += isr_report(ecl->rep);  /* report the current item set */
+    k  = (m > 0) ? _bitrec(ecl, proj, m) : 0;
+    isr_remove(ecl->rep, 1);    /* find frequent item sets recursively */
+    if (k < 0) { free(proj); return -1; }
+    r += k;                     /* remove the current item and */
+  }                             /* sum the number of reported sets */
+  free(proj);                   /* delete the projected items */
+  return r;                     /* return number of reported sets */
+}  /* _bitrec() */
+
+/*--------------------------------------------------------------------*/
+
+static int _bitmine (ECLAT *ecl, TABAG *bag)
+{                               /* --- mine with bit sets */
+  int    i, k, m, n, r;         /* loop variables, number of sets */
+  int    *p;                    /* to traverse the items */
+  SUPP   wgt;                   /* total weight of the transactions */
+  TRACT  *t;                    /* to traverse the transactions */
+  ECITEM *list;                 /* items with transaction bit sets */
+  BITBLK *bits;                 /* to traverse the bit sets */
+
+  n    = ib_cnt(tb_base(bag));  /* get the number of items */
+  list = (ECITEM*)malloc((size_t)n *sizeof(ECITEM)
+                       + (size_t)n *(size_t)ecl->blkcnt *sizeof(BITBLK));
+  if (!list) return -1;         /* allocate the item bit sets */
+  bits = (BITBLK*)(list +n);    /* and clear them */
+  memset(bits, 0, (size_t)n *(size_t)ecl->blkcnt *sizeof(BITBLK));
+  for (i = 0; i < n; i++) {     /* initialize the items */
+    list[i].item = i; list[i].supp = 0;
+    list[i].bits = bits +i *ecl->blkcnt;
+  }
+  for (wgt = 0, i = 0; i < tb_cnt(bag); i++) {
+    t = tb_tract(bag, i);       /* traverse the transactions */
+    wgt += t_wgt(t);            /* sum the transaction weights */
+    for (p = t_items(t), k = t_size(t); --k >= 0; p++) {
+      list[*p].supp += t_wgt(t);/* set the transaction bits */
+      list[*p].bits[i /BLKBITS] |= (BITBLK)1 << (i % BLKBITS);
+    }                           /* for all items in the transaction */
+  }                             /* and sum the item supports */
+  for (m = i = 0; i < n; i++) { /* traverse the items */
+    if      (list[i].supp >= wgt)         /* collect the perfect */
+      isr_addpex(ecl->rep, i);  /* extensions and the frequent items */
+    else if (list[i].supp >= ecl->supp) list[m++] = list[i];
+  }
+  r = 0;                        /* report the empty set and */
+  if (wgt >= ecl->supp) {       /* find frequent item sets */
+    r = isr_report(ecl->rep);   /* recursively */
+    if ((m > 0) && isr_xable(ecl->rep)) {
+      k = _bitrec(ecl, list, m); r = (k < 0) ? -1 : r+k; }
+  }
+  free(list);                   /* delete the item bit sets */
+  return r;                     /* return number of reported sets */
+}  /* _bitmine() */
+
+/*--------------------------------------------------------------------*/
+
+static int _tidrec (ECLAT *ecl, ECITEM *list, int n, int diff)
+{                               /* --- find frequent item sets */
+  int    i, k, m, c, r = 0;     /* loop variables, number of sets */
+  int    sub;                   /* whether extensions are diffsets */
+  double z;                     /* total size of the extension lists */
+  SUPP   s;                     /* support of an item set */
+  ECITEM *proj;                 /* projected items (extensions) */
+  int    *tids;                 /* transaction index list */
+
+  assert(ecl && list && (n > 0));  /* check the function arguments */
+  proj = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!proj) return -1;         /* allocate the projected items */
+  for (i = n; --i >= 0; ) {     /* traverse the items backwards */
+    isr_add(ecl->rep, list[i].item, list[i].supp);
+    m = 0; sub = diff; z = 0;   /* init. the extension counters */
+    for (k = 0; (k < i) && isr_xable(ecl->rep); k++) {
+      if (diff) {               /* if diffsets are processed */
+        c = _minus(ecl->buf, list[k].tids, list[k].cnt,
+                             list[i].tids, list[i].cnt);
+        s = list[i].supp -_wgt(ecl, ecl->buf, c); }
+      else {                    /* if tid lists are processed */
+        c = _inter(ecl->buf, list[i].tids, list[i].cnt,
+                             list[k].tids, list[k].cnt);
+        s = _wgt(ecl, ecl->buf, c);
+      }                         /* compute the extension's support */
+      if      (s >= list[i].supp)           /* collect the perfect */
+        isr_addpex(ecl->rep, list[k].item); /* extensions */
+      else if (s >= ecl->supp) {            /* and the other */
+        tids = (int*)malloc((size_t)(c+1) *sizeof(int));
+        if (!tids) { m = -m-1; break; }
+        memcpy(tids, ecl->buf, (size_t)c *sizeof(int));
+        proj[m].item = list[k].item; proj[m].supp = s;
+        proj[m].cnt  = c;            proj[m].tids = tids;
+        m++; z += c;            /* store the frequent extension */
+      }                         /* and sum the list sizes */
+    }
+    if (!diff && (m > 0)        /* if the extensions are dense, */
+    &&  (z >= DIFFTHR *m *(double)list[i].cnt)) {
+      for (sub = 1, k = 0; k < m; k++) {    /* switch to diffsets */
+        c = _minus(ecl->buf, list[i].tids, list[i].cnt,
+                             proj[k].tids, proj[k].cnt);
+        tids = (int*)malloc((size_t)(c+1) *sizeof(int));
+        if (!tids) { m = -m-1; break; }
+        memcpy(tids, ecl->buf, (size_t)c *sizeof(int));
+        free(proj[k].tids);     /* replace the tid list t(PX) */
+        proj[k].tids = tids; proj[k].cnt = c;
+      }                         /* by the diffset d(PX) = t(P)-t(PX) */
+    }
+    k = 0;                      /* default: no sets found */
+    if (m >= 0) {               /* if no memory error occurred */
+      r += isr_report(ecl->rep);/* report the current item set */
+      k  = (m > 0) ? _tidrec(ecl, proj, m, sub) : 0;
+    }                           /* find frequent item sets recursively */
+    else { m = -m-1; k = -1; }  /* get the number of extensions */
+    while (--m >= 0) free(proj[m].tids);
+    isr_remove(ecl->rep, 1);    /* delete the transaction lists */
+    if (k < 0) { free(proj); return -1; }
+    r += k;                     /* remove the current item and */
+  }                             /* sum the number of reported sets */
+  free(proj);                   /* delete the projected items */
+  return r;                     /* return number of reported sets */
+}  /* _tidrec() */
+
+/*--------------------------------------------------------------------*/
+
+static int* _collect (TABAG *bag, ECITEM *list, int n, SUPP *wgt)
+{                               /* --- collect the item tid lists */
+  int   i, k, m;                /* loop variables, number of tids */
+  int   *p, *tids;              /* to traverse the items and lists */
+  TRACT *t;                     /* to traverse the transactions */
+
+  for (i = 0; i < n; i++) {     /* initialize the items */
+    list[i].item = i; list[i].supp = 0; list[i].cnt = 0; }
+  for (m = 0, *wgt = 0, i = 0; i < tb_cnt(bag); i++) {
+    t = tb_tract(bag, i);       /* traverse the transactions */
+    *wgt += t_wgt(t);           /* sum the transaction weights */
+    for (p = t_items(t), k = t_size(t); --k >= 0; p++) {
+      list[*p].supp += t_wgt(t); list[*p].cnt++; m++; }
+  }                             /* count the item occurrences */
+  tids = (int*)malloc((size_t)(m+1) *sizeof(int));
+  if (!tids) return NULL;       /* allocate the tid list memory */
+  for (p = tids, i = 0; i < n; i++) {
+    list[i].tids = p; p += list[i].cnt; list[i].cnt = 0; }
+  for (i = 0; i < tb_cnt(bag); i++) {
+    t = tb_tract(bag, i);       /* organize the tid list memory */
+    for (p = t_items(t), k = t_size(t); --k >= 0; p++)
+      list[*p].tids[list[*p].cnt++] = i;
+  }                             /* collect the transaction indices */
+  return tids;                  /* return the tid list memory */
+}  /* _collect() */
+
+/*--------------------------------------------------------------------*/
+
+static int _tidmine (ECLAT *ecl, TABAG *bag)
+{                               /* --- mine with tid lists/diffsets */
+  int    i, k, m, n, c, r;      /* loop variables, number of sets */
+  int    *p, *q, *tids, *d;     /* to traverse the items and lists */
+  int    diff;                  /* whether to start with diffsets */
+  double z;                     /* total size of the item lists */
+  SUPP   wgt;                   /* total weight of the transactions */
+  ECITEM *list;                 /* items with transaction lists */
+
+  n    = ib_cnt(tb_base(bag));  /* get the number of items */
+  list = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!list) return -1;         /* allocate the item array */
+  tids = _collect(bag, list, n, &wgt);
+  if (!tids) { free(list); return -1; }
+  for (z = 0, m = i = 0; i < n; i++) {
+    if      (list[i].supp >= wgt)         /* collect the perfect */
+      isr_addpex(ecl->rep, i);  /* extensions and the frequent items */
+    else if (list[i].supp >= ecl->supp) {
+      z += list[i].cnt; list[m++] = list[i]; }
+  }                             /* sum the list sizes */
+  diff = (m > 0) && (z >= DIFFTHR *m *(double)tb_cnt(bag));
+  d    = NULL;                  /* if the items are dense, */
+  if (diff) {                   /* switch to diffsets */
+    d = (int*)malloc(((size_t)m *(size_t)tb_cnt(bag) -(size_t)z +1)
+                     *sizeof(int));
+    if (!d) { free(tids); free(list); return -1; }
+    for (p = d, i = 0; i < m; i++) {
+      for (q = p, c = k = 0; k < tb_cnt(bag); k++) {
+        if ((c < list[i].cnt) && (list[i].tids[c] == k)) c++;
+        else *p++ = k;          /* collect the transactions that */
+      }                         /* do not contain the item */
+      list[i].tids = q; list[i].cnt = (int)(p -q);
+    }
+  }
+  r = 0;                        /* report the empty set and */
+  if (wgt >= ecl->supp) {       /* find frequent item sets */
+    r = isr_report(ecl->rep);   /* recursively */
+    if ((m > 0) && isr_xable(ecl->rep)) {
+      k = _tidrec(ecl, list, m, diff); r = (k < 0) ? -1 : r+k; }
+  }
+  if (d) free(d);               /* delete the diffsets, */
+  free(tids); free(list);       /* the tid lists and the items */
+  return r;                     /* return number of reported sets */
+}  /* _tidmine() */
+
+/*--------------------------------------------------------------------*/
+
+static int _report (ECLAT *ecl, const TIDSET *set)
+{                               /* --- report the current item set */
+  if (!isr_getftid(ecl->rep))   /* if no transaction ids are needed, */
+    return isr_report(ecl->rep);/* simply report the item set */
+  return isr_reportx(ecl->rep, ecl->buf, tds_tids(set, ecl->buf));
+}  /* _report() */              /* report with transaction ids */
+
+/*--------------------------------------------------------------------*/
+
+static int _tsrec (ECLAT *ecl, ECITEM *list, int n)
+{                               /* --- find frequent item sets */
+  int    i, k, m, r = 0;        /* loop variables, number of sets */
+  SUPP   s;                     /* support of an item set */
+  ECITEM *proj;                 /* projected items (extensions) */
+  TIDSET *set;                  /* tid set of an extension */
+
+  assert(ecl && list && (n > 0));  /* check the function arguments */
+  proj = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!proj) return -1;         /* allocate the projected items */
+  for (i = n; --i >= 0; ) {     /* traverse the items backwards */
+    isr_add(ecl->rep, list[i].item, list[i].supp);
+    for (m = k = 0; (k < i) && isr_xable(ecl->rep); k++) {
+      set = NULL;               /* traverse the preceding items */
+      if (ecl->wgts) {          /* if the transactions are weighted, */
+        set = tds_inter(list[i].set, list[k].set, ecl->work);
+        if (!set) { m = -m-1; break; }  /* intersect the tid sets */
+        s = tds_wgt(set, ecl->wgts); }   /* and sum the weights */
+      else                      /* otherwise only count the tids */
+        s = (SUPP)tds_intercnt(list[i].set, list[k].set);
+      if      (s >= list[i].supp)           /* collect the perfect */
+        isr_addpex(ecl->rep, list[k].item); /* extensions */
+      else if (s >= ecl->supp) {            /* and the other */
+        if (!set) set = tds_inter(list[i].set, list[k].set, ecl->work);
+        if (!set) { m = -m-1; break; }      /* frequent extensions */
+        proj[m].item = list[k].item; proj[m].supp = s;
+        proj[m].set  = set; m++; set = NULL;
+      }                         /* store the extension's tid set */
+      if (set) tds_delete(set); /* and delete all other tid sets */
+    }
+    k = 0;                      /* default: no sets found */
+    if (m >= 0) {               /* if no memory error occurred */
+      r += _report(ecl, list[i].set);
+      k  = (m > 0) ? _tsrec(ecl, proj, m) : 0;
+    }                           /* find frequent item sets recursively */
+    else { m = -m-1; k = -1; }  /* get the number of extensions */
+    while (--m >= 0) tds_delete(proj[m].set);
+    isr_remove(ecl->rep, 1);    /* delete the tid sets */
+    if (k < 0) { free(proj); return -1; }
+    r += k;                     /* remove the current item and */
+  }                             /* sum the number of reported sets */
+  free(proj);                   /* delete the projected items */
+  return r;                     /* return number of reported sets */
+}  /* _tsrec() */
+
+/*--------------------------------------------------------------------*/
+
+static int _tsmine (ECLAT *ecl, TABAG *bag)
+{                               /* --- mine with compressed tid sets */
+  int    i, k, m, n, r;         /* loop variables, number of sets */
+  int    *tids;                 /* tid lists of the items */
+  SUPP   wgt;                   /* total weight of the transactions */
+  ECITEM *list;                 /* items with tid sets */
+
+  n    = ib_cnt(tb_base(bag));  /* get the number of items */
+  list = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!list) return -1;         /* allocate the item array */
+  tids = _collect(bag, list, n, &wgt);
+  if (!tids) { free(list); return -1; }
+  for (m = i = 0; i < n; i++) { /* traverse the items */
+    if      (list[i].supp >= wgt)         /* collect the perfect */
+      isr_addpex(ecl->rep, i);  /* extensions and the frequent items */
+    else if (list[i].supp >= ecl->supp) {
+      list[m] = list[i];        /* compress the tid list */
+      list[m].set = tds_create(list[i].tids, list[i].cnt);
+      if (!list[m++].set) { m--; break; }
+    }
+  }
+  free(tids);                   /* delete the tid lists */
+  r = -1;                       /* default: memory error */
+  if (i >= n) {                 /* if all tid sets were created */
+    r = 0;                      /* report the empty set and */
+    if (wgt >= ecl->supp) {     /* find frequent item sets */
+      if (isr_getftid(ecl->rep)) {   /* recursively */
+        for (i = 0; i < tb_cnt(bag); i++) ecl->buf[i] = i;
+        r = isr_reportx(ecl->rep, ecl->buf, tb_cnt(bag)); }
+      else r = isr_report(ecl->rep);
+      if ((m > 0) && isr_xable(ecl->rep)) {
+        k = _tsrec(ecl, list, m); r = (k < 0) ? -1 : r+k; }
+    }
+  }
+  while (--m >= 0) tds_delete(list[m].set);
+  free(list);                   /* delete the tid sets and the items */
+  return r;                     /* return number of reported sets */
+}  /* _tsmine() */
+
+/*----------------------------------------------------------------------
+  GenMax Functions
+----------------------------------------------------------------------*/
+
+static void _sort (ECITEM *list, int n)
+{                               /* --- sort items by support */
+  int    i, k;                  /* loop variables */
+  ECITEM t;                     /* exchange buffer */
+
+  assert(list);                 /* check the function argument */
+  for (i = 1; i < n; i++) {     /* insertion sort (the extensions */
+    t = list[i];                /* are almost sorted already) */
+    for (k = i; (k > 0) && (list[k-1].supp > t.supp); k--)
+      list[k] = list[k-1];      /* shift items with higher support */
+    list[k] = t;                /* and store the item to insert */
+  }                             /* in the place thus found */
+}  /* _sort() */
+
+/*--------------------------------------------------------------------*/
+
+static int _store (ECLAT *ecl)
+{                               /* --- store a maximal item set */
+  int i, n;                     /* loop variable, number of items */
+  int *p;                       /* to reallocate the arrays */
+
+  assert(ecl);                  /* check the function argument */
+  n = isr_cnt(ecl->rep);        /* get the size of the item set */
+  if (ecl->mcnt+1 >= ecl->mmax) {
+    i = ecl->mmax +((ecl->mmax > 1024) ? ecl->mmax >> 1 : 1024);
+    p = (int*)realloc(ecl->moffs, (size_t)i *sizeof(int));
+    if (!p) return -1;          /* enlarge the offset array */
+    ecl->moffs = p; ecl->mmax = i;
+  }
+  if (ecl->moffs[ecl->mcnt] +n > ecl->msize) {
+    i = ecl->msize +((ecl->msize > 4096) ? ecl->msize >> 1 : 4096);
+    if (i < ecl->moffs[ecl->mcnt] +n) i = ecl->moffs[ecl->mcnt] +n;
+    p = (int*)realloc(ecl->mitems, (size_t)i *sizeof(int));
+    if (!p) return -1;          /* enlarge the item array */
+    ecl->mitems = p; ecl->msize = i;
+  }
+  p = ecl->mitems +ecl->moffs[ecl->mcnt];
+  for (i = 0; i < n; i++)       /* copy the items of the set */
+    p[i] = isr_itemx(ecl->rep, i);
+  ecl->moffs[ecl->mcnt+1] = ecl->moffs[ecl->mcnt] +n;
+  return ecl->mcnt++;           /* return the index of the set */
+}  /* _store() */
+
+/*--------------------------------------------------------------------*/
+
+static int _push (ECLAT *ecl, int pos, int set)
+{                               /* --- push a local maximal set */
+  int i;                        /* new size of the stack */
+  int *p;                       /* reallocated stack */
+
+  assert(ecl && (pos >= 0));    /* check the function arguments */
+  if (pos >= ecl->lsize) {      /* if the stack is full */
+    i = ecl->lsize +((ecl->lsize > 1024) ? ecl->lsize >> 1 : 1024);
+    if (i <= pos) i = pos+1;    /* compute the new stack size */
+    p = (int*)realloc(ecl->lmfi, (size_t)i *sizeof(int));
+    if (!p) return -1;          /* enlarge the stack */
+    ecl->lmfi = p; ecl->lsize = i;
+  }
+  ecl->lmfi[pos] = set;         /* store the index of the set */
+  return 0;                     /* return 'ok' */
+}  /* _push() */
+
+/*--------------------------------------------------------------------*/
+
+static int _subsumed (ECLAT *ecl, const ECITEM *list, int n,
+                      int b, int k)
+{                               /* --- check for a maximal superset */
+  int       i, m;               /* loop variables */
+  const int *p, *e;             /* to traverse the items of a set */
+
+  assert(ecl && list);          /* check the function arguments */
+  if (++ecl->stamp <= 0) {      /* on overflow of the marker value */
+    for (i = ib_cnt(isr_base(ecl->rep)); --i >= 0; )
+      ecl->marks[i] = 0;        /* clear the item markers */
+    ecl->stamp = 1;             /* and restart with marker 1 */
+  }
+  for (i = 0; i < n; i++)       /* mark the items of the tail */
+    ecl->marks[list[i].item] = ecl->stamp;
+  for (k += b; b < k; b++) {    /* traverse the local maximal sets */
+    p = ecl->mitems +ecl->moffs[ecl->lmfi[b]];
+    e = ecl->mitems +ecl->moffs[ecl->lmfi[b]+1];
+    if (e -p < n) continue;     /* skip sets that are too small */
+    for (m = 0; p < e; p++)     /* count the marked items */
+      if (ecl->marks[*p] == ecl->stamp) m++;
+    if (m >= n) return -1;      /* if all tail items are contained, */
+  }                             /* the set is subsumed */
+  return 0;                     /* return 'not subsumed' */
+}  /* _subsumed() */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP _hut (ECLAT *ecl, const ECITEM *list, int n, int diff,
+                  SUPP supp)
+{                               /* --- support of head union tail */
+  int  i, c;                    /* loop variable, list size */
+  int  *a, *b, *t;              /* tid list buffers */
+  SUPP s;                       /* support of the union */
+
+  assert(ecl && list && (n > 1));  /* check the function arguments */
+  a = ecl->buf; b = ecl->aux;   /* get the two tid list buffers */
+  c = list[0].cnt;              /* start with the first tail list */
+  memcpy(a, list[0].tids, (size_t)c *sizeof(int));
+  for (i = 1; i < n; i++) {     /* traverse the other tail lists */
+    if (diff) {                 /* if diffsets are processed, */
+      c = _union(b, a, c, list[i].tids, list[i].cnt);
+      s = supp -_wgt(ecl, b, c);/* unite the diffsets */
+    }                           /* (the union is missing) */
+    else {                      /* if tid lists are processed, */
+      c = _inter(b, a, c, list[i].tids, list[i].cnt);
+      s = _wgt(ecl, b, c);      /* intersect the tid lists */
+    }
+    if (s < ecl->supp) return -1;  /* abort if the union is not */
+    t = a; a = b; b = t;        /* frequent and exchange the buffers */
+  }
+  return s;                     /* return the support of the union */
+}  /* _hut() */
+
+/*--------------------------------------------------------------------*/
+
+static int _maxrec (ECLAT *ecl, ECITEM *list, int n, int diff,
+                    SUPP supp, int b, int k)
+{                               /* --- find maximal item sets */
+  int    i, j, m, c, g, x;      /* loop variables, buffers */
+  int    r = 0;                 /* number of reported item sets */
+  int    sub;                   /* whether extensions are diffsets */
+  double z;                     /* total size of the extension lists */
+  SUPP   s;                     /* support of an item set */
+  ECITEM *proj;                 /* projected items (extensions) */
+  int    *tids;                 /* transaction index list */
+
+  assert(ecl && list && (n > 0));  /* check the function arguments */
+  if ((n > 1) && !_subsumed(ecl, list, n, b, k)
+  &&  ((s = _hut(ecl, list, n, diff, supp)) >= ecl->supp)) {
+    for (i = 0; i < n; i++)     /* if head union tail is frequent, */
+      isr_add(ecl->rep, list[i].item, s);     /* it is maximal */
+    r = isr_report(ecl->rep);   /* report head union tail */
+    g = _store(ecl);            /* and store it as a maximal set */
+    isr_remove(ecl->rep, n);    /* (lookahead, the whole subtree */
+    if ((g < 0) || (_push(ecl, b+k, g) < 0)) return -1;
+    return r;                   /* can be skipped) */
+  }
+  proj = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!proj) return -1;         /* allocate the projected items */
+  for (i = 0; i < n; i++) {     /* traverse the items (tail) */
+    if (_subsumed(ecl, list+i, n-i, b, k))
+      break;                    /* skip subsumed head union tails */
+    isr_add(ecl->rep, list[i].item, list[i].supp);
+    m = 0; sub = diff; z = 0;   /* init. the extension counters */
+    for (j = i+1; j < n; j++) { /* traverse the following items */
+      if (diff) {               /* if diffsets are processed */
+        c = _minus(ecl->buf, list[j].tids, list[j].cnt,
+                             list[i].tids, list[i].cnt);
+        s = list[i].supp -_wgt(ecl, ecl->buf, c); }
+      else {                    /* if tid lists are processed */
+        c = _inter(ecl->buf, list[i].tids, list[i].cnt,
+                             list[j].tids, list[j].cnt);
+        s = _wgt(ecl, ecl->buf, c);
+      }                         /* compute the extension's support */
+      if (s < ecl->supp) continue;
+      tids = (int*)malloc((size_t)(c+1) *sizeof(int));
+      if (!tids) { m = -m-1; break; }
+      memcpy(tids, ecl->buf, (size_t)c *sizeof(int));
+      proj[m].item = list[j].item; proj[m].supp = s;
+      proj[m].cnt  = c;            proj[m].tids = tids;
+      m++; z += c;              /* store the frequent extension */
+    }                           /* and sum the list sizes */
+    if (!diff && (m > 0)        /* if the extensions are dense, */
+    &&  (z >= DIFFTHR *m *(double)list[i].cnt)) {
+      for (sub = 1, j = 0; j < m; j++) {    /* switch to diffsets */
+        c = _minus(ecl->buf, list[i].tids, list[i].cnt,
+                             proj[j].tids, proj[j].cnt);
+        tids = (int*)malloc((size_t)(c+1) *sizeof(int));
+        if (!tids) { m = -m-1; break; }
+        memcpy(tids, ecl->buf, (size_t)c *sizeof(int));
+        free(proj[j].tids);     /* replace the tid list t(PX) */
+        proj[j].tids = tids; proj[j].cnt = c;
+      }                         /* by the diffset d(PX) = t(P)-t(PX) */
+    }
+    x = 0;                      /* default: no error */
+    if (m < 0) { m = -m-1; x = -1; }
+    else if (m > 0) {           /* if there are extensions, */
+      _sort(proj, m);           /* sort them by support */
+      for (c = j = 0; (j < k) && (x >= 0); j++) {
+        g = ecl->lmfi[b+j];     /* collect the local maximal sets */
+        for (tids = ecl->mitems +ecl->moffs[g];    /* that contain */
+             tids < ecl->mitems +ecl->moffs[g+1]; tids++)
+          if (*tids == list[i].item) {   /* the current item */
+            x = _push(ecl, b+k+c++, g); break; }
+      }                         /* (progressive focusing) */
+      g = ecl->mcnt;            /* note the number of maximal sets */
+      if (x >= 0) x = _maxrec(ecl, proj, m, sub, list[i].supp, b+k, c);
+      if (x >= 0) r += x;       /* find maximal sets recursively */
+      for ( ; (g < ecl->mcnt) && (x >= 0); g++)
+        x = _push(ecl, b+k++, g);
+    }                           /* add the new sets to the local ones */
+    else if (!_subsumed(ecl, list+i, 1, b, k)) {
+      r += isr_report(ecl->rep);/* if the set cannot be extended */
+      g = _store(ecl);          /* and is not subsumed, report it */
+      x = (g < 0) ? -1 : _push(ecl, b+k++, g);
+    }                           /* and store it as a maximal set */
+    while (--m >= 0) free(proj[m].tids);
+    isr_remove(ecl->rep, 1);    /* delete the transaction lists */
+    if (x < 0) { free(proj); return -1; }
+  }                             /* and remove the current item */
+  free(proj);                   /* delete the projected items */
+  return r;                     /* return number of reported sets */
+}  /* _maxrec() */
+
+/*--------------------------------------------------------------------*/
+
+static int _maxmine (ECLAT *ecl, TABAG *bag)
+{                               /* --- mine maximal item sets */
+  int    i, m, n, r;            /* loop variables, number of sets */
+  int    *tids;                 /* tid lists of the items */
+  SUPP   wgt;                   /* total weight of the transactions */
+  ECITEM *list;                 /* items with transaction lists */
+
+  n    = ib_cnt(tb_base(bag));  /* get the number of items */
+  list = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  if (!list) return -1;         /* allocate the item array */
+  tids = _collect(bag, list, n, &wgt);
+  if (!tids) { free(list); return -1; }
+  for (m = i = 0; i < n; i++) { /* traverse the items */
+    if      (list[i].supp >= wgt)         /* collect the perfect */
+      isr_addpex(ecl->rep, i);  /* extensions and the frequent items */
+    else if (list[i].supp >= ecl->supp)
+      list[m++] = list[i];      /* (perfect extensions are contained */
+  }                             /* in all maximal item sets) */
+  _sort(list, m);               /* sort the items by support */
+  r = 0;                        /* find maximal item sets recursively */
+  if (wgt >= ecl->supp)         /* (the empty set is maximal if */
+    r = (m > 0) ? _maxrec(ecl, list, m, 0, wgt, 0, 0)
+                : isr_report(ecl->rep);    /* there is no frequent */
+  free(tids); free(list);       /* item) and delete the tid lists */
+  return r;                     /* return number of reported sets */
+}  /* _maxmine() */
+
+/*--------------------------------------------------------------------*/
+
+static int _setup (ECLAT *ecl, TABAG *bag, SUPP supp, int mode,
+                   ISREPORT *rep)
+{                               /* --- set up an Eclat miner */
+  int i;                        /* loop variable */
+
+  ecl->supp   = (supp > 0) ? supp : 1;
+  ecl->rep    = rep;            /* initialize the miner */
+  ecl->blkcnt = (tb_cnt(bag) +BLKBITS-1) /BLKBITS;
+  ecl->wgts   = NULL;           /* compute the bit set size */
+  ecl->buf    = NULL;           /* and clear the buffers */
+  ecl->work   = NULL;
+  ecl->cnt    = 0;
+  ecl->sets   = NULL;
+  ecl->aux    = ecl->marks  = NULL;
+  ecl->moffs  = ecl->mitems = ecl->lmfi = NULL;
+  ecl->stamp  = ecl->mcnt   = 0;
+  ecl->mmax   = ecl->msize  = ecl->lsize = 0;
+  for (i = tb_cnt(bag); --i >= 0; )
+    if (t_wgt(tb_tract(bag, i)) != 1) break;
+  if (i >= 0) {                 /* if there are weighted transactions */
+    ecl->wgts = (SUPP*)calloc((size_t)ecl->blkcnt *BLKBITS, sizeof(SUPP));
+    if (!ecl->wgts) return -1;  /* allocate an array of weights */
+    for (i = tb_cnt(bag); --i >= 0; )
+      ecl->wgts[i] = t_wgt(tb_tract(bag, i));
+  }                             /* collect the transaction weights */
+  if (mode == ECL_BITSET) return 0;
+  ecl->buf = (int*)malloc((size_t)(tb_cnt(bag)+1) *sizeof(int));
+  if (!ecl->buf) return -1;     /* for tid lists get a buffer */
+  if (mode == ECL_DIFFSET) return 0;
+  if (mode == ECL_MAXIMAL) {    /* for maximal item sets */
+    ecl->aux   = (int*)malloc((size_t)(tb_cnt(bag)+1) *sizeof(int));
+    ecl->marks = (int*)calloc((size_t)ib_cnt(tb_base(bag))+1,
+                              sizeof(int));
+    ecl->moffs = (int*)calloc(1, sizeof(int));
+    ecl->mmax  = 1;             /* get a second buffer, item markers */
+    return (ecl->aux && ecl->marks && ecl->moffs) ? 0 : -1;
+  }                             /* and an initial offset array */
+  ecl->work = (unsigned int*)malloc(TDS_WORKSIZE *sizeof(unsigned int));
+  return (ecl->work) ? 0 : -1;  /* for tid sets get a work buffer */
+}  /* _setup() */
+
+/*--------------------------------------------------------------------*/
+
+static void _clean (ECLAT *ecl)
+{                               /* --- clean up an Eclat miner */
+  int i;                        /* loop variable */
+
+  if (ecl->sets) {              /* if there are item tid sets, */
+    for (i = ecl->cnt; --i >= 0; )   /* delete them */
+      if (ecl->sets[i]) tds_delete(ecl->sets[i]);
+    free(ecl->sets);            /* and the tid set array */
+  }
+  if (ecl->lmfi)   free(ecl->lmfi);
+  if (ecl->mitems) free(ecl->mitems);
+  if (ecl->moffs)  free(ecl->moffs);
+  if (ecl->marks)  free(ecl->marks);
+  if (ecl->aux)    free(ecl->aux);
+  if (ecl->work) free(ecl->work);
+  if (ecl->buf)  free(ecl->buf);
+  if (ecl->wgts) free(ecl->wgts);
+}  /* _clean() */               /* delete the work arrays */
+
+/*--------------------------------------------------------------------*/
+
+static double _density (TABAG *bag)
+{                               /* --- compute density of transactions */
+  int    i;                     /* loop variable */
+  double occ = 0;               /* number of item occurrences */
+
+  assert(bag);                  /* check the function argument */
+  if ((tb_cnt(bag) <= 0) || (ib_cnt(tb_base(bag)) <= 0))
+    return 1;                   /* check for an empty bag */
+  for (i = tb_cnt(bag); --i >= 0; )
+    occ += t_size(tb_tract(bag, i));
+  return occ /((double)tb_cnt(bag) *(double)ib_cnt(tb_base(bag)));
+}  /* _density() */              /* (fraction of set item bits) */
+
+/*--------------------------------------------------------------------*/
+
+int ecl_mine (TABAG *bag, SUPP supp, int mode, ISREPORT *rep)
+{                               /* --- mine with Eclat */
+  int   r;                      /* number of reported sets */
+  ECLAT ecl;                    /* Eclat miner */
+
+  assert(bag && rep);           /* check the function arguments */
+  if ((mode == ECL_BITSET)      /* if the data is too sparse */
+  &&  (_density(bag) < TDSTHR)) /* for transaction bit sets, */
+    mode = ECL_ROARING;         /* use compressed tid sets instead */
+  if (_setup(&ecl, bag, supp, mode, rep) != 0) {
+    _clean(&ecl); return -1; }  /* set up the miner */
+  if      (mode == ECL_MAXIMAL) r = _maxmine(&ecl, bag);
+  else if (mode == ECL_ROARING) r = _tsmine (&ecl, bag);
+  else if (mode == ECL_DIFFSET) r = _tidmine(&ecl, bag);
+  else                          r = _bitmine(&ecl, bag);
+  _clean(&ecl);                 /* mine frequent item sets */
+  return r;                     /* return number of reported sets */
+}  /* ecl_mine() */
+
+/*--------------------------------------------------------------------*/
+
+ECLAT* ecl_create (TABAG *bag, SUPP supp, ISREPORT *rep)
+{                               /* --- create an Eclat miner */
+  int    i, n;                  /* loop variable, number of items */
+  int    *tids;                 /* tid lists of the items */
+  SUPP   wgt;                   /* total weight of the transactions */
+  ECITEM *list;                 /* items with tid lists */
+  ECLAT  *ecl;                  /* created Eclat miner */
+
+  assert(bag && rep);           /* check the function arguments */
+  ecl = (ECLAT*)malloc(sizeof(ECLAT));
+  if (!ecl) return NULL;        /* create the miner */
+  if (_setup(ecl, bag, supp, ECL_ROARING, rep) != 0) {
+    ecl_delete(ecl); return NULL; }
+  n = ib_cnt(tb_base(bag));     /* get the number of items */
+  ecl->sets = (TIDSET**)calloc((size_t)n+1, sizeof(TIDSET*));
+  list      = (ECITEM*)malloc((size_t)n *sizeof(ECITEM));
+  tids      = (ecl->sets && list) ? _collect(bag, list, n, &wgt) : NULL;
+  if (tids) {                   /* if the tid lists were collected */
+    for (ecl->cnt = n, i = 0; i < n; i++)
+      if (!(ecl->sets[i] = tds_create(list[i].tids, list[i].cnt)))
+        break;                  /* compress the tid lists */
+    free(tids);                 /* and delete the uncompressed ones */
+  }
+  if (list) free(list);         /* delete the item array */
+  if (!tids || (i < n)) { ecl_delete(ecl); return NULL; }
+  return ecl;                   /* return the created miner */
+}  /* ecl_create() */
+
+/*--------------------------------------------------------------------*/
+
+void ecl_delete (ECLAT *ecl)
+{                               /* --- delete an Eclat miner */
+  assert(ecl);                  /* check the function argument */
+  _clean(ecl);                  /* delete the tid sets and buffers */
+  free(ecl);                    /* and the miner itself */
+}  /* ecl_delete() */
+
+/*--------------------------------------------------------------------*/
+
+int ecl_class (ECLAT *ecl, const int *pfx, int n,
+               const int *exts, const SUPP *supps, int m)
+{                               /* --- mine an equivalence class */
+  int    i, r;                  /* loop variable, number of sets */
+  TIDSET *set, *p;              /* tid set of the prefix */
+  ECITEM *list;                 /* extensions of the prefix */
+
+  assert(ecl && ecl->sets       /* check the function arguments */
+  &&     pfx && (n > 0) && exts && supps && (m > 0));
+  set = ecl->sets[pfx[0]];      /* intersect the tid sets */
+  for (i = 1; (i < n) && set; i++) {  /* of the prefix items */
+    p = tds_inter(set, ecl->sets[pfx[i]], ecl->work);
+    if (i > 1) tds_delete(set); /* delete an intermediate result */
+    set = p;                    /* and continue with the new one */
+  }
+  if (!set) return -1;          /* check for a memory error */
+  list = (ECITEM*)malloc((size_t)m *sizeof(ECITEM));
+  for (i = 0; list && (i < m); i++) {
+    list[i].item = exts[i]; list[i].supp = supps[i];
+    list[i].set  = tds_inter(set, ecl->sets[exts[i]], ecl->work);
+    if (!list[i].set) break;    /* collect the extensions */
+  }                             /* with their tid sets */
+  if (n > 1) tds_delete(set);   /* delete the prefix tid set */
+  if (!list) return -1;         /* check for a memory error */
+  r = (i < m) ? -1 : _tsrec(ecl, list, m);
+  while (--i >= 0) tds_delete(list[i].set);
+  free(list);                   /* find frequent item sets */
+  return r;                     /* recursively and clean up */
+}  /* ecl_class() */
@@ -0,0 +1,41 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#ifndef __ECLAT__
+#define __ECLAT__
+#include "report.h"
+
+
+/* --- transaction set representations --- */
+#define ECL_BITSET     0        /* bit sets */
+#define ECL_DIFFSET    1        /* tid lists, switching to diffsets */
+#define ECL_ROARING    2        /* compressed tid sets (see tidset.h) */
+#define ECL_MAXIMAL    3        /* tid lists/diffsets, maximal sets */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct _eclat ECLAT;    /* Eclat miner (see eclat.c) */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern int    ecl_mine   (TABAG *bag, SUPP supp, int mode,
+                          ISREPORT *rep);
+extern ECLAT* ecl_create (TABAG *bag, SUPP supp, ISREPORT *rep);
+extern void   ecl_delete (ECLAT *ecl);
+extern int    ecl_class  (ECLAT *ecl, const int *pfx, int n,
+                          const int *exts, const SUPP *supps, int m);
+
+#endif
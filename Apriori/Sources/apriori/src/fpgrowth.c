@@ -0,0 +1,479 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "fpgrowth.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+
+#define BLKSIZE     4096        /* block size for repository nodes */
+#define HASHSIZE    1021        /* size of the support hash table */
+#define SIGCNT         4        /* number of words of a signature */
+#define SIGBIT(s,i)  ((s)[((i) >> 5) & (SIGCNT-1)] |= \
+                      (unsigned int)1 << ((i) & 31))
+
+/* A frequent pattern tree is a prefix tree of (projected) transactions */
+/* with the items in the order of their codes, so that the parent of a */
+/* node always refers to an item with a smaller code. The nodes of an  */
+/* item are linked through the head of the item, which also holds the  */
+/* item's support. The items of a tree are referred to by the indices  */
+/* of their heads, the heads hold the item base codes. All nodes of a  */
+/* tree are allocated in one array, whose size is computed beforehand. */
+/* The initial tree is created from the transaction tree (see TATREE), */
+/* which already has this structure, the conditional trees are created */
+/* from the prefix paths of the nodes of an item. Closed and maximal   */
+/* item sets are filtered with a repository of the sets found so far: */
+/* a set is reported only if the repository contains no superset (for */
+/* closed sets: with the same support), which suffices, because the    */
+/* sets are found in an order in which all supersets that do not have  */
+/* a perfect extension relation to a set precede it. The repository   */
+/* has one prefix tree per support value (found with a hash table),   */
+/* because a closed superset must have the same support, and each    */
+/* node holds a signature (a hashed bit set) of the items below it,   */
+/* so that a superset search can skip subtrees that lack an item.     */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct fpnode {         /* --- frequent pattern tree node --- */
+  int           item;           /* item (index of the item's head) */
+  SUPP          supp;           /* support (weight of transactions) */
+  struct fpnode *parent;        /* parent node (preceding item) */
+  struct fpnode *child;         /* first child node */
+  struct fpnode *sibling;       /* next sibling node (same parent) */
+  struct fpnode *succ;          /* next node with the same item */
+} FPNODE;                       /* (frequent pattern tree node) */
+
+typedef struct {                /* --- frequent pattern tree head --- */
+  int           item;           /* item identifier (item base code) */
+  SUPP          supp;           /* support of the item */
+  FPNODE        *list;          /* list of the nodes with the item */
+} FPHEAD;                       /* (frequent pattern tree head) */
+
+typedef struct {                /* --- frequent pattern tree --- */
+  int           cnt;            /* number of items (heads) */
+  FPHEAD        *heads;         /* header table (one head per item) */
+  int           ncnt;           /* number of used nodes */
+  FPNODE        *nodes;         /* node array (all nodes of the tree) */
+  FPNODE        root;           /* root node (empty item set) */
+} FPTREE;                       /* (frequent pattern tree) */
+
+typedef struct rpnode {         /* --- repository node --- */
+  int           item;           /* item identifier (item base code) */
+  SUPP          supp;           /* support of the sets in the tree */
+  struct rpnode *child;         /* first child node */
+  struct rpnode *sibling;       /* next sibling node (same parent) */
+  unsigned int  sig[SIGCNT];    /* signature of the items below */
+} RPNODE;                       /* (repository node) */
+
+typedef struct rpblock {        /* --- block of repository nodes --- */
+  struct rpblock *succ;         /* next block in the list */
+  RPNODE        nodes[BLKSIZE]; /* the nodes of the block */
+} RPBLOCK;                      /* (block of repository nodes) */
+
+typedef struct {                /* --- FP-growth miner --- */
+  SUPP          supp;           /* minimum support of an item set */
+  int           target;         /* target type (FPG_* constants) */
+  ISREPORT      *rep;           /* item set reporter */
+  int           *buf;           /* buffer for paths and item sets */
+  unsigned int  *sigs;          /* signatures of item set suffixes */
+  RPNODE        *repo[HASHSIZE];/* repository of closed/maximal sets */
+  RPBLOCK       *blks;          /* blocks of repository nodes */
+  int           used;           /* number of used nodes in first block */
+} FPGROW;                       /* (FP-growth miner) */
+
+/*----------------------------------------------------------------------
+  Frequent Pattern Tree Functions
+----------------------------------------------------------------------*/
+
+static FPTREE* _create (int cnt, int ncnt)
+{                               /* --- create a frequent pattern tree */
+  FPTREE *tree;                 /* created frequent pattern tree */
+
+  assert((cnt >= 0) && (ncnt >= 0));   /* check the arguments */
+  tree = (FPTREE*)malloc(sizeof(FPTREE) +(size_t)cnt *sizeof(FPHEAD));
+  if (!tree) return NULL;       /* allocate the tree body */
+  tree->nodes = (FPNODE*)malloc((size_t)(ncnt+1) *sizeof(FPNODE));
+  if (!tree->nodes) { free(tree); return NULL; }
+  tree->cnt   = cnt;            /* allocate the node array */
+  tree->heads = (FPHEAD*)(tree +1);
+  tree->ncnt  = 0;              /* initialize the fields */
+  tree->root.item   = -1;       /* and the root node */
+  tree->root.supp   = 0;
+  tree->root.parent = tree->root.child = NULL;
+  tree->root.sibling = tree->root.succ = NULL;
+  return tree;                  /* return the created tree */
+}  /* _create() */
+
+/*--------------------------------------------------------------------*/
+
+static void _delete (FPTREE *tree)
+{                               /* --- delete a frequent pattern tree */
+  assert(tree);                 /* check the function argument */
+  free(tree->nodes);            /* delete the node array */
+  free(tree);                   /* and the tree body */
+}  /* _delete() */
+
+/*--------------------------------------------------------------------*/
+
+static FPNODE* _insert (FPTREE *tree, FPNODE *parent, int item, SUPP wgt)
+{                               /* --- add a weight to a child */
+  FPNODE *node;                 /* to traverse the child nodes */
+
+  assert(tree && parent);       /* check the function arguments */
+  for (node = parent->child; node; node = node->sibling)
+    if (node->item == item) break;
+  if (!node) {                  /* if there is no child for the item, */
+    node = tree->nodes +tree->ncnt++;     /* create a new node */
+    node->item    = item;       /* and initialize its fields */
+    node->supp    = 0;
+    node->parent  = parent;
+    node->child   = NULL;
+    node->sibling = parent->child; parent->child = node;
+    node->succ    = tree->heads[item].list;
+    tree->heads[item].list = node;
+  }                             /* add the node to the item list */
+  node->supp += wgt;            /* add the transaction weight */
+  return node;                  /* return the child node */
+}  /* _insert() */
+
+/*--------------------------------------------------------------------*/
+
+static void _ttsupp (TTNODE *node, SUPP *frqs)
+{                               /* --- get the item supports */
+  int    i, n;                  /* loop variable, number of items */
+  int    *items;                /* items of the transaction tree node */
+  TTNODE *child;                /* child of the transaction tree node */
+
+  assert(node && frqs);         /* check the function arguments */
+  n = ttn_size(node); items = ttn_items(node);
+  if (n < 0) {                  /* if this is a leaf node, */
+    for (i = -n; --i >= 0; )    /* sum the weight for all items */
+      frqs[items[i]] += ttn_wgt(node);
+    return;                     /* in the transaction suffix */
+  }
+  for (i = n; --i >= 0; ) {     /* traverse the child nodes */
+    child = ttn_child(node, i); /* and sum their weights */
+    frqs[items[i]] += ttn_wgt(child);
+    _ttsupp(child, frqs);       /* recursively process */
+  }                             /* the child subtrees */
+}  /* _ttsupp() */
+
+/*--------------------------------------------------------------------*/
+
+static int _ttcnt (TTNODE *node, const int *map)
+{                               /* --- count the nodes to create */
+  int    i, n, k = 0;           /* loop variable, number of nodes */
+  int    *items;                /* items of the transaction tree node */
+
+  assert(node && map);          /* check the function arguments */
+  n = ttn_size(node); items = ttn_items(node);
+  if (n < 0) {                  /* if this is a leaf node, */
+    for (i = -n; --i >= 0; )    /* count the frequent items */
+      if (map[items[i]] >= 0) k++;
+    return k;                   /* in the transaction suffix */
+  }
+  for (i = n; --i >= 0; ) {     /* traverse the child nodes */
+    if (map[items[i]] >= 0) k++;
+    k += _ttcnt(ttn_child(node, i), map);
+  }                             /* count the frequent items */
+  return k;                     /* and return the number of nodes */
+}  /* _ttcnt() */               /* (upper bound for tree nodes) */
+
+/*--------------------------------------------------------------------*/
+
+static void _ttcopy (FPTREE *tree, FPNODE *parent,
+                     TTNODE *node, const int *map)
+{                               /* --- copy a transaction tree */
+  int    i, k, n;               /* loop variables, number of items */
+  int    *items;                /* items of the transaction tree node */
+  TTNODE *child;                /* child of the transaction tree node */
+
+  assert(tree && parent && node && map);  /* check the arguments */
+  n = ttn_size(node); items = ttn_items(node);
+  if (n < 0) {                  /* if this is a leaf node, */
+    for (i = 0; i < -n; i++)    /* add the frequent items */
+      if ((k = map[items[i]]) >= 0)  /* of the transaction suffix */
+        parent = _insert(tree, parent, k, ttn_wgt(node));
+    return;                     /* as a path below the parent */
+  }
+  for (i = 0; i < n; i++) {     /* traverse the child nodes */
+    child = ttn_child(node, i); /* and copy the subtrees */
+    k     = map[items[i]];      /* (skip infrequent items) */
+    _ttcopy(tree, (k < 0) ? parent
+                 : _insert(tree, parent, k, ttn_wgt(child)), child, map);
+  }
+}  /* _ttcopy() */
+
+/*----------------------------------------------------------------------
+  Repository Functions
+----------------------------------------------------------------------*/
+
+static int _items (FPGROW *fpg)
+{                               /* --- get the current item set */
+  int      i, k, n, x;          /* loop variables, item buffer */
+  ISREPORT *rep = fpg->rep;     /* item set reporter */
+  int      *set = fpg->buf;     /* buffer for the item set */
+  unsigned int *s;              /* to traverse the signatures */
+
+  for (n = 0; n < isr_cnt(rep); n++)
+    set[n] = isr_itemx(rep, n); /* collect the items */
+  for (i = isr_pexcnt(rep); --i >= 0; )
+    set[n++] = isr_pex(rep, i); /* and the perfect extensions */
+  for (i = 1; i < n; i++) {     /* sort the items descendingly */
+    x = set[k = i];             /* (insertion sort, because */
+    while ((k > 0) && (set[k-1] < x)) { set[k] = set[k-1]; k--; }
+    set[k] = x;                 /* item sets are usually small) */
+  }
+  s = fpg->sigs +n *SIGCNT;     /* compute the signatures */
+  for (k = SIGCNT; --k >= 0; ) s[k] = 0;
+  for (i = n; --i >= 0; ) {     /* of all suffixes of the set */
+    s -= SIGCNT;                /* (signature of the remaining */
+    for (k = SIGCNT; --k >= 0; ) s[k] = s[k+SIGCNT];
+    SIGBIT(s, set[i]);          /* items for a superset search) */
+  }
+  return n;                     /* return the number of items */
+}  /* _items() */
+
+/*--------------------------------------------------------------------*/
+
+static int _super (RPNODE *node, const int *items,
+                   const unsigned int *sigs, int n)
+{                               /* --- check for a superset */
+  int k;                        /* loop variable */
+
+  for ( ; node; node = node->sibling) {
+    if (n <= 0) return 1;       /* if all items found, abort */
+    if (node->item < *items)    /* if the next item cannot occur */
+      continue;                 /* below this node, skip the node */
+    for (k = SIGCNT; --k >= 0; )/* if the signature shows that */
+      if (sigs[k] & ~node->sig[k]) break;    /* an item is missing */
+    if (k >= 0) continue;       /* below the node, skip the node */
+    if (node->item > *items) {  /* if the node has an additional item */
+      if (_super(node->child, items, sigs, n)) return 1; }
+    else if ((n <= 1) || _super(node->child, items+1, sigs+SIGCNT, n-1))
+      return 1;                 /* if the node has the next item, */
+  }                             /* match the remaining items */
+  return 0;                     /* return 'no superset found' */
+}  /* _super() */
+
+/*--------------------------------------------------------------------*/
+
+static RPNODE* _rpnode (FPGROW *fpg, RPNODE **p, int item, SUPP supp)
+{                               /* --- create a repository node */
+  int     k;                    /* loop variable */
+  RPNODE  *node;                /* created repository node */
+  RPBLOCK *blk;                 /* new block of repository nodes */
+
+  if (!fpg->blks || (fpg->used >= BLKSIZE)) {
+    blk = (RPBLOCK*)malloc(sizeof(RPBLOCK));
+    if (!blk) return NULL;      /* if the current block is full, */
+    blk->succ = fpg->blks;      /* get a new block of nodes */
+    fpg->blks = blk; fpg->used = 0;
+  }
+  node = fpg->blks->nodes +fpg->used++;
+  node->item    = item;         /* get the next node of the block */
+  node->supp    = supp;         /* and initialize its fields */
+  node->child   = NULL;
+  node->sibling = *p; *p = node;
+  for (k = SIGCNT; --k >= 0; ) node->sig[k] = 0;
+  return node;                  /* return the created node */
+}  /* _rpnode() */
+
+/*--------------------------------------------------------------------*/
+
+static RPNODE* _rphead (FPGROW *fpg, SUPP supp)
+{                               /* --- find the tree for a support */
+  RPNODE *head;                 /* to traverse the hash bucket */
+
+  for (head = fpg->repo[supp % HASHSIZE]; head; head = head->sibling)
+    if (head->supp == supp) return head;
+  return NULL;                  /* return the head of the tree */
+}  /* _rphead() */              /* (item -1, children are the sets) */
+
+/*--------------------------------------------------------------------*/
+
+static int _store (FPGROW *fpg, int n, SUPP supp)
+{                               /* --- store the current item set */
+  int     k;                    /* loop variable */
+  int     *set = fpg->buf;      /* item set to store (sorted) */
+  unsigned int *sigs = fpg->sigs;   /* signatures of the suffixes */
+  RPNODE  *par, *node;          /* to traverse the repository */
+
+  par = _rphead(fpg, supp);     /* get the tree for the support */
+  if (!par && !(par = _rpnode(fpg, fpg->repo +supp % HASHSIZE, -1, supp)))
+    return -1;                  /* create a tree if necessary */
+  for ( ; --n >= 0; set++, sigs += SIGCNT) {
+    for (node = par->child; node; node = node->sibling)
+      if (node->item == *set) break;
+    if (!node && !(node = _rpnode(fpg, &par->child, *set, supp)))
+      return -1;                /* find or create the item's node */
+    for (k = SIGCNT; --k >= 0; ) node->sig[k] |= sigs[k];
+    par = node;                 /* update the node's signature */
+  }                             /* and go to the next item */
+  return 0;                     /* return 'ok' */
+}  /* _store() */
+
+/*----------------------------------------------------------------------
+  FP-growth Functions
+----------------------------------------------------------------------*/
+
+static int _grow (FPGROW *fpg, FPTREE *tree);
+
+static int _node (FPGROW *fpg, FPTREE *tree, SUPP supp)
+{                               /* --- process the current item set */
+  int r = 0;                    /* number of reported item sets */
+  int n;                        /* number of items in the set */
+  int ext;                      /* whether the set can be extended */
+  RPNODE *head;                 /* repository tree for the support */
+
+  ext = (tree && (tree->cnt > 0) && isr_xable(fpg->rep));
+  if (fpg->target == FPG_FREQUENT)
+    r = isr_report(fpg->rep);   /* report all frequent item sets */
+  else {                        /* if closed/maximal item sets */
+    n = _items(fpg);            /* get the current item set */
+    if (fpg->target == FPG_MAXIMAL) supp = fpg->supp;
+    if ((n >= isr_max(fpg->rep))/* sets of maximal size are closed */
+    ||  (((fpg->target == FPG_CLOSED) || !ext)     /* and maximal, */
+    &&   (!(head = _rphead(fpg, supp))           /* otherwise */
+    ||    !_super(head->child, fpg->buf, fpg->sigs, n)))) {
+      r = isr_report(fpg->rep); /* check for a superset in the repo. */
+      if (_store(fpg, n, supp) < 0) return -1;
+    }                           /* report a closed/maximal item set */
+  }                             /* and store it in the repository */
+  if (ext) {                    /* if the set can be extended, */
+    n = _grow(fpg, tree);       /* find frequent item sets recursively */
+    if (n < 0) return -1;       /* in the conditional tree */
+    r += n;                     /* sum the number of reported sets */
+  }
+  return r;                     /* return number of reported sets */
+}  /* _node() */
+
+/*--------------------------------------------------------------------*/
+
+static int _grow (FPGROW *fpg, FPTREE *tree)
+{                               /* --- find frequent item sets */
+  int    i, k, m, n, r = 0;     /* loop variables, number of sets */
+  SUPP   *cnts;                 /* supports in the conditional tree */
+  int    *map;                  /* map to conditional tree items */
+  int    *path;                 /* buffer for a prefix path */
+  FPHEAD *h;                    /* head of the current item */
+  FPNODE *node, *p;             /* to traverse the nodes */
+  FPTREE *cond;                 /* conditional frequent pattern tree */
+
+  assert(fpg && tree);          /* check the function arguments */
+  cnts = (SUPP*)malloc((size_t)tree->cnt *(sizeof(SUPP)+sizeof(int)));
+  if (!cnts) return -1;         /* allocate support and map arrays */
+  map  = (int*)(cnts +tree->cnt);
+  path = fpg->buf;              /* get the buffer for prefix paths */
+  for (i = tree->cnt; --i >= 0; ) {
+    h = tree->heads +i;         /* traverse the items backwards */
+    isr_add(fpg->rep, h->item, h->supp);
+    for (k = i; --k >= 0; ) cnts[k] = 0;
+    for (n = 0, node = h->list; node; node = node->succ)
+      for (p = node->parent; p->item >= 0; p = p->parent) {
+        cnts[p->item] += node->supp; n++; }
+    for (m = k = 0; k < i; k++){/* sum the supports in prefix paths */
+      map[k] = -1;              /* and traverse the preceding items */
+      if      (cnts[k] >= h->supp)        /* collect the perfect */
+        isr_addpex(fpg->rep, tree->heads[k].item);  /* extensions */
+      else if (cnts[k] >= fpg->supp)      /* and number the other */
+        map[k] = m++;           /* frequent items (conditional tree) */
+    }
+    cond = NULL;                /* if the set can be extended, */
+    if ((m > 0) && isr_xable(fpg->rep)) {    /* create a cond. tree */
+      cond = _create(m, n);     /* (summed prefix path lengths */
+      if (!cond) { free(cnts); return -1; }   /* bound the nodes) */
+      for (k = 0; k < i; k++) { /* traverse the conditional items */
+        if (map[k] < 0) continue;
+        cond->heads[map[k]].item = tree->heads[k].item;
+        cond->heads[map[k]].supp = cnts[k];
+        cond->heads[map[k]].list = NULL;
+      }                         /* initialize the item heads */
+      for (node = h->list; node; node = node->succ) {
+        for (n = 0, p = node->parent; p->item >= 0; p = p->parent)
+          if (map[p->item] >= 0) path[n++] = map[p->item];
+        for (p = &cond->root; --n >= 0; )
+          p = _insert(cond, p, path[n], node->supp);
+      }                         /* add the prefix paths of the nodes */
+    }                           /* to the conditional tree */
+    k = _node(fpg, cond, h->supp);
+    if (cond) _delete(cond);    /* process the current item set */
+    isr_remove(fpg->rep, 1);    /* and remove the current item */
+    if (k < 0) { free(cnts); return -1; }
+    r += k;                     /* sum the number of reported sets */
+  }
+  free(cnts);                   /* delete the work arrays */
+  return r;                     /* return number of reported sets */
+}  /* _grow() */
+
+/*--------------------------------------------------------------------*/
+
+int fpg_mine (TATREE *tree, SUPP supp, int target, ISREPORT *rep)
+{                               /* --- mine with FP-growth */
+  int     i, k, n, r;           /* loop variables, number of sets */
+  SUPP    wgt;                  /* total weight of the transactions */
+  SUPP    *frqs;                /* item supports in transaction tree */
+  int     *map;                 /* map to frequent pattern tree items */
+  FPTREE  *fpt;                 /* initial frequent pattern tree */
+  FPGROW  fpg;                  /* FP-growth miner */
+  RPBLOCK *blk;                 /* to delete the repository */
+
+  assert(tree && rep);          /* check the function arguments */
+  n    = ib_cnt(tt_base(tree)); /* get the number of items */
+  frqs = (SUPP*)malloc((size_t)(n+1) *(sizeof(SUPP)+2*sizeof(int)));
+  if (!frqs) return -1;         /* allocate the work arrays */
+  map  = (int*)(frqs +n+1);
+  for (i = n; --i >= 0; ) frqs[i] = 0;
+  _ttsupp(tt_root(tree), frqs); /* get the item supports */
+  wgt = ttn_wgt(tt_root(tree)); /* and the total weight */
+  if (supp <= 0) supp = 1;      /* check the minimum support */
+  for (k = i = 0; i < n; i++) { /* traverse the items */
+    map[i] = -1;                /* collect the perfect extensions */
+    if      (frqs[i] >= wgt)  isr_addpex(rep, i);
+    else if (frqs[i] >= supp) map[i] = k++;
+  }                             /* and number the frequent items */
+  fpt = _create(k, _ttcnt(tt_root(tree), map));
+  if (!fpt) { free(frqs); return -1; }
+  for (i = 0; i < n; i++) {     /* initialize the item heads */
+    if (map[i] < 0) continue;
+    fpt->heads[map[i]].item = i;
+    fpt->heads[map[i]].supp = frqs[i];
+    fpt->heads[map[i]].list = NULL;
+  }
+  _ttcopy(fpt, &fpt->root, tt_root(tree), map);
+  fpg.supp   = supp;            /* copy the transaction tree */
+  fpg.target = target;          /* and initialize the miner */
+  fpg.rep    = rep;
+  fpg.buf    = map +n+1;        /* (reuse the second work array) */
+  fpg.sigs   = NULL;            /* allocate a signature buffer */
+  if ((target != FPG_FREQUENT)  /* for closed/maximal item sets */
+  &&  !(fpg.sigs = (unsigned int*)malloc((size_t)(n+1)
+                                         *SIGCNT *sizeof(unsigned int)))) {
+    _delete(fpt); free(frqs); return -1; }
+  for (i = HASHSIZE; --i >= 0; ) fpg.repo[i] = NULL;
+  fpg.blks   = NULL; fpg.used = 0;
+  r = (wgt >= supp) ? _node(&fpg, fpt, wgt) : 0;
+  _delete(fpt);                 /* mine frequent item sets and */
+  while (fpg.blks) {            /* delete the tree and repository */
+    blk = fpg.blks; fpg.blks = blk->succ; free(blk); }
+  if (fpg.sigs) free(fpg.sigs); /* delete the signature buffer */
+  free(frqs);                   /* delete the work arrays */
+  return r;                     /* return number of reported sets */
+}  /* fpg_mine() */
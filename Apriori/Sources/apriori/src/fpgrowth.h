@@ -0,0 +1,31 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#ifndef __FPGROWTH__
+#define __FPGROWTH__
+#include "report.h"
+
+
+/* --- target types --- */
+#define FPG_FREQUENT   0        /* all frequent item sets */
+#define FPG_CLOSED     1        /* closed  item sets */
+#define FPG_MAXIMAL    2        /* maximal item sets */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern int fpg_mine (TATREE *tree, SUPP supp, int target,
+                     ISREPORT *rep);
+
+#endif
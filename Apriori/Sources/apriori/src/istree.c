@@ -18,8 +18,12 @@ Instrutor: Luiz Camolesi
 #include <float.h>
 #include <math.h>
 #include <assert.h>
+#ifdef IST_THREADS
+#include <pthread.h>
+#endif
 #include "istree.h"
 #include "chi2.h"
+#include "tidset.h"
 #ifdef STORAGE
 #include "storage.h"
 #endif
@@ -28,34 +32,89 @@ Instrutor: Luiz Camolesi
 #define LN_2        0.69314718055994530942  /* ln(2) */
 #define BLKSIZE     32          /* block size for level array */
 #define F_HDONLY    INT_MIN     /* flag for head only item in path */
+#define F_BITMAP    0x40000000  /* flag for bitmap indexed node */
 #define F_SKIP      INT_MIN     /* flag for subtree skipping */
-#define ID(n)       ((int)((n)->id & ~F_HDONLY))
+#define S_SKIP      SUPP_MIN    /* flag for item set skipping */
+#define ID(n)       ((int)((n)->id & ~(F_HDONLY|F_BITMAP)))
 #define HDONLY(n)   ((int)((n)->id &  F_HDONLY))
-#define COUNT(n)    ((n) & ~F_SKIP)
+#define BITMAP(n)   ((int)((n)->id &  F_BITMAP))
+#define COUNT(n)    ((n) & ~S_SKIP)
 #define CHCNT(n)    ((n)->chcnt & ~F_SKIP)
-
-#ifdef ARCH64                   /* if 64 bit architecture, */
-#define PAD(x)      ((x) & 1)   /* padding to an even number */
-#else                           /* if sizeof(int) == sizeof(void*), */
-#define PAD(x)      0           /* no padding is needed */
+#define MAP(l,n)    ((l)->map  -(n)->offset -1)
+#define CHN(l,n)    ((l)->chn  +(n)->chn)
+#define PARENT(l,n) ((l)[-1].nodes +(n)->parent)
+#define SPEC(t)     (((t)->height > 2) && (t)->lvls[(t)->height-2].spec)
+#define BM_SHIFT    5           /* shift for the word of a bit */
+#define BM_MASK     31          /* mask  for the bit  in a word */
+#define BM_BITS(b,j) ((b)[2+(j)+(j)])
+#define BM_RANK(b,j) ((b)[3+(j)+(j)])
+#define DHP_MAX     3           /* max. size of hashed item sets */
+#define DHPFOLD(h,i) (((h) +(unsigned int)(i)) *0x9e3779b1U)
+#ifndef IST_PAIRMEM             /* memory for a pair counter matrix */
+#define IST_PAIRMEM 0x1000000   /* (16 MB; see _pairinit()) */
+#endif
+#ifndef IST_THDMIN              /* min. number of nodes per thread */
+#define IST_THDMIN  256         /* when adding a level in parallel */
 #endif
 
-
-typedef double EVALFN (int supp, int body, int head, int n);
+/* The nodes of each level are stored in one array in traversal order */
+/* and refer to each other by indices: the parent index refers to the */
+/* node array of the preceding level, the child indices to the node   */
+/* array of the following level. The counters, identifier maps and   */
+/* child indices of all nodes of a level are stored in three separate */
+/* arrays, in which each node has a contiguous section. A negative    */
+/* offset indicates an identifier map, which is then located at index */
+/* -1-offset in the map array of the level (see macro MAP).           */
+/* If the node is flagged with F_BITMAP, this map array section holds */
+/* a bitmap over the item range instead: the first item, the number   */
+/* of words and for each word its bits and the number of bits set in  */
+/* the preceding words (rank), so that the counter index of an item   */
+/* is found with a single population count. The child index array   */
+/* of such a node has one element per counter (-1 if no child).      */
+/* The counters of a level have the smallest width (see CW_*) that    */
+/* can hold the largest support that may occur on the level, so that  */
+/* deep levels with many, but small counters need less memory. They   */
+/* are only accessed with the functions _getcnt, _setcnt and _inccnt, */
+/* which map the sign bit of the counter type to the flag S_SKIP.     */
+
+
+typedef double EVALFN (SUPP supp, SUPP body, SUPP head, SUPP n);
 
 typedef double AGGRFN (double aggr, double val);
 
+typedef struct {                /* --- pair counter (level 2) --- */
+  ISLEVEL *lvl;                 /* level with the pair item sets */
+  int     *rows;                /* row offsets of triangular matrix */
+  ISLEVEL mat;                  /* counters of triangular matrix */
+  int     mask;                 /* mask for the hash table index */
+  int     *tab;                 /* hash table (item, item, counter) */
+  int     *items;               /* buffer for the items of a node */
+} PAIRS;                        /* (pair counter) */
+
+#ifdef IST_THREADS
+typedef struct {                /* --- worker for a node range --- */
+  ISTREE    ist;                /* copy of the tree (own buffers) */
+  ISNODE    *beg, *end;         /* range of nodes to process */
+  ISLEVEL   cl;                 /* arena for the child nodes */
+  ISLEVEL   kl;                 /* arena for the child indices */
+  int       level;              /* level of the nodes (ist_mark()) */
+  int       mode;               /* marking mode (ist_mark()) */
+  int       err;                /* error indicator */
+  pthread_t thread;             /* thread executing the worker */
+} WORKER;                       /* (worker for ist_addlvl()/mark()) */
+#endif
+
 
 
 
-static double _conf (int supp, int body, int head, int base)
+static double _conf (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- rule confidence */
   return (body > 0) ? supp/(double)body : 0;
 }  /* _conf() */
 
 
 
-static double _diff (int supp, int body, int head, int base)
+static double _diff (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- absolute confidence difference */
   if ((body <= 0) || (base <= 0)) return 0;
   return fabs(supp/(double)body -head/(double)base);
@@ -63,7 +122,7 @@ static double _diff (int supp, int body, int head, int base)
 
 
 
-static double _lift (int supp, int body, int head, int base)
+static double _lift (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- lift value */
   if ((body <= 0) || (head <= 0)) return 0;
   return (supp*(double)base) /(body*(double)head);
@@ -72,7 +131,7 @@ static double _lift (int supp, int body, int head, int base)
 
 
 
-static double _ld21 (int supp, int body, int head, int base)
+static double _ld21 (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- abs. diff. of lift value to 1 */
   if ((body <= 0) || (head <= 0)) return 0;
   return fabs((supp*(double)base) /(body*(double)head) -1);
@@ -80,7 +139,7 @@ static double _ld21 (int supp, int body, int head, int base)
 
 /*--------------------------------------------------------------------*/
 
-static double _quot (int supp, int body, int head, int base)
+static double _quot (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- diff. of lift quotient to 1 */
   double t;                     /* temporary buffer */
   if ((body <= 0) || (head <= 0)) return 0;
@@ -90,7 +149,7 @@ static double _quot (int supp, int body, int head, int base)
 
 
 
-static double _chi2 (int supp, int body, int head, int base)
+static double _chi2 (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- normalized chi^2 measure */
   double t;                     /* temporary buffer */
 
@@ -102,13 +161,13 @@ static double _chi2 (int supp, int body, int head, int base)
 }  /* _chi2() */                /* compute and return chi^2 measure */
 
 
-static double _pval (int supp, int body, int head, int base)
+static double _pval (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- p-value from chi^2 measure */
   return chi2cdf(base *_chi2(supp, body, head, base), 1);
 }  /* _pval() */
 
 
-static double _info (int supp, int body, int head, int base)
+static double _info (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- information diff. to prior */
   double sum, t;                /* result, temporary buffer */
 
@@ -123,11 +182,11 @@ static double _info (int supp, int body, int head, int base)
   if (t > 0) sum += t *log(t /(      head  *(double)(base-body)));
   t = base -head -body +supp;   /* support of not head and not body */
   if (t > 0) sum += t *log(t /((base-head) *(double)(base-body)));
-  return (log(base) +sum/base) /LN_2;
+  return (log((double)base) +sum/base) /LN_2;
 }  /* _info() */                /* return information gain in bits */
 
 
-static double _pgst (int supp, int body, int head, int base)
+static double _pgst (SUPP supp, SUPP body, SUPP head, SUPP base)
 {                               /* --- p-value from G statistic */
   return chi2cdf(base *2*LN_2 *_info(supp, body, head, base), 1);
 }  /* _pgst() */
@@ -146,16 +205,203 @@ static EVALFN *_evalfns[] = {   /* --- add. evaluation measures */
   /* IST_LOGQ 10 */ (EVALFN*)0, /* binary log. of support quotient */
 };                              /* table of evaluation functions */
 
+static const size_t _cwsize[] = {  /* --- counter sizes in bytes */
+  /* CW_CHAR  0 */ sizeof(signed char),
+  /* CW_SHORT 1 */ sizeof(short),
+  /* CW_INT   2 */ sizeof(int),
+  /* CW_SUPP  3 */ sizeof(SUPP),
+};                              /* (indexed with the counter width) */
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static int _bmfind (const int *bm, int item)
+{                               /* --- find the index of an item */
+  int          i, j;            /* bit and word index */
+  unsigned int b;               /* bit of the item */
+
+  assert(bm);                   /* check the function argument */
+  i = item -bm[0];              /* get the position in the bitmap */
+  if (i < 0) return -1;         /* and the index of the word */
+  j = i >> BM_SHIFT;            /* if the item is out of range */
+  if (j >= bm[1]) return -1;    /* or the bit is not set, abort */
+  b = 1u << (i & BM_MASK);      /* otherwise add the bits set */
+  if (!(BM_BITS(bm, j) & b)) return -1;      /* in the word */
+  return BM_RANK(bm, j) +tds_popcnt(BM_BITS(bm, j) & (b-1));
+}  /* _bmfind() */              /* to the rank of the word */
+
+/*--------------------------------------------------------------------*/
+
+static int _bmcount (const int *bm, int item)
+{                               /* --- count the items before an item */
+  int i, j;                     /* bit and word index */
+
+  assert(bm);                   /* check the function argument */
+  i = item -bm[0];              /* get the position in the bitmap */
+  if (i <= 0) return 0;         /* check for the first item */
+  j = i >> BM_SHIFT;            /* get the index of the word */
+  if (j >= bm[1])               /* if beyond the last word */
+    return BM_RANK(bm, bm[1]-1) +tds_popcnt(BM_BITS(bm, bm[1]-1));
+  return BM_RANK(bm, j)         /* count the bits before the item */
+       + tds_popcnt(BM_BITS(bm, j) & ((1u << (i & BM_MASK)) -1));
+}  /* _bmcount() */
+
+/*--------------------------------------------------------------------*/
+
+static int _bmitem (const int *bm, int index)
+{                               /* --- get the item with an index */
+  int          l, r, m;         /* word indices for binary search */
+  unsigned int w;               /* bits of the word */
+
+  assert(bm && (index >= 0));   /* check the function arguments */
+  for (l = 0, r = bm[1]; r-l > 1; ) {
+    m = (l+r) >> 1;             /* find the last word with a rank */
+    if (BM_RANK(bm, m) > index) r = m; else l = m;
+  }                             /* not exceeding the index */
+  w = BM_BITS(bm, l);           /* get the bits of the word and */
+  for (index -= BM_RANK(bm, l); --index >= 0; )
+    w &= w-1;                   /* remove the lower bits set */
+  return bm[0] +(l << BM_SHIFT) +tds_popcnt((w & (~w+1)) -1);
+}  /* _bmitem() */              /* return the lowest remaining bit */
+
+/*--------------------------------------------------------------------*/
+
+static void _bmrank (int *bm)
+{                               /* --- recompute the word ranks */
+  int j, r;                     /* word index, rank */
+
+  assert(bm);                   /* check the function argument */
+  for (r = j = 0; j < bm[1]; j++) {
+    BM_RANK(bm, j) = r;         /* traverse the words and */
+    r += tds_popcnt(BM_BITS(bm, j));  /* sum the number of bits set */
+  }                             /* in the preceding words */
+}  /* _bmrank() */
+
+/*--------------------------------------------------------------------*/
+
+static int _index (ISLEVEL *lvl, ISNODE *node, int item)
+{                               /* --- get the counter index of an item */
+  assert(lvl && node);          /* check the function arguments */
+  if (node->offset >= 0) {      /* if a pure array is used */
+    item -= node->offset;       /* compute the counter index */
+    return (item < node->size) ? item : -1; }
+  if (BITMAP(node))             /* if a bitmap is used */
+    return _bmfind(MAP(lvl, node), item);
+  return int_bsearch(item, MAP(lvl, node), node->size);
+}  /* _index() */               /* search the identifier map */
 
+/*--------------------------------------------------------------------*/
+
+static int _item (ISLEVEL *lvl, ISNODE *node, int index)
+{                               /* --- get the item of a counter */
+  assert(lvl && node);          /* check the function arguments */
+  if (node->offset >= 0)        /* if a pure array is used */
+    return node->offset +index; /* add the item offset */
+  if (BITMAP(node))             /* if a bitmap is used */
+    return _bmitem(MAP(lvl, node), index);
+  return MAP(lvl, node)[index]; /* look up the item */
+}  /* _item() */                /* in the identifier map */
 
-static int _search (int id, ISNODE **chn, int n)
+/*--------------------------------------------------------------------*/
+
+static int _width (SUPP max)
+{                               /* --- get counter width for a bound */
+  if (max <= SCHAR_MAX) return CW_CHAR;
+  if (max <= SHRT_MAX)  return CW_SHORT;
+  if (max <= INT_MAX)   return CW_INT;
+  return CW_SUPP;               /* choose the smallest type that */
+}  /* _width() */               /* can hold the maximal support */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP _getcnt (const ISLEVEL *lvl, int k)
+{                               /* --- get a support counter */
+  SUPP s;                       /* value of the counter */
+
+  switch (lvl->cw) {            /* evaluate the counter width */
+    case CW_CHAR:  s = ((signed char*)lvl->cnts)[k];
+                   return (s < 0) ? (s & SCHAR_MAX) | S_SKIP : s;
+    case CW_SHORT: s = ((short*)lvl->cnts)[k];
+                   return (s < 0) ? (s & SHRT_MAX)  | S_SKIP : s;
+    case CW_INT:   s = ((int*)lvl->cnts)[k];
+                   return (s < 0) ? (s & INT_MAX)   | S_SKIP : s;
+    default:       return ((SUPP*)lvl->cnts)[k];
+  }                             /* map the sign bit of the counter */
+}  /* _getcnt() */               /* to the skip flag of a support */
+
+/*--------------------------------------------------------------------*/
+
+static void _setcnt (ISLEVEL *lvl, int k, SUPP s)
+{                               /* --- set a support counter */
+  switch (lvl->cw) {            /* evaluate the counter width */
+    case CW_CHAR:  ((signed char*)lvl->cnts)[k] = (signed char)
+                   ((s < 0) ? COUNT(s) | SCHAR_MIN : s);  break;
+    case CW_SHORT: ((short*)lvl->cnts)[k] = (short)
+                   ((s < 0) ? COUNT(s) | SHRT_MIN  : s);  break;
+    case CW_INT:   ((int*)lvl->cnts)[k] = (int)
+                   ((s < 0) ? COUNT(s) | INT_MIN   : s);  break;
+    default:       ((SUPP*)lvl->cnts)[k] = s;             break;
+  }                             /* map the skip flag of a support */
+}  /* _setcnt() */               /* to the sign bit of the counter */
+
+/*--------------------------------------------------------------------*/
+
+static void _skip (ISLEVEL *lvl, int k)
+{                               /* --- set the skip flag of a counter */
+#if defined IST_THREADS && defined __GNUC__
+  switch (lvl->cw) {            /* evaluate the counter width */
+    case CW_CHAR:  __sync_fetch_and_or((signed char*)lvl->cnts +k,
+                                       (signed char)SCHAR_MIN); break;
+    case CW_SHORT: __sync_fetch_and_or((short*)lvl->cnts +k,
+                                       (short)SHRT_MIN);        break;
+    case CW_INT:   __sync_fetch_and_or((int*)lvl->cnts +k,
+                                       (int)INT_MIN);           break;
+    default:       __sync_fetch_and_or((SUPP*)lvl->cnts +k,
+                                       (SUPP)S_SKIP);           break;
+  }                             /* set the sign bit atomically, */
+#else                           /* as several threads may mark */
+  _setcnt(lvl, k, _getcnt(lvl, k) | S_SKIP);    /* the same set */
+#endif                          /* (see ist_mark()) */
+}  /* _skip() */
+
+/*--------------------------------------------------------------------*/
+
+static void _inccnt (ISLEVEL *lvl, int k, SUPP w)
+{                               /* --- increment a support counter */
+  switch (lvl->cw) {            /* evaluate the counter width */
+    case CW_CHAR:  ((signed char*)lvl->cnts)[k] += (signed char)w; break;
+    case CW_SHORT: ((short*)      lvl->cnts)[k] += (short)w;       break;
+    case CW_INT:   ((int*)        lvl->cnts)[k] += (int)w;         break;
+    default:       ((SUPP*)       lvl->cnts)[k] += w;              break;
+  }                             /* add the weight to the counter */
+}  /* _inccnt() */               /* (cannot overflow, see _width()) */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP _maxcnt (const ISLEVEL *lvl)
+{                               /* --- get the largest support */
+  int  i;                       /* loop variable */
+  SUPP s, max = 0;              /* (maximal) support of an item set */
+
+  assert(lvl);                  /* check the function argument */
+  for (i = lvl->ccnt; --i >= 0; ) {
+    s = COUNT(_getcnt(lvl, i)); /* traverse the counters */
+    if (s > max) max = s;       /* of the level and */
+  }                             /* determine their maximum */
+  return max;                   /* return the maximal support */
+}  /* _maxcnt() */
+
+
+
+static int _search (int id, const int *chn, int n, const ISNODE *cld)
 {                               /* --- find a child node (index) */
   int i, k, x;                  /* left and middle index */
 
-  assert(chn && (n > 0));       /* check the function arguments */
+  assert(chn && cld && (n > 0));/* check the function arguments */
   for (i = 0; i < n; ) {        /* while the range is not empty */
     k = (i+n) >> 1;             /* get index of the middle element */
-    x = ID(chn[k]);             /* compare the item identifier */
+    x = ID(cld +chn[k]);        /* compare the item identifier */
     if      (id > x) i = k+1;   /* to the middle element and */
     else if (id < x) n = k;     /* adapt the range boundaries */
     else return k;              /* if there is an exact match, */
@@ -165,40 +411,179 @@ static int _search (int id, ISNODE **chn, int n)
 
 
 
-static int _getsupp (ISNODE *node, int *items, int n)
-{                               /* --- get support of an item set */
-  int    i, k;                  /* array indices, number of children */
-  int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* child node array */
+static int _counter (ISLEVEL **plvl, ISNODE *node,
+                     const int *items, int n)
+{                               /* --- find the counter of an item set */
+  int     i, k;                 /* array indices, number of children */
+  int     *chn;                 /* child node array */
+  ISLEVEL *lvl;                 /* level of the current node */
 
-  assert(node                   /* check the function arguments */
+  assert(plvl && *plvl && node  /* check the function arguments */
      && (n >= 0) && (items || (n <= 0)));
+  lvl = *plvl;                  /* get the level of the start node */
   while (--n > 0) {             /* follow the set/path from the node */
     k = CHCNT(node);            /* if there are no children, */
-    if (k <= 0) return F_SKIP;  /* the support is less than minsupp */
+    if (k <= 0) return -1;      /* there is no counter for the set */
+    chn = CHN(lvl, node);       /* get the child index array */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-      i = *items++ -ID(chn[0]); /* compute the child array index and */
-      if (i >= k) return F_SKIP; }  /* abort if child does not exist */
-    else {                      /* if an identifier map is used */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
-      i = _search(*items++, chn, k);
-    }                           /* search for the proper index */
-    if (i < 0) return F_SKIP;   /* abort if index is out of range */
-    node = chn[i];              /* go to the corresponding child */
-    if (!node) return F_SKIP;   /* if the child does not exists, */
-  }                             /* the support is less than minsupp */
-  if (node->offset >= 0) {      /* if a pure array is used, */
-    i = *items -node->offset;   /* compute the counter index */
-    if (i >= node->size) return F_SKIP; }
-  else {                        /* if an identifier map is used */
-    map = node->cnts +(k = node->size);
-    i   = int_bsearch(*items, map, k);
-  }                             /* search for the proper index */
-  if (i < 0) return F_SKIP;     /* abort if index is out of range */
-  return node->cnts[i];         /* return the item set support */
+      i = *items++ -ID(lvl[1].nodes +chn[0]);
+      if (i >= k) return -1; }  /* compute the child array index */
+    else if (BITMAP(node))      /* if a bitmap is used */
+      i = _bmfind(MAP(lvl, node), *items++);
+    else                        /* if an identifier map is used */
+      i = _search(*items++, chn, k, lvl[1].nodes);
+    if (i < 0) return -1;       /* abort if index is out of range */
+    if (chn[i] < 0) return -1;  /* abort if the child does not exist, */
+    node = (++lvl)->nodes +chn[i];    /* otherwise go to the child */
+  }
+  i = _index(lvl, node, *items);/* get the counter index */
+  if (i < 0) return -1;         /* abort if index is out of range */
+  *plvl = lvl;                  /* return the level of the counter */
+  return node->cnts +i;         /* and the counter index */
+}  /* _counter() */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP _getsupp (ISLEVEL *lvl, ISNODE *node, const int *items, int n)
+{                               /* --- get support of an item set */
+  int c;                        /* index of the counter */
+
+  c = _counter(&lvl, node, items, n);
+  if (c < 0) return S_SKIP;     /* a missing set is less than minsupp */
+  return _getcnt(lvl, c);       /* return the item set support */
 }  /* _getsupp() */
 
+/*----------------------------------------------------------------------
+  Subset Lookup Functions
+----------------------------------------------------------------------*/
+/* The support of a subset is usually retrieved by descending from an */
+/* ancestor node, which needs a search in every identifier map on the */
+/* way. To speed this up, a hash table is built for a level on first  */
+/* use (that is, after the level has been counted), which maps the    */
+/* frequent item sets of the level to their counters. The hash value  */
+/* of an item set is the sum of the mixed item identifiers, so that   */
+/* the values of all n-1 subsets of a set can be derived from the one */
+/* of the set. A table slot holds the index of the node, the last     */
+/* item and the counter index; a hit is verified by following the     */
+/* parent links up to the node from which the set was looked up.      */
+/* Infrequent item sets are not stored, a lookup for them yields      */
+/* S_SKIP, which compares as "less than the minimum support".         */
+
+static unsigned int _hmix (int item)
+{                               /* --- mix an item identifier */
+  unsigned int h = (unsigned int)item;
+  h ^= h >> 16; h *= 0x85ebca6bU;
+  h ^= h >> 13; h *= 0xc2b2ae35U;
+  return h ^ (h >> 16);         /* apply a finalizing mix function */
+}  /* _hmix() */
+
+/*--------------------------------------------------------------------*/
+
+static unsigned int _hpath (ISLEVEL *lvl, ISNODE *node)
+{                               /* --- hash the path to a node */
+  unsigned int h = 0;           /* hash value of the path */
+  for ( ; node->parent >= 0; lvl--) {
+    h += _hmix(ID(node));       /* sum the mixed items on the path */
+    node = PARENT(lvl, node);   /* and go to the parent node */
+  }                             /* (up to, but excluding the root) */
+  return h;                     /* return the hash value */
+}  /* _hpath() */
+
+/*--------------------------------------------------------------------*/
+
+static int _hbuild (ISTREE *ist, ISLEVEL *lvl)
+{                               /* --- build a subset lookup table */
+  int          i, k, n;         /* loop variables, number of sets */
+  int          *p;              /* to traverse the table slots */
+  unsigned int h, m;            /* hash value and index mask */
+  ISNODE       *node;           /* to traverse the nodes */
+
+  for (n = 0, i = lvl->ccnt; --i >= 0; )
+    if (COUNT(_getcnt(lvl, i)) >= ist->supp) n++;
+  for (k = 16; k < n+n; k += k) /* count the frequent item sets */
+    if (k >= INT_MAX/6) { lvl->hsz = -1; return -1; }
+  lvl->hash = (int*)malloc((size_t)k *3 *sizeof(int));
+  if (!lvl->hash) { lvl->hsz = -1; return -1; }
+  lvl->hsz = k; m = (unsigned int)k-1;  /* create the table slots */
+  for (p = lvl->hash +3*k; p > lvl->hash; ) { p -= 3; p[0] = -1; }
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    h = _hpath(lvl, node);      /* traverse the nodes of the level */
+    for (i = 0; i < node->size; i++) {
+      if (COUNT(_getcnt(lvl, node->cnts +i)) < ist->supp)
+        continue;               /* skip the infrequent item sets */
+      k = _item(lvl, node, i);  /* get the last item of the set */
+      for (p = lvl->hash +3*((h +_hmix(k)) & m); p[0] >= 0; ) {
+        p += 3; if (p >= lvl->hash +3*lvl->hsz) p = lvl->hash; }
+      p[0] = (int)(node -lvl->nodes);
+      p[1] = k;                 /* find a free slot (linear probing) */
+      p[2] = node->cnts +i;     /* and store the node index, */
+    }                           /* the last item of the set */
+  }                             /* and the counter index */
+  return 0;                     /* return 'ok' */
+}  /* _hbuild() */
+
+/*--------------------------------------------------------------------*/
+
+static int _hready (ISTREE *ist, ISLEVEL *lvl)
+{                               /* --- check for a lookup table */
+  if (lvl->hsz > 0) return 1;   /* if the table exists, use it */
+  if ((lvl->hsz < 0)            /* if the table cannot be built, */
+  ||  (lvl == ist->lvls)        /* the level is the root level */
+  ||  lvl->spec) return 0;      /* or the level is uncounted, abort */
+  return (_hbuild(ist, lvl) == 0);
+}  /* _hready() */              /* build the lookup table */
+
+/*--------------------------------------------------------------------*/
+
+static void _hfree (ISLEVEL *lvl)
+{                               /* --- delete a lookup table */
+  if (lvl->hash) free(lvl->hash);
+  lvl->hash = NULL; lvl->hsz = 0;
+}  /* _hfree() */               /* (must be rebuilt on next use) */
+
+/*--------------------------------------------------------------------*/
+
+static int _hfind (ISLEVEL *lvl, unsigned int h,
+                   ISNODE *node, const int *items, int n)
+{                               /* --- find a counter with the table */
+  int     j;                    /* loop variable */
+  int     *p;                   /* to traverse the table slots */
+  ISLEVEL *l;                   /* to traverse the levels */
+  ISNODE  *curr;                /* to traverse the path */
+
+  assert(lvl && node && items && (n > 0) && (lvl->hsz > 0));
+  for (p = lvl->hash +3*(h & (unsigned int)(lvl->hsz-1)); p[0] >= 0; ) {
+    if (p[1] == items[n-1]) {   /* if the last item matches, */
+      curr = lvl->nodes +p[0];  /* compare the path of the node */
+      for (l = lvl, j = n-1; --j >= 0; l--) {
+        if (ID(curr) != items[j]) break;
+        curr = PARENT(l, curr); /* compare the items of the set */
+      }                         /* and go to the parent node */
+      if ((j < 0) && (curr == node))
+        return p[2];            /* if the set was found, */
+    }                           /* return the counter index */
+    p += 3; if (p >= lvl->hash +3*lvl->hsz) p = lvl->hash;
+  }                             /* (linear probing) */
+  return -1;                    /* return 'not found' */
+}  /* _hfind() */
+
+/*--------------------------------------------------------------------*/
+
+static SUPP _lookup (ISTREE *ist, ISLEVEL *lvl, ISNODE *node,
+                     const int *items, int n)
+{                               /* --- get support of an item set */
+  int          i;               /* loop variable, counter index */
+  unsigned int h;               /* hash value of the item set */
+
+  if ((n <= 1) || !_hready(ist, lvl +n-1))
+    return _getsupp(lvl, node, items, n);
+  h = _hpath(lvl, node);        /* if there is no lookup table, */
+  for (i = n; --i >= 0; )       /* descend from the node, */
+    h += _hmix(items[i]);       /* otherwise hash the item set */
+  i = _hfind(lvl +n-1, h, node, items, n);
+  return (i < 0) ? S_SKIP : _getcnt(lvl +n-1, i);
+}  /* _lookup() */              /* return the item set support */
+
 
 
 static double _min (double aggr, double val)
@@ -220,33 +605,30 @@ static AGGRFN *_aggrfns[] = {   /* --- measure aggregation functions */
 
 static double _aggregate (ISTREE *ist)
 {                               /* --- average rule confidence */
-  int    n, item;               /* loop variable, current (head) item */
-  int    supp;                  /* support of item set */
-  int    body, head;            /* support of rule body and head */
-  int    base;                  /* total transaction weight */
-  int    *path;                 /* path to follow for body support */
-  ISNODE *node, *curr;          /* to traverse the nodes */
-  EVALFN *eval;                 /* add. evaluation function */
-  AGGRFN *aggr;                 /* aggregation function */
-  double val;                   /* (aggregated) value of measure */
+  int     n, item;              /* loop variable, current (head) item */
+  SUPP    supp;                 /* support of item set */
+  SUPP    body, head;           /* support of rule body and head */
+  SUPP    base;                 /* total transaction weight */
+  int     *path;                /* path to follow for body support */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node, *curr;         /* to traverse the nodes */
+  EVALFN  *eval;                /* add. evaluation function */
+  AGGRFN  *aggr;                /* aggregation function */
+  double  val;                  /* (aggregated) value of measure */
 
   assert(ist);                  /* check the function argument */
-  node = ist->node;             /* get the item set support */
-  if (node->offset >= 0) item = ist->index +node->offset;
-  else                   item = node->cnts[node->size +ist->index];
-  supp = COUNT(node->cnts[ist->index]);
-  head = COUNT(ist->lvls[0]->cnts[item]);
+  lvl  = ist->lvls +ist->level; /* get the item set node */
+  node = ist->node;             /* and the item set support */
+  item = _item(lvl, node, ist->index);
+  supp = COUNT(_getcnt(lvl, node->cnts +ist->index));
+  head = COUNT(_getcnt(ist->lvls, item));
   base = COUNT(ist->wgt);       /* get head and empty set support */
   eval = _evalfns[ist->eval];   /* get the evaluation function */
-  curr = node->parent;          /* get subset support from parent */
-  if (!curr)                    /* if there is no parent (root node), */
+  if (node->parent < 0)         /* if there is no parent (root node), */
     return eval(supp, base, head, base); /* evaluate the set directly */
-  if (curr->offset >= 0)        /* if a pure array is used */
-    body = COUNT(curr->cnts[ID(node) -curr->offset]);
-  else {                        /* if an identifier map is used */
-    path = curr->cnts +(n = curr->size);
-    body = COUNT(curr->cnts[int_bsearch(ID(node), path, n)]);
-  }                             /* find index and get subset support */
+  curr = PARENT(lvl, node); lvl--; /* get subset support from parent */
+  n    = _index(lvl, curr, ID(node));
+  body = COUNT(_getcnt(lvl, curr->cnts +n));
   val = eval(supp, body, head, base);
   if (ist->agg <= IST_NONE)     /* compute the first measure value */
     return val;                 /* and check whether to return it */
@@ -254,173 +636,257 @@ static double _aggregate (ISTREE *ist)
   *--path = item;               /* for the support retrieval */
   item = ID(node);              /* get the next head item */
   aggr = _aggrfns[ist->agg];    /* and the aggregation function */
-  for (n = 0; curr; curr = curr->parent) {
-    body = COUNT(_getsupp(curr, path, ++n));
+  for (n = 0; 1; curr = PARENT(lvl, curr), lvl--) {
+    body = COUNT(_lookup(ist, lvl, curr, path, ++n));
     val  = aggr(val, eval(supp, body, head, base));
     *--path = item;             /* get the support of the rule body */
     item = ID(curr);            /* and sum the rule confidences, */
-  }                             /* then extend the path (store head) */
+    if (curr->parent < 0) break;/* then extend the path (store head) */
+  }                             /* until the root node is reached */
   return (ist->agg >= IST_AVG) ? val /(n+1) : val;
 }  /* _aggregate() */           /* return the measure aggregate */
 
 static double _logq (ISTREE *ist)
 {                               /* --- logarithm of support quotient */
-  int    n, item;               /* loop variable, current item */
-  int    *cnts;                 /* array of item frequencies */
-  ISNODE *node;                 /* to traverse the nodes */
-  double sum;                   /* sum of logs. of item frequencies */
+  int     n, item;              /* loop variable, current item */
+  ISLEVEL *root;                /* level with the item frequencies */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node;                /* to traverse the nodes */
+  double  sum;                  /* sum of logs. of item frequencies */
 
   assert(ist);                  /* check the function argument */
-  cnts = ist->lvls[0]->cnts;    /* get the item frequencies */
+  root = ist->lvls;             /* get the item frequencies */
+  lvl  = ist->lvls +ist->level; /* get the item set node */
   node = ist->node;             /* and the item set support */
-  if (node->offset >= 0) item = ist->index +node->offset;
-  else                   item = node->cnts[node->size +ist->index];
-  sum = log(COUNT(node->cnts[ist->index])) -log(COUNT(cnts[item]));
-  for (n = 0; node->parent; node = node->parent) {
-    sum -= log(COUNT(cnts[ID(node)])); n++; }
-  if (n > 0) sum += n *log(COUNT(ist->wgt));
+  item = _item(lvl, node, ist->index);
+  sum = log((double)COUNT(_getcnt(lvl, node->cnts +ist->index)))
+      - log((double)COUNT(_getcnt(root, item)));
+  for (n = 0; node->parent >= 0; node = PARENT(lvl, node), lvl--) {
+    sum -= log((double)COUNT(_getcnt(root, ID(node)))); n++; }
+  if (n > 0) sum += n *log((double)COUNT(ist->wgt));
   return sum /LN_2;             /* sum logs. of item frequencies and */
 }  /* _logq() */                /* subtract from log. of set freq., */
 
 
-static void _count (ISNODE *node,
-                    const int *items, int n, int wgt, int min)
+static int _count (ISLEVEL *lvl, ISNODE *node,
+                   const int *items, int n, SUPP wgt, int min, int *marks)
 {                               /* --- count transaction recursively */
   int    i, k, o;               /* array index, offset, map size */
-  int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* array of child nodes */
-
-  assert(node                   /* check the function arguments */
+  int    c;                     /* index of the first counter */
+  int    r = 0;                 /* whether a counter was incremented */
+  int    *map;                  /* item identifier map or bitmap */
+  int    *chn;                  /* array of child nodes */
+  ISNODE *cld;                  /* nodes of the next level */
+  ISNODE leaf;                  /* node copy for a speculative level */
+
+  assert(lvl && node            /* check the function arguments */
      && (n >= 0) && (items || (n <= 0)));
+  if (lvl->spec && (node->chcnt != 0)) {
+    leaf = *node; leaf.chcnt = 0;  /* if the level is still uncounted, */
+    r = _count(lvl, &leaf, items, n, wgt, min, marks);
+    if (node->chcnt < 0) return r;
+  }                             /* count the node's own counters */
   if (node->offset >= 0) {      /* if a pure array is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      o = node->offset;         /* get the index offset */
+      c    = node->cnts;        /* get the counter position */
+      o    = node->offset;      /* and the index offset */
       while ((n > 0) && (*items < o)) {
         n--; items++; }         /* skip items before first counter */
       while (--n >= 0) {        /* traverse the transaction's items */
         i = *items++ -o;        /* compute the counter array index */
-        if (i >= node->size) return;
-        node->cnts[i] += wgt;   /* if the corresp. counter exists, */
+        if (i >= node->size) return r;
+        _inccnt(lvl, c+i, wgt); /* if the corresp. counter exists, */
+        if (marks) marks[items[-1]] = r = 1;
       } }                       /* add the transaction weight to it */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-      o   = ID(chn[0]);         /* get the child node array */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      o   = ID(cld +chn[0]);    /* get the first child's item */
       while ((n >= min) && (*items < o)) {
         n--; items++; }         /* skip items before the first child */
       for (--min; --n >= min;){ /* traverse the transaction's items */
         i = *items++ -o;        /* compute the child array index */
-        if (i >= node->chcnt) return;
-        if (chn[i]) _count(chn[i], items, n, wgt, min);
+        if (i >= node->chcnt) return r;
+        if ((chn[i] >= 0)       /* if the corresp. child node exists, */
+        &&  _count(lvl+1, cld +chn[i], items, n, wgt, min, marks))
+          marks[items[-1]] = r = 1;
+      }                         /* count the transaction recursively */
+    } }                         /* and mark the item if it was used */
+  else if (BITMAP(node)) {      /* if a bitmap is used */
+    map = MAP(lvl, node);       /* get the bitmap, the first item */
+    o   = map[0];               /* and the size of the item range */
+    k   = map[1] << BM_SHIFT;   /* (number of bits in the bitmap) */
+    if (node->chcnt == 0) {     /* if this is a new node (leaf) */
+      c = node->cnts;           /* get the counter position */
+      while ((n > 0) && (*items < o)) {
+        n--; items++; }         /* skip items before first counter */
+      while (--n >= 0) {        /* traverse the transaction's items */
+        if (*items -o >= k) return r;  /* if beyond last item, abort */
+        i = _bmfind(map, *items++);    /* get the counter index */
+        if (i < 0) continue;    /* add the transaction weight */
+        _inccnt(lvl, c+i, wgt); /* to the corresponding counter */
+        if (marks) marks[items[-1]] = r = 1;
+      } }                       /* and mark the item */
+    else if (node->chcnt > 0) { /* if there are child nodes */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      while ((n >= min) && (*items < o)) {
+        n--; items++; }         /* skip items before the first child */
+      for (--min; --n >= min;){ /* traverse the transaction's items */
+        if (*items -o >= k) return r;  /* if beyond last item, abort */
+        i = _bmfind(map, *items++);    /* get the child array index */
+        if ((i >= 0) && (chn[i] >= 0)
+        &&  _count(lvl+1, cld +chn[i], items, n, wgt, min, marks))
+          marks[items[-1]] = r = 1;
       }                         /* if the corresp. child node exists, */
     } }                         /* count the transaction recursively */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      map = node->cnts +(k = node->size);
-      o   = map[0];             /* get the identifier map */
+      c    = node->cnts;        /* get the counter position */
+      map  = MAP(lvl, node);    /* and the identifier map */
+      k    = node->size;        /* get the map size */
+      o    = map[0];            /* and the first item with a counter */
       while ((n > 0) && (*items < o)) {
         n--; items++; }         /* skip items before first counter */
       o   = map[k-1];           /* get the last item with a counter */
       for (i = 0; --n >= 0; ) { /* traverse the transaction's items */
-        if (*items > o) return; /* if beyond last item, abort */
+        if (*items > o) return r;   /* if beyond last item, abort */
         #ifdef IST_BSEARCH      /* if to use a binary search */
         i = int_bsearch(*items++, map, k);
-        if (i >= 0) node->cnts[i] += wgt;
+        if (i < 0) continue;    /* if the corresp. counter exists, */
         #else                   /* if to use a linear search */
         while (*items > map[i]) i++;
-        if (*items++ == map[i]) node->cnts[i] += wgt;
+        if (*items++ != map[i]) continue;
         #endif                  /* if the corresp. counter exists, */
-      } }                       /* add the transaction weight to it */
+        _inccnt(lvl, c+i, wgt); /* add the transaction weight to it */
+        if (marks) marks[items[-1]] = r = 1;
+      } }                       /* and mark the item */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
-      o   = ID(chn[0]);         /* get the child node array */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      o   = ID(cld +chn[0]);    /* get the first child's item */
       while ((n >= min) && (*items < o)) {
         n--; items++; }         /* skip items before first child */
       k   = node->chcnt;        /* get the number of children and */
-      o   = ID(chn[k-1]);       /* the index of the last item */
+      o   = ID(cld +chn[k-1]);  /* the index of the last item */
       for (--min; --n >= min; ) {
-        if (*items > o) return; /* traverse the transaction */
+        if (*items > o) return r;   /* traverse the transaction */
         #ifdef IST_BSEARCH      /* if to use a binary search */
-        i = _search(*items++, chn, k);
-        if (i >= 0) _count(chn[i], items, n, wgt, min);
-        else        i = -1-i;   /* count the transaction recursively */
-        chn += i; k -= i;       /* and adapt the child node range */
+        i = _search(*items++, chn, k, cld);
+        if (i < 0) { i = -1-i; chn += i; k -= i; continue; }
+        chn += i; k -= i;       /* adapt the child node range */
         #else                   /* if to use a linear search */
-        while (*items > ID(*chn)) chn++;
-        if (*items++ == ID(*chn)) _count(*chn, items, n, wgt, min);
+        while (*items > ID(cld +*chn)) chn++;
+        if (*items++ != ID(cld +*chn)) continue;
         #endif                  /* find the proper child node index */
+        if (_count(lvl+1, cld +*chn, items, n, wgt, min, marks))
+          marks[items[-1]] = r = 1;
       }                         /* if the corresp. child node exists, */
     }                           /* count the transaction recursively */
-  }
+  }                             /* and mark the item if it was used */
+  return r;                     /* return whether a counter was used */
 }  /* _count() */
 
 
-static void _countx (ISNODE *node, const TTNODE *tree, int min)
+static void _countx (ISLEVEL *lvl, ISNODE *node,
+                     const TTNODE *tree, int min)
 {                               /* --- count trans. tree recursively */
   int    i, k, o, n;            /* array indices, loop variables */
   int    item;                  /* buffer for an item */
-  int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* child node array */
+  int    c;                     /* index of the first counter */
+  int    *map;                  /* item identifier map or bitmap */
+  int    *chn;                  /* child node array */
+  ISNODE *cld;                  /* nodes of the next level */
 
-  assert(node && tree);         /* check the function arguments */
+  assert(lvl && node && tree);  /* check the function arguments */
   if (ttn_max(tree) < min)      /* if the transactions are too short, */
     return;                     /* abort the recursion */
   n = ttn_size(tree);           /* get the number of children */
   if (n <= 0) {                 /* if there are no children */
-    if (n < 0) _count(node, ttn_items(tree), -n, ttn_wgt(tree), min);
+    if (n < 0) _count(lvl, node, ttn_items(tree), -n, ttn_wgt(tree),
+                      min, NULL);
     return;                     /* count the normal transaction */
   }                             /* and abort the function */
   while (--n >= 0)              /* count the transactions recursively */
-    _countx(node, ttn_child(tree, n), min);
+    _countx(lvl, node, ttn_child(tree, n), min);
   if (node->offset >= 0) {      /* if a pure array is used */
-    if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      o = node->offset;         /* get the index offset */
+    if ((node->chcnt == 0) || lvl->spec) {  /* if leaf or spec. */
+      c    = node->cnts;        /* get the counter position */
+      o    = node->offset;      /* and the index offset */
       for (n = ttn_size(tree); --n >= 0; ) {
         i = ttn_item(tree,n)-o; /* traverse the node's items */
-        if (i < 0) return;      /* if before the first item, abort */
+        if (i < 0) break;       /* if before the first item, abort */
         if (i < node->size)     /* if the corresp. counter exists */
-          node->cnts[i] += ttn_wgt(ttn_child(tree, n));
+          _inccnt(lvl, c+i, ttn_wgt(ttn_child(tree, n)));
       } }                       /* add the transaction weight to it */
-    else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-      o   = ID(chn[0]);         /* get the child node array */
+    if (node->chcnt > 0) {      /* if there are child nodes */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      o   = ID(cld +chn[0]);    /* get the first child's item */
       for (--min, n = ttn_size(tree); --n >= 0; ) {
         i = ttn_item(tree,n)-o; /* traverse the node's items */
         if (i < 0) return;      /* if before the first item, abort */
-        if ((i < node->chcnt) && chn[i])
-          _countx(chn[i], ttn_child(tree, n), min);
+        if ((i < node->chcnt) && (chn[i] >= 0))
+          _countx(lvl+1, cld +chn[i], ttn_child(tree, n), min);
       }                         /* if the corresp. child node exists, */
     } }                         /* count the trans. tree recursively */
-  else {                        /* if an identifer map is used */
-    if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      map = node->cnts +(k = node->size);
-      o   = map[0];             /* get the item identifier map */
-      for (n = ttn_size(tree); n >= 0; --n) {
+  else if (BITMAP(node)) {      /* if a bitmap is used */
+    map = MAP(lvl, node);       /* get the bitmap */
+    o   = map[0];               /* and the first item */
+    if ((node->chcnt == 0) || lvl->spec) {  /* if leaf or spec. */
+      c = node->cnts;           /* get the counter position */
+      for (n = ttn_size(tree); --n >= 0; ) {
+        item = ttn_item(tree,n);/* traverse the node's items */
+        if (item < o) break;    /* if before the first item, abort */
+        i = _bmfind(map, item); /* get the counter index */
+        if (i >= 0) _inccnt(lvl, c+i, ttn_wgt(ttn_child(tree, n)));
+      } }                       /* add the transaction weight to it */
+    if (node->chcnt > 0) {      /* if there are child nodes */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      for (--min, n = ttn_size(tree); --n >= 0; ) {
         item = ttn_item(tree,n);/* traverse the node's items */
         if (item < o) return;   /* if before the first item, abort */
+        i = _bmfind(map, item); /* get the child array index */
+        if ((i >= 0) && (chn[i] >= 0))
+          _countx(lvl+1, cld +chn[i], ttn_child(tree, n), min);
+      }                         /* if the corresp. child node exists, */
+    } }                         /* count the trans. tree recursively */
+  else {                        /* if an identifer map is used */
+    if ((node->chcnt == 0) || lvl->spec) {  /* if leaf or spec. */
+      c    = node->cnts;        /* get the counter position */
+      map  = MAP(lvl, node);    /* and the identifier map */
+      k    = node->size;        /* get the map size */
+      o    = map[0];            /* and the first item with a counter */
+      for (n = ttn_size(tree); --n >= 0; ) {
+        item = ttn_item(tree,n);/* traverse the node's items */
+        if (item < o) break;    /* if before the first item, abort */
         #ifdef IST_BSEARCH      /* if to use a binary search */
         i = int_bsearch(item, map, k);
-        if (i >= 0) node->cnts[k = i] += ttn_wgt(ttn_child(tree, n));
+        if (i >= 0) _inccnt(lvl, c +(k = i), ttn_wgt(ttn_child(tree, n)));
         else        k = -1-i;   /* add trans. weight to the counter */
         #else                   /* if to use a linear search */
         while (item < map[--k]);
-        if (item == map[k]) node->cnts[k] += ttn_wgt(ttn_child(tree,n));
+        if (item == map[k]) _inccnt(lvl, c+k, ttn_wgt(ttn_child(tree, n)));
         else k++;               /* if the corresp. counter exists, */
         #endif                  /* add the transaction weight to it, */
       } }                       /* otherwise adapt the map index */
-    else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
-      k   = node->chcnt;        /* get the child node array and */
-      o   = ID(chn[0]);         /* the last item with a child */
+    if (node->chcnt > 0) {      /* if there are child nodes */
+      chn = CHN(lvl, node);     /* get the child node array */
+      cld = lvl[1].nodes;       /* and the nodes of the next level */
+      k   = node->chcnt;        /* get the number of children and */
+      o   = ID(cld +chn[0]);    /* the first item with a child */
       for (--min, n = ttn_size(tree); --n >= 0; ) {
         item = ttn_item(tree,n);/* traverse the node's items */
         if (item < o) return;   /* if before the first item, abort */
         #ifdef IST_BSEARCH      /* if to use a binary search */
-        i = _search(item, chn, k);
-        if (i >= 0) _countx(chn[i], ttn_child(tree, n), min);
+        i = _search(item, chn, k, cld);
+        if (i >= 0) _countx(lvl+1, cld +chn[i], ttn_child(tree, n), min);
         else        k = -1-i;   /* add trans. weight to the counter */
         #else                   /* if to use a linear search */
-        while (item < ID(chn[--k]));
-        if (item == ID(chn[k])) _countx(chn[k], ttn_child(tree,n), min);
+        while (item < ID(cld +chn[--k]));
+        if (item == ID(cld +chn[k]))
+          _countx(lvl+1, cld +chn[k], ttn_child(tree, n), min);
         else k++;               /* if the corresp. counter exists, */
         #endif                  /* count the transaction recursively, */
       }                         /* otherwise adapt the child index */
@@ -428,255 +894,816 @@ static void _countx (ISNODE *node, const TTNODE *tree, int min)
   }
 }  /* _countx() */
 
+/*--------------------------------------------------------------------*/
+
+static void _countall (ISLEVEL *lvl, ISNODE *node,
+                       const int *items, int n, SUPP wgt)
+{                               /* --- count trans. on all levels */
+  int    i, k, o;               /* array index, offset, child count */
+  int    *chn;                  /* array of child nodes */
+  ISNODE *cld;                  /* nodes of the next level */
+  ISNODE leaf;                  /* node copy to count own counters */
+
+  assert(lvl && node            /* check the function arguments */
+     && (n >= 0) && (items || (n <= 0)));
+  if (node->parent >= 0) {      /* if not at the root node */
+    leaf = *node; leaf.chcnt = 0;  /* count the node's own counters */
+    _count(lvl, &leaf, items, n, wgt, 1, NULL);
+  }                             /* (root counters are initialized) */
+  k = CHCNT(node);              /* get the number of children */
+  if (k <= 0) return;           /* and check whether there are any */
+  chn = CHN(lvl, node);         /* get the child node array */
+  cld = lvl[1].nodes;           /* and the nodes of the next level */
+  o   = (node->offset >= 0) ? ID(cld +chn[0]) : 0;
+  for ( ; --n > 0; items++) {   /* traverse the transaction's items */
+    if (node->offset >= 0) {    /* if a pure array is used */
+      i = *items -o;            /* compute the child array index */
+      if (i <  0) continue;     /* skip items before the first child */
+      if (i >= k) return; }     /* and abort after the last child */
+    else if (BITMAP(node))      /* if a bitmap is used */
+      i = _bmfind(MAP(lvl, node), *items);
+    else                        /* if an identifier map is used */
+      i = _search(*items, chn, k, cld);
+    if ((i >= 0) && (chn[i] >= 0))  /* if the child node exists, */
+      _countall(lvl+1, cld +chn[i], items+1, n, wgt);
+  }                             /* count the transaction recursively */
+}  /* _countall() */
+
+/*----------------------------------------------------------------------
+  Pair Counting Functions
+----------------------------------------------------------------------*/
+/* The second level of the tree, which is usually the widest level,  */
+/* is counted with a dedicated kernel, which enumerates the pairs of  */
+/* items of each transaction. If the counters for all pairs of items  */
+/* fit into IST_PAIRMEM bytes, an upper triangular matrix is used,    */
+/* the counters of which are added to the tree afterwards. Otherwise, */
+/* if only few pairs are candidates, a hash table maps the pairs that */
+/* have a counter in the tree to the index of this counter, which is  */
+/* then incremented directly. If many pairs are candidates, the nodes */
+/* use pure counter arrays, which are counted as fast by _count().   */
+/* The hash table is subject to the same bound as the matrix (and both */
+/* to the rest of a memory budget, see _pairmem()), so that with a    */
+/* huge number of items the pairs are rather counted in the tree than */
+/* with a helper structure that needs more memory than the tree.      */
+
+#define PAIRHASH(a,b)  (((unsigned int)(a) *0x9e3779b1U) \
+                      ^ ((unsigned int)(b) *0x85ebca6bU))
+
+/*--------------------------------------------------------------------*/
+
+static int _pairitems (ISLEVEL *lvl, ISNODE *node, int *items)
+{                               /* --- get the items of the counters */
+  int i, k, o;                  /* loop variables, first item */
+  int *map;                     /* item bitmap */
+
+  assert(lvl && node && items); /* check the function arguments */
+  if (!BITMAP(node)) {          /* if a pure array or a map is used */
+    for (i = node->size; --i >= 0; )
+      items[i] = _item(lvl, node, i);
+    return node->size;          /* collect the items directly */
+  }                             /* and return their number */
+  map = MAP(lvl, node);         /* get the bitmap and the first item */
+  for (o = map[0], i = k = 0; k < node->size; i++)
+    if (BM_BITS(map, i >> BM_SHIFT) & (1U << (i & BM_MASK)))
+      items[k++] = o+i;         /* collect the items of set bits */
+  return k;                     /* (avoid a search for each index) */
+}  /* _pairitems() */           /* and return the number of items */
+
+/*--------------------------------------------------------------------*/
+
+static int _pairinit (PAIRS *pc, ISTREE *ist, double mem)
+{                               /* --- create a pair counter */
+  int     i, k, n;              /* loop variables, number of items */
+  int     a;                    /* first item of a pair */
+  int     *e;                   /* to traverse the hash table */
+  double  m;                    /* number of item pairs */
+  size_t  z;                    /* size of a counter */
+  ISLEVEL *lvl;                 /* level with the pair item sets */
+  ISNODE  *node;                /* to traverse the nodes */
+
+  assert(pc && ist && (ist->height == 2));
+  pc->lvl  = lvl = ist->lvls +1;/* get the level of the pairs */
+  pc->rows = pc->tab = NULL;    /* and the number of items */
+  pc->mat.cnts = NULL;          /* clear the matrix and hash table */
+  n = ist_itemcnt(ist);         /* create a buffer for the items */
+  pc->items = (int*)malloc((size_t)(n+1) *sizeof(int));
+  if (!pc->items) return -1;    /* of the counters of a node */
+  m = 0.5 *(double)n *(double)(n-1);
+  z = _cwsize[lvl->cw];         /* compute the number of pairs */
+  if (m *(double)z +(double)n *sizeof(int) <= mem) {
+    pc->mat.cw   = lvl->cw;     /* if the matrix fits the budget */
+    pc->mat.ccnt = (int)m;      /* (pair supports are bounded by */
+    pc->mat.cnts = calloc((size_t)m +1, z);     /* item supports) */
+    pc->rows     = (int*)malloc((size_t)(n+1) *sizeof(int));
+    if (pc->mat.cnts && pc->rows) {
+      for (i = 0; i < n; i++)   /* compute the row offsets */
+        pc->rows[i] = (int)(((long)i *(long)(n+n-i-1)) /2) -i-1;
+      return 0;                 /* (the counter of a pair (a,b) */
+    }                           /* with a < b is rows[a] +b) */
+    free(pc->mat.cnts); pc->mat.cnts = NULL;
+    free(pc->rows);     pc->rows     = NULL;
+  }                             /* if many pairs are candidates, */
+  if ((double)lvl->ccnt > 0.25 *m) {      /* the node arrays are */
+    free(pc->items); return -1; }         /* as fast as a hash */
+  for (k = 1; k < lvl->ccnt +lvl->ccnt; k <<= 1)
+    if (k > INT_MAX/6) { free(pc->items); return -1; }
+  if ((double)k *3 *sizeof(int) > mem) {  /* if the hash table */
+    free(pc->items); return -1; }         /* exceeds the bound, */
+                                /* count the pairs in the tree */
+  pc->tab = (int*)malloc((size_t)k *3 *sizeof(int));
+  if (!pc->tab) { free(pc->items); return -1; }
+  pc->mask = k-1;               /* create a hash table with a load */
+  for (e = pc->tab +3*k; e > pc->tab; ) { e -= 3; e[0] = -1; }
+  for (node = lvl->nodes +(i = lvl->cnt); --i >= 0; ) {
+    a = ID(--node);             /* traverse the pair nodes */
+    for (n = _pairitems(lvl, node, pc->items); --n >= 0; ) {
+      k = (int)(PAIRHASH(a, pc->items[n]) & (unsigned int)pc->mask);
+      while (pc->tab[3*k] >= 0) k = (k+1) & pc->mask;
+      e = pc->tab +3*k;         /* find a free entry in the table */
+      e[0] = a; e[1] = pc->items[n]; e[2] = node->cnts +n;
+    }                           /* store the pair and the index */
+  }                             /* of its counter in the table */
+  return 0;                     /* return 'ok' */
+}  /* _pairinit() */
+
+/*--------------------------------------------------------------------*/
+
+static void _pairexit (PAIRS *pc)
+{                               /* --- add and delete pair counters */
+  int     i, k;                 /* loop variables */
+  int     r;                    /* row offset of the first item */
+  ISLEVEL *lvl;                 /* level with the pair item sets */
+  ISNODE  *node;                /* to traverse the nodes */
+
+  assert(pc);                   /* check the function argument */
+  if (!pc->tab) {               /* if a matrix is used */
+    lvl = pc->lvl;              /* traverse the pair nodes */
+    for (node = lvl->nodes +(i = lvl->cnt); --i >= 0; ) {
+      r = pc->rows[ID(--node)]; /* get the row of the first item */
+      for (k = _pairitems(lvl, node, pc->items); --k >= 0; )
+        _inccnt(lvl, node->cnts +k, _getcnt(&pc->mat, r +pc->items[k]));
+    }                           /* add the matrix counters */
+    free(pc->mat.cnts);         /* to the counters of the tree */
+    free(pc->rows);             /* and delete the matrix */
+  }
+  free(pc->tab);                /* delete the hash table */
+  free(pc->items);              /* and the item buffer */
+}  /* _pairexit() */
+
+/*--------------------------------------------------------------------*/
+
+static void _pairinc (PAIRS *pc, int a, int b, SUPP wgt)
+{                               /* --- count a pair of items (a < b) */
+  int k;                        /* index in the hash table */
+  int *e;                       /* hash table entry */
+
+  if (!pc->tab) {               /* if a matrix is used */
+    _inccnt(&pc->mat, pc->rows[a] +b, wgt); return; }
+  k = (int)(PAIRHASH(a, b) & (unsigned int)pc->mask);
+  for (e = pc->tab +3*k; e[0] >= 0; e = pc->tab +3*k) {
+    if ((e[0] == a) && (e[1] == b)) {
+      _inccnt(pc->lvl, e[2], wgt); return; }
+    k = (k+1) & pc->mask;       /* if the pair has a counter, */
+  }                             /* add the weight to this counter, */
+}  /* _pairinc() */             /* otherwise ignore the pair */
+
+/*--------------------------------------------------------------------*/
+
+static void _pairs (PAIRS *pc, const int *items, int n, SUPP wgt)
+{                               /* --- count pairs of a transaction */
+  int       i, k;               /* loop variables */
+  int       r;                  /* row offset of the first item */
+  const int *p;                 /* to traverse the items */
+
+  assert(pc && (items || (n <= 0)));
+  if (!pc->tab) {               /* if a matrix is used */
+    for (i = 0; i < n-1; i++) { /* traverse the first items */
+      r = pc->rows[items[i]];   /* and get their row offsets */
+      for (p = items+i+1, k = n-i-1; --k >= 0; )
+        _inccnt(&pc->mat, r +*p++, wgt);
+    } }                         /* count all pairs in the matrix */
+  else {                        /* if a hash table is used */
+    for (i = 0; i < n-1; i++)   /* traverse the pairs of items */
+      for (k = i+1; k < n; k++) /* and look up their counters */
+        _pairinc(pc, items[i], items[k], wgt);
+  }
+}  /* _pairs() */
+
+/*--------------------------------------------------------------------*/
+
+static void _pairrow (PAIRS *pc, int a, const TTNODE *tree)
+{                               /* --- pair an item with a subtree */
+  int       n;                  /* loop variable */
+  const int *items;             /* items of a transaction suffix */
+
+  assert(pc && tree);           /* check the function arguments */
+  n = ttn_size(tree);           /* get the number of children */
+  if (n < 0) {                  /* if there are no children, */
+    for (items = ttn_items(tree), n = -n; --n >= 0; )
+      _pairinc(pc, a, items[n], ttn_wgt(tree));
+    return;                     /* pair the item with the items */
+  }                             /* of the transaction suffix */
+  while (--n >= 0) {            /* traverse the child nodes */
+    _pairinc(pc, a, ttn_item(tree, n), ttn_wgt(ttn_child(tree, n)));
+    _pairrow(pc, a, ttn_child(tree, n));
+  }                             /* pair the item with the child item */
+}  /* _pairrow() */             /* and recursively with its subtree */
+
+/*--------------------------------------------------------------------*/
+
+static void _pairx (PAIRS *pc, const TTNODE *tree)
+{                               /* --- count pairs of a trans. tree */
+  int n;                        /* loop variable */
+
+  assert(pc && tree);           /* check the function arguments */
+  if (ttn_max(tree) < 2)        /* if the transactions are too short, */
+    return;                     /* abort the recursion */
+  n = ttn_size(tree);           /* get the number of children */
+  if (n < 0) {                  /* if there are no children, */
+    _pairs(pc, ttn_items(tree), -n, ttn_wgt(tree));
+    return;                     /* count the pairs of the */
+  }                             /* transaction suffix */
+  while (--n >= 0) {            /* traverse the child nodes */
+    _pairrow(pc, ttn_item(tree, n), ttn_child(tree, n));
+    _pairx(pc, ttn_child(tree, n));
+  }                             /* pair the child item with its */
+}  /* _pairx() */               /* subtree (all pairs with this item */
+                                /* as the first item are counted in */
+                                /* one matrix row) and recurse */
+
+/*----------------------------------------------------------------------
+  Direct Hashing and Pruning (DHP) Functions
+----------------------------------------------------------------------*/
+/* While a level is counted, all item sets with one item more that are */
+/* contained in a transaction are hashed into a table of bucket       */
+/* counters (only for the item sets of sizes 2 and 3, see DHP_MAX).   */
+/* The bucket counter of an item set is an upper bound of its support */
+/* and thus a candidate for the next level, the bucket counter of     */
+/* which is less than the minimum support, can be discarded. Since    */
+/* the item supports are taken from the item base, the item pairs are */
+/* hashed in a separate pass, in which the tree has height 1.        */
+
+static int _dhpidx (const ISTREE *ist, unsigned int h)
+{                               /* --- get index of a hash bucket */
+  h ^= h >> 15;                 /* mix the higher bits into the lower */
+  return (int)(h % (unsigned int)ist->dhpsz);
+}  /* _dhpidx() */              /* compute the bucket index */
+
+/*--------------------------------------------------------------------*/
+
+static int _dhpinit (ISTREE *ist)
+{                               /* --- prepare the hash buckets */
+  if (!ist->dhp || (ist->height >= DHP_MAX))
+    return 0;                   /* check whether to hash item sets */
+  if (ist->dhpk != ist->height+1) {
+    memset(ist->dhp, 0, (size_t)ist->dhpsz *sizeof(SUPP));
+    ist->dhpk = ist->height+1;  /* clear the bucket counters */
+  }                             /* on the first call for a level */
+  return 1;                     /* return 'hash item sets' */
+}  /* _dhpinit() */
+
+/*--------------------------------------------------------------------*/
+
+static void _dhpadd (ISTREE *ist, const int *pre, int n, int item,
+                     SUPP wgt)
+{                               /* --- hash item sets with an item */
+  int          i, j;            /* loop variables */
+  unsigned int h;               /* hash value of a prefix */
+
+  assert(ist && (pre || (n <= 0)));
+  if (ist->dhpk <= 2) {         /* if to hash item pairs */
+    for (i = n; --i >= 0; )     /* traverse the preceding items */
+      ist->dhp[_dhpidx(ist, DHPFOLD(DHPFOLD(0, pre[i]), item))] += wgt;
+    return;                     /* add the weight to the buckets */
+  }                             /* of the pairs with the item */
+  for (i = n; --i > 0; ) {      /* traverse the pairs of */
+    for (j = i; --j >= 0; ) {   /* preceding items (triplets) */
+      h = DHPFOLD(DHPFOLD(DHPFOLD(0, pre[j]), pre[i]), item);
+      ist->dhp[_dhpidx(ist, h)] += wgt;
+    }                           /* add the weight to the buckets */
+  }                             /* of the triplets with the item */
+}  /* _dhpadd() */
+
+/*--------------------------------------------------------------------*/
+
+static void _dhpt (ISTREE *ist, const int *items, int n, SUPP wgt)
+{                               /* --- hash item sets of a trans. */
+  int i;                        /* loop variable */
+
+  assert(ist && (items || (n <= 0)));
+  for (i = ist->dhpk-1; i < n; i++)
+    _dhpadd(ist, items, i, items[i], wgt);
+}  /* _dhpt() */                /* hash the sets ending with an item */
+
+/*--------------------------------------------------------------------*/
+
+static void _dhpx (ISTREE *ist, const TTNODE *tree, int *path, int k)
+{                               /* --- hash item sets of a trans. tree */
+  int       i, n;               /* loop variables */
+  const int *items;             /* items of a transaction suffix */
+
+  assert(ist && tree && path);  /* check the function arguments */
+  if (ttn_max(tree) +k < ist->dhpk)
+    return;                     /* skip too short transactions */
+  n = ttn_size(tree);           /* get the number of children */
+  if (n < 0) {                  /* if there are no children, */
+    items = ttn_items(tree);    /* hash the transaction suffix */
+    for (i = 0; i < -n; i++) {  /* with the path to the node */
+      _dhpadd(ist, path, k+i, items[i], ttn_wgt(tree));
+      path[k+i] = items[i];     /* hash the sets ending with */
+    }                           /* the suffix item and extend */
+    return;                     /* the path by this item */
+  }
+  while (--n >= 0) {            /* traverse the child nodes */
+    path[k] = ttn_item(tree, n);/* hash the sets ending with */
+    _dhpadd(ist, path, k, path[k], ttn_wgt(ttn_child(tree, n)));
+    _dhpx(ist, ttn_child(tree, n), path, k+1);
+  }                             /* the child item and */
+}  /* _dhpx() */                /* process the subtree recursively */
 
 
-static int _needed (ISNODE *node)
+
+static int _needed (ISLEVEL *lvl, ISNODE *node)
 {                               /* --- recursively check nodes */
-  int    i, r;                  /* array index, check result */
-  ISNODE **chn;                 /* child node array */
+  int i, r;                     /* array index, check result */
+  int *chn;                     /* child node array */
 
-  assert(node);                 /* check the function argument */
-  if (node->chcnt == 0) return -1; /* do not skip new leaves, */
+  assert(lvl && node);          /* check the function arguments */
+  if ((node->chcnt == 0)        /* do not skip new leaves */
+  ||  lvl->spec) return -1;     /* or uncounted levels, */
   if (node->chcnt <= 0) return  0; /* but skip marked subtrees */
-  i   = (node->offset < 0) ? node->size : PAD(node->size);
-  chn = (ISNODE**)(node->cnts +node->size +i);
+  chn = CHN(lvl, node);         /* get the child node array */
   for (r = 0, i = node->chcnt; --i >= 0; )
-    if (chn[i]) r |= _needed(chn[i]);
+    if (chn[i] >= 0) r |= _needed(lvl+1, lvl[1].nodes +chn[i]);
   if (r) return -1;             /* recursively check all children */
   node->chcnt |= F_SKIP;        /* set the skip flag if possible */
   return 0;                     /* return 'subtree can be skipped' */
 }  /* _needed() */
 
 
-static int _used (ISNODE *node, int *marks, int supp)
+static int _used (ISLEVEL *lvl, ISNODE *node, int *marks, SUPP supp)
 {                               /* --- recursively check item usage */
-  int    i, k, r = 0;           /* array index, map size, result */
-  int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* child node array */
-
-  assert(node && marks);        /* check the function arguments */
-  if (node->offset >= 0) {      /* if a pure array is used */
+  int i, r = 0;                 /* array index, result */
+  int c;                        /* index of the first counter */
+  int *map;                     /* item identifier map */
+  int *chn;                     /* child node array */
+
+  assert(lvl && node && marks); /* check the function arguments */
+  c = node->cnts;               /* get the counter position */
+  if ((node->offset >= 0)       /* if a pure array */
+  ||  BITMAP(node)) {           /* or a bitmap is used */
     if (node->chcnt == 0) {     /* if this is a new node (leaf) */
-      k = node->offset;         /* get the index offset */
       for (i = node->size; --i >= 0; ) {
-        if (node->cnts[i] >= supp)
-          marks[k+i] = r = 1;   /* mark items in set that satisfy */
-      } }                       /* the minimum support criterion */
+        if (_getcnt(lvl, c+i) >= supp)
+          marks[_item(lvl, node, i)] = r = 1;
+      } }                       /* mark items in set that satisfy */
+                                /* the minimum support criterion */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
+      chn = CHN(lvl, node);     /* get the child node array */
       for (i = node->chcnt; --i >= 0; )
-        if (chn[i]) r |= _used(chn[i], marks, supp);
+        if (chn[i] >= 0)
+          r |= _used(lvl+1, lvl[1].nodes +chn[i], marks, supp);
     } }                         /* recursively process all children */
   else {                        /* if an identifer map is used */
     if (node->chcnt == 0) {     /* if this is a new node */
-      map = node->cnts +node->size;
+      map = MAP(lvl, node);     /* get the identifier map */
       for (i = node->size; --i >= 0; ) {
-        if (node->cnts[i] >= supp)
+        if (_getcnt(lvl, c+i) >= supp)
           marks[map[i]] = r = 1;/* mark items in set that satisfies */
       } }                       /* the minimum support criterion */
     else if (node->chcnt > 0) { /* if there are child nodes */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
+      chn = CHN(lvl, node);     /* get the child node array */
       for (i = node->chcnt; --i >= 0; )
-        r |= _used(chn[i], marks, supp);
-    }                           /* get the child node array and */
-  }                             /* recursively process all children */
-  if ((r != 0) && node->parent) /* if the check succeeded, mark */
-    marks[ID(node)] = 1;        /* the item associated with the node */
-  return r;                     /* return the check result */
+        r |= _used(lvl+1, lvl[1].nodes +chn[i], marks, supp);
+    }                           /* recursively process all children */
+  }
+  if ((r != 0) && (node->parent >= 0)) /* if the check succeeded, */
+    marks[ID(node)] = 1;        /* mark the item associated with */
+  return r;                     /* the node, then return the result */
 }  /* _used() */
 
 
 
-static void _mark (ISNODE *node, int *items, int n, int supp)
+static void _mark (ISTREE *ist, ISLEVEL *lvl, ISNODE *node,
+                   const int *items, int n, SUPP supp, unsigned int h)
 {                               /* --- mark an item set */
-  int    i, k;                  /* array index, map size */
-  int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* child node array */
+  int  i, c = -1;               /* array index, counter index */
+  int  *chn;                    /* child node array */
+  SUPP s;                       /* support of the item set */
 
-  assert(node                   /* check the function arguments */
+  assert(lvl && node            /* check the function arguments */
      && (n >= 0) && (items || (n <= 0)));
-  while (--n > 0) {             /* follow the set/path from the node */
-    if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-      i   = *items++ -ID(chn[0]); }
-    else {                      /* if an identifier map is used */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
-      i   = _search(*items++, chn, CHCNT(node));
-    }                           /* get the proper child array index */
-    node = chn[i];              /* go to the corresponding child */
-  }
-  if (node->offset >= 0)        /* if a pure array is used, */
-    i   = *items -node->offset; /* compute the counter index */
-  else {                        /* if an identifier map is used */
-    map = node->cnts +(k = node->size);
-    i   = int_bsearch(*items, map, k);
-  }                             /* search for the proper index */
+  if ((n > 1) && _hready(ist, lvl +n-1)
+  &&  ((c = _hfind(lvl +n-1, h, node, items, n)) >= 0)) {
+    lvl += n-1; n = 0; }        /* try to find the set with the table */
+  while (--n > 0) {             /* (h is the hash value of the set) */
+    chn = CHN(lvl, node);       /* get the child node array */
+    if (node->offset >= 0)      /* if a pure array is used */
+      i = *items++ -ID(lvl[1].nodes +chn[0]);
+    else if (BITMAP(node))      /* if a bitmap is used */
+      i = _bmfind(MAP(lvl, node), *items++);
+    else                        /* if an identifier map is used */
+      i = _search(*items++, chn, CHCNT(node), lvl[1].nodes);
+    node = (++lvl)->nodes +chn[i];
+  }                             /* go to the corresponding child */
+  if (c < 0) c = node->cnts +_index(lvl, node, *items);
+  s  = _getcnt(lvl, c);         /* and the item set support */
   if ((supp < 0)                /* if to clear unconditionally */
-  ||  (node->cnts[i] == supp))  /* or the support is the same */
-    node->cnts[i] |= F_SKIP;    /* mark the item set by the sign bit */
+  ||  (s == supp))              /* or the support is the same, */
+    _skip(lvl, c);              /* mark the set with the skip flag */
 }  /* _mark() */
 
 
 
-static void _marksub (ISTREE *ist, ISNODE *node, int index, int supp)
+static void _marksub (ISTREE *ist, ISLEVEL *lvl, ISNODE *node,
+                      int index, SUPP supp)
 {                               /* --- mark all n-1 subsets */
-  int i;                        /* next item, loop variable */
-  int *items;                   /* (partial) item set */
+  int    i;                     /* next item, loop variable */
+  int    *items;                /* (partial) item set */
+  ISNODE *par;                  /* parent of the current node */
+  unsigned int h;               /* hash value of the item set */
 
-  if (node->offset >= 0) i = node->offset +index;
-  else                   i = node->cnts[node->size +index];
+  i     = _item(lvl, node, index);
+  h     = _hpath(lvl, node) +_hmix(i);
   items = ist->buf +ist->maxht; /* get and store the first two items */
-  *--items = i;        _mark(node->parent, items, 1, supp);
-  *--items = ID(node); _mark(node->parent, items, 1, supp);
+  par   = PARENT(lvl, node); lvl--;
+  *--items = i;        _mark(ist, lvl, par, items, 1, supp, 0);
+  *--items = ID(node); _mark(ist, lvl, par, items, 1, supp, 0);
   i = 2;                        /* mark counters in parent node */
-  for (node = node->parent; node->parent; node = node->parent) {
-    _mark(node->parent, items, i, supp);
-    *--items = ID(node); i++;   /* climb up the tree and mark */
-  }                             /* counters for all n-1 subsets */
+  for (node = par; node->parent >= 0; node = par, lvl--) {
+    par = PARENT(lvl, node);    /* climb up the tree and mark */
+    _mark(ist, lvl-1, par, items, i, supp, h -_hmix(ID(node)));
+    *--items = ID(node); i++;   /* counters for all n-1 subsets */
+  }                             /* (the subset lacks the node's item) */
 }  /* _marksub() */
 
 
 
-static ISNODE* _child (ISTREE *ist, ISNODE *node, int index, int spx)
-{                               /* --- create child node (extend set) */
-  int    i, k, n;               /* loop variables, counters */
-  ISNODE *curr;                 /* to traverse the path to the root */
-  int    item, cnt;             /* item identifier, number of items */
-  int    *set;                  /* next (partial) item set to check */
-  int    body;                  /* enough support for a rule body */
-  int    hdonly;                /* whether head only item on path */
-  int    app;                   /* appearance flags of an item */
-  int    s_set;                 /* support of an item set */
-
-  assert(ist && node            /* check the function arguments */
+static void* _enlarge (void *array, int *size, int need, size_t unit)
+{                               /* --- enlarge a level array */
+  int n;                        /* new array size */
+
+  assert(size && (unit > 0));   /* check the function arguments */
+  n = *size;                    /* get the current array size */
+  if (need <= n) return array;  /* if the array is large enough, abort */
+  n += (n > BLKSIZE) ? n >> 1 : BLKSIZE;
+  if (n < need) n = need;       /* compute the new array size */
+  array = realloc(array, (size_t)n *unit);
+  if (array) *size = n;         /* enlarge the array and */
+  return array;                 /* note the new array size */
+}  /* _enlarge() */
+
+
+
+static unsigned int _dhpset (const int *set, int n)
+{                               /* --- compute hash value of a set */
+  unsigned int h = 0;           /* hash value of the item set */
+  while (--n >= 0) h = DHPFOLD(h, *set++);
+  return h;                     /* fold the items into the value */
+}  /* _dhpset() */
+
+/*--------------------------------------------------------------------*/
+
+static int _cands (ISTREE *ist, ISLEVEL *lvl, ISNODE *node,
+                   int index, SUPP spx)
+{                               /* --- collect candidates of a child */
+  int     i, k, n;              /* loop variables, counters */
+  ISLEVEL *l;                   /* level of the current node */
+  ISNODE  *curr;                /* to traverse the path to the root */
+  int     item, cnt;            /* item identifier, number of items */
+  int     *set;                 /* next (partial) item set to check */
+  int     c, o;                 /* counter positions */
+  int     spec;                 /* whether supports are not counted */
+  int     body;                 /* enough support for a rule body */
+  int     hdonly;               /* whether head only item on path */
+  int     app;                  /* appearance flags of an item */
+  int     tab;                  /* whether to use the lookup table */
+  unsigned int h = 0, hc;       /* hash values of item sets */
+  SUPP    s_set = 0;            /* support of an item set */
+
+  assert(ist && lvl && node     /* check the function arguments */
      && (index >= 0) && (index < node->size));
 
   /* --- initialize --- */
-  s_set = node->cnts[index];    /* get support of item set to extend */
-  if ((s_set <  ist->supp)      /* if the support is insufficient */
-  ||  (s_set >= spx))           /* or item is a perfect extension, */
-    return NULL;                /* abort (do not create a child) */
-  if (node->offset >= 0) item = node->offset +index; 
-  else                   item = node->cnts[node->size +index];
-  app = ib_getapp(ist->base, item);  /* get item id. and app. flag */
+  if ((node->parent < 0)        /* if outside the range of subtrees */
+  &&  ((index < ist->beg) || (index >= ist->end)))
+    return 0;                   /* to grow, do not create a child */
+  c    = node->cnts;            /* get the counter position */
+  spec = lvl->spec;             /* and the speculation flag */
+  if (!spec) {                  /* if the supports are known */
+    s_set = _getcnt(lvl, c +index);  /* get support of set to extend */
+    if ((s_set <  ist->supp)    /* if the support is insufficient */
+    ||  (s_set >= spx))         /* or item is a perfect extension, */
+      return 0;                 /* abort (do not create a child) */
+  }
+  item = _item(lvl, node, index);
+  app  = ib_getapp(ist->base, item); /* get item id. and app. flag */
   if ((app == APP_NONE)         /* do not extend an item to ignore */
   || ((app == APP_HEAD) && (HDONLY(node))))
-    return NULL;                /* do not combine two head only items */
+    return 0;                   /* do not combine two head only items */
   hdonly = (app == APP_HEAD) || HDONLY(node);
-  if ((ist->eval   >  IST_NONE) /* if to prune with evaluation */
+  if (!spec                     /* if the supports are known */
+  &&  (ist->eval   >  IST_NONE) /* and to prune with evaluation */
   &&  (ist->height >= ist->prune)) {
     ist->index = index;         /* note index for aggregation */
     if (_aggregate(ist) < ist->minval) {
-      node->cnts[index] |= F_SKIP; return NULL; }
+      _setcnt(lvl, c +index, s_set | S_SKIP); return 0; }
   }                             /* check whether item set qualifies */
-  body = (s_set >= ist->rule)   /* if the set has enough support for */
-       ? 1 : 0;                 /* a rule body, set the body flag */
+  body = (spec || (s_set >= ist->rule))   /* if the set has enough */
+       ? 1 : 0;                 /* support for a rule body, set flag */
   ist->buf[ist->maxht-2] = item;/* init. set for support checks */
+  tab = _hready(ist, lvl);      /* check for a subset lookup table */
+  if (tab) h = _hpath(lvl, node) +_hmix(item);
 
   /* --- check candidates --- */
   for (n = 0, i = index; ++i < node->size; ) {
-    if (node->offset >= 0) k = node->offset +i;
-    else                   k = node->cnts[node->size +i];
-    app = ib_getapp(ist->base, k); /* traverse the candidate items */
+    k   = _item(lvl, node, i);  /* traverse the candidate items */
+    app = ib_getapp(ist->base, k);
     if ((app == APP_NONE) || (hdonly && (app == APP_HEAD)))
       continue;                 /* skip sets with two head only items */
-    s_set = node->cnts[i];      /* traverse the candidate items */
-    if ((s_set <  ist->supp)    /* if set support is insufficient */
-    ||  (s_set >= spx))         /* or item is a perfect extension, */
-      continue;                 /* ignore the corresponding candidate */
-    body &= 1;                  /* restrict body flags to set support */
-    if (s_set >= ist->rule)     /* if set support is sufficient for */
-      body |= 2;                /* a rule body, set the body flag */ 
+    if (!spec) {                /* if the supports are known */
+      s_set = _getcnt(lvl,c+i); /* traverse the candidate items */
+      if ((s_set <  ist->supp)  /* if set support is insufficient */
+      ||  (s_set >= spx))       /* or item is a perfect extension, */
+        continue;               /* ignore the corresp. candidate */
+      body &= 1;                /* restrict body flags to set support */
+      if (s_set >= ist->rule)   /* if set support is sufficient for */
+        body |= 2;              /* a rule body, set the body flag */
+    }
     set    = ist->buf +ist->maxht -(cnt = 2);
     set[1] = k;                 /* add the candidate item to the set */
-    for (curr = node; curr->parent; curr = curr->parent) {
-      s_set = _getsupp(curr->parent, set, cnt);
-      if (s_set <  ist->supp)   /* get the item set support and */
-        break;                  /* if it is too low, abort the loop */
-      if (s_set >= ist->rule)   /* if some subset has enough support */
-        body |= 4;              /* for a rule body, set the body flag */
-      *--set = ID(curr); cnt++; /* add id of current node to the set */
-    }                           /* and adapt the number of items */
-    if (!curr->parent && body)  /* if subset support is high enough */
-      ist->map[n++] = k;        /* for a full rule and a rule body, */
-  }                             /* note the item identifier */
-  if (n <= 0) return NULL;      /* if no child is needed, abort */
+    hc     = h +_hmix(k);       /* and compute the set's hash value */
+    for (curr = node, l = lvl; curr->parent >= 0; l--) {
+      if ((l-1 == ist->lvls)    /* if the subset lies in a subtree */
+      &&  (set[0] >= ist->end)) /* that is not grown, use the support */
+        s_set = _getcnt(ist->lvls, set[0]);   /* of its first item */
+      else if (tab) {           /* if there is a lookup table */
+        o = _hfind(lvl, hc -_hmix(ID(curr)), PARENT(l, curr), set, cnt);
+        s_set = (o < 0) ? S_SKIP : _getcnt(lvl, o); }
+      else                      /* (all n-1 subsets are on this level) */
+        s_set = _getsupp(l-1, PARENT(l, curr), set, cnt);
+      if (!spec)                /* ignore skip flags (they are only */
+        s_set = COUNT(s_set);   /* set on processed, earlier nodes) */
+      if (s_set < (spec ? 0 : ist->supp))
+        break;                  /* if the support is too low (or the */
+      if (s_set >= ist->rule)   /* subset does not exist), abort */
+        body |= 4;              /* if some subset has enough support */
+      *--set = ID(curr); cnt++; /* for a rule body, set the body flag */
+      curr = PARENT(l, curr);   /* add id of current node to the set */
+    }                           /* and go to the parent node */
+    if ((curr->parent < 0) && body) { /* if subset support is high */
+      if ((cnt == ist->dhpk)    /* enough for a full rule and */
+      &&  (ist->dhp[_dhpidx(ist, _dhpset(set, cnt))] < ist->supp)) {
+        #ifdef BENCH            /* if the hash bucket counter shows */
+        ist->dhprn++;           /* that the support is too low, */
+        #endif                  /* count the pruned counter and */
+        continue;               /* skip the candidate, otherwise */
+      }                         /* (for a rule body) note the item */
+      ist->map[n++] = k;        /* (note that the buffer 'set' holds */
+    }                           /* the full candidate item set after */
+  }                             /* all subsets have been checked) */
   #ifdef BENCH                  /* if benchmark version, */
   ist->scnec += n;              /* sum the necessary counters */
   #endif
+  return n;                     /* return the number of candidates */
+}  /* _cands() */
 
-  /* --- decide on node structure --- */
-  k = ist->map[n-1] -ist->map[0] +1;
-  if (n+n >= k) n = k;          /* use a pure array if it is small, */
-  else          k = n+n;        /* otherwise use an identifier map */
-  #ifdef ARCH64                 /* if 64 bit architecture, */
-  if (n == k) n = k += PAD(k);  /* pad to an even number of counters */
-  #endif
+/*--------------------------------------------------------------------*/
+
+static SUPP _spx (ISTREE *ist, ISLEVEL *lvl, ISNODE *node)
+{                               /* --- get supp. for perfect ext. */
+  int k;                        /* item of the node */
+
+  if (!(ist->mode & IST_PERFECT)) return SUPP_MAX;
+  if (node->parent < 0)           return COUNT(ist->wgt);
+  k = ID(node);                 /* get the support of the node's set */
+  return COUNT(_getsupp(lvl-1, PARENT(lvl, node), &k, 1));
+}  /* _spx() */
+
+/*--------------------------------------------------------------------*/
+
+static int _layout (ISTREE *ist, size_t z, int *n, int *m)
+{                               /* --- decide on node structure */
+  int    k;                     /* size of the item range */
+  size_t pure, bmap, imap;      /* memory costs of the structures */
+
+  k    = ist->map[*n-1] -ist->map[0] +1;
+  *m   = 2 +2*((k +BM_MASK) >> BM_SHIFT);
+  pure = (size_t)k *z;          /* compute the memory needed for */
+  imap = (size_t)*n *(z +sizeof(int));  /* the three structures */
+  bmap = (size_t)*n *z +(size_t)*m *sizeof(int);
+  if (pure <= imap) {           /* use a pure array if it is not */
+    *n = k; *m = 0; return 0; } /* larger than an identifier map */
+  if (bmap <= imap) return 1;   /* (it has the fastest access), */
+  *m = *n;          return 0;   /* otherwise use the smaller one */
+}  /* _layout() */              /* of a bitmap and an identifier map */
+
+/*--------------------------------------------------------------------*/
+
+static int _child (ISTREE *ist, ISLEVEL *lvl, ISLEVEL *cl,
+                   ISNODE *node, int index, SUPP spx)
+{                               /* --- create child node (extend set) */
+  int     i, k, n, m;           /* loop variables, counters */
+  ISNODE  *curr;                /* new child node */
+  int     item;                 /* item identifier */
+  int     *map;                 /* identifier map or bitmap */
+  int     bits;                 /* whether to use a bitmap */
+  int     hdonly;               /* whether head only item on path */
+  void    *p;                   /* buffer for reallocation */
+
+  n = _cands(ist, lvl, node, index, spx);
+  if (n <= 0) return 0;         /* if no child is needed, abort */
+  item   = _item(lvl, node, index);   /* get the item identifier */
+  hdonly = HDONLY(node) || (ib_getapp(ist->base, item) == APP_HEAD);
+  bits   = _layout(ist, _cwsize[cl->cw], &n, &m);
   #ifdef BENCH                  /* if benchmark version, */
   ist->sccnt += n;              /* sum the number of counters */
-  if (n != k) ist->mapsz += n;  /* sum the size of the maps */
+  ist->mapsz += m;              /* sum the size of the maps */
   ist->ndcnt++;                 /* count the node to be created */
   #endif
 
   /* --- create child --- */
-  curr = (ISNODE*)malloc(sizeof(ISNODE) +(k-1) *sizeof(int));
-  if (!curr) return (void*)-1;  /* create a child node */
-  if (hdonly) item |= F_HDONLY; /* set the head only flag and */
-  curr->id    = item;           /* initialize the item identifier */
-  curr->chcnt = 0;              /* there are no children yet */
-  curr->size  = n;              /* set size of counter array */
-  if (n == k)                   /* if to use a pure array, */
+  p  = _enlarge(cl->nodes, &cl->nsz, cl->cnt  +1, sizeof(ISNODE));
+  if (!p) return -1;            /* enlarge the node array */
+  cl->nodes = (ISNODE*)p;       /* of the child level */
+  p  = _enlarge(cl->cnts,  &cl->csz, cl->ccnt +n, _cwsize[cl->cw]);
+  if (!p) return -1;            /* enlarge the counter array */
+  cl->cnts  = p;                /* of the child level */
+  if (m > 0) {                  /* if to use a map or a bitmap */
+    p = _enlarge(cl->map,  &cl->msz, cl->mcnt +m, sizeof(int));
+    if (!p) return -1;          /* enlarge the identifier map */
+    cl->map = (int*)p;          /* array of the child level */
+  }
+  curr = cl->nodes +cl->cnt++;  /* get the new child node */
+  if (hdonly) item |= F_HDONLY; /* set the head only flag */
+  if (bits)   item |= F_BITMAP; /* and the bitmap flag and */
+  curr->id     = item;          /* initialize the item identifier */
+  curr->parent = (int)(node -lvl->nodes);
+  curr->chcnt  = curr->chn = 0; /* there are no children yet */
+  curr->size   = n;             /* set size of counter array */
+  curr->cnts   = cl->ccnt;      /* and its position in the level */
+  memset((char*)cl->cnts +(size_t)cl->ccnt *_cwsize[cl->cw], 0,
+         (size_t)n *_cwsize[cl->cw]);
+  cl->ccnt += n;                /* clear all counters of the node */
+  if (m <= 0)                   /* if to use a pure array, */
     curr->offset = ist->map[0]; /* note the first item as an offset */
+  else if (bits) {              /* if to use a bitmap, */
+    curr->offset = -1-cl->mcnt; /* note its position as the offset */
+    map = cl->map +cl->mcnt; cl->mcnt += m;
+    memset(map, 0, (size_t)m *sizeof(int));
+    map[0] = ist->map[0];       /* store the first item and */
+    map[1] = (m-2) >> 1;        /* the number of bitmap words */
+    for (i = 0; i < n; i++) {   /* traverse the items */
+      k = ist->map[i] -map[0];  /* and set their bits */
+      BM_BITS(map, k >> BM_SHIFT) |= 1u << (k & BM_MASK);
+    }                           /* (bitmap over the item range), */
+    _bmrank(map); }             /* then compute the word ranks */
   else {                        /* if to use an identifier map, */
-    curr->offset = -1;          /* use the offset as an indicator */
-    for (set = curr->cnts +n +(i = n); --i >= 0; )
-      *--set = ist->map[i];     /* copy the identifier map */
-  }                             /* from the buffer to the node */
-  for (set = curr->cnts +(i = n); --i >= 0; )
-    *--set = 0;                 /* clear all counters of the node */
-  return curr;                  /* return pointer to created child */
+    curr->offset = -1-cl->mcnt; /* note its position as the offset */
+    for (map = cl->map +(cl->mcnt += (i = curr->size)); --i >= 0; )
+      *--map = ist->map[i];     /* copy the identifier map */
+  }                             /* from the buffer to the level */
+  return 1;                     /* return 'child created' */
 }  /* _child() */
 
-static void _cleanup (ISTREE *ist)
+
+
+static void _shrink (ISLEVEL *lvl)
+{                               /* --- shrink level arrays to size */
+  void *p;                      /* buffer for reallocation */
+
+  assert(lvl);                  /* check the function argument */
+  if ((lvl->cnt  < lvl->nsz) && (lvl->cnt  > 0)
+  &&  (p = realloc(lvl->nodes, (size_t)lvl->cnt  *sizeof(ISNODE)))) {
+    lvl->nodes = (ISNODE*)p; lvl->nsz = lvl->cnt;  }
+  if ((lvl->ccnt < lvl->csz) && (lvl->ccnt > 0)
+  &&  (p = realloc(lvl->cnts,  (size_t)lvl->ccnt *_cwsize[lvl->cw]))) {
+    lvl->cnts  = p;          lvl->csz = lvl->ccnt; }
+  if ((lvl->mcnt < lvl->msz) && (lvl->mcnt > 0)
+  &&  (p = realloc(lvl->map,   (size_t)lvl->mcnt *sizeof(int)))) {
+    lvl->map   = (int*)p;    lvl->msz = lvl->mcnt; }
+  if ((lvl->kcnt < lvl->ksz) && (lvl->kcnt > 0)
+  &&  (p = realloc(lvl->chn,   (size_t)lvl->kcnt *sizeof(int)))) {
+    lvl->chn   = (int*)p;    lvl->ksz = lvl->kcnt; }
+}  /* _shrink() */              /* (release the reserve space) */
+
+
+
+static void _clear (ISLEVEL *lvl)
+{                               /* --- delete the arrays of a level */
+  assert(lvl);                  /* check the function argument */
+  if (lvl->nodes) free(lvl->nodes);
+  if (lvl->cnts)  free(lvl->cnts);
+  if (lvl->map)   free(lvl->map);
+  if (lvl->chn)   free(lvl->chn);
+  if (lvl->hash)  free(lvl->hash);
+  memset(lvl, 0, sizeof(ISLEVEL));
+}  /* _clear() */
+
+
+
+static size_t _lvlsz (ISLEVEL *lvl)
+{                               /* --- get the memory of a level */
+  return (size_t)lvl->nsz *sizeof(ISNODE)
+       + (size_t)lvl->csz *_cwsize[lvl->cw]
+       + (size_t)(lvl->msz +lvl->ksz) *sizeof(int)
+       + (size_t)((lvl->hsz > 0) ? 3*lvl->hsz : 0) *sizeof(int);
+}  /* _lvlsz() */               /* sum the sizes of the level arrays */
+
+
+
+static size_t _memsz (ISTREE *ist)
+{                               /* --- get the memory of a tree */
+  int     i;                    /* loop variable */
+  size_t  n;                    /* number of bytes */
+
+  assert(ist);                  /* check the function argument */
+  n = sizeof(ISTREE) +(size_t)ist->maxht *(sizeof(ISLEVEL)+sizeof(int));
+  for (i = ist->height; --i >= 0; )
+    n += _lvlsz(ist->lvls +i);  /* sum the sizes of all levels */
+  return n;                     /* return the number of bytes */
+}  /* _memsz() */
+
+/*--------------------------------------------------------------------*/
+
+static double _pairmem (ISTREE *ist)
+{                               /* --- get memory for pair counting */
+  size_t z;                     /* memory used by the tree */
+
+  assert(ist);                  /* check the function argument */
+  if (ist->maxmem <= 0) return (double)IST_PAIRMEM;
+  z = _memsz(ist);              /* if there is no budget, use bound, */
+  if (z >= ist->maxmem) return 0;   /* otherwise the smaller of */
+  z = ist->maxmem -z;           /* the bound and the rest of the */
+  return (z < IST_PAIRMEM) ? (double)z : (double)IST_PAIRMEM;
+}  /* _pairmem() */             /* budget of the tree */
+
+/*--------------------------------------------------------------------*/
+#ifdef BENCH
+
+static size_t _cntsz (ISTREE *ist)
+{                               /* --- get the memory of the counters */
+  int     i;                    /* loop variable */
+  size_t  n;                    /* number of bytes */
+
+  assert(ist);                  /* check the function argument */
+  for (n = 0, i = ist->height; --i >= 0; )
+    n += (size_t)ist->lvls[i].ccnt *_cwsize[ist->lvls[i].cw];
+  return n;                     /* sum the bytes of the used counters */
+}  /* _cntsz() */               /* (without the reserve space) */
+
+#endif
+
+
+static void _cleanup (ISTREE *ist, int kcnt)
 {                               /* --- clean up on error */
-  ISNODE *node, *t;             /* to traverse the nodes */
+  int     i;                    /* loop variable */
+  ISLEVEL *lvl;                 /* deepest level of the tree */
 
   assert(ist);                  /* check the function argument */
-  for (node = ist->lvls[ist->height]; node; ) {
-    t = node; node = node->succ; free(t); }
-  ist->lvls[ist->height] = NULL;/* delete all created nodes */
-  for (node = ist->lvls[ist->height -1]; node; node = node->succ)
-    node->chcnt = 0;            /* clear the child node counters */
-}  /* _cleanup() */             /* of the deepest nodes in the tree */
+  _clear(ist->lvls +ist->height);  /* delete all created nodes */
+  lvl = ist->lvls +ist->height -1;
+  for (i = lvl->cnt; --i >= 0; )/* clear the child node counters */
+    lvl->nodes[i].chcnt = 0;    /* of the deepest nodes in the tree */
+  lvl->kcnt = kcnt;             /* and remove the added child indices */
+}  /* _cleanup() */
 
 
 
 ISTREE* ist_create (ITEMBASE *base, int mode,
-                    int supp, int smax, double conf)
+                    SUPP supp, SUPP smax, double conf)
 {                               /* --- create an item set tree */
-  int    cnt, n;                /* number of items, buffer */
-  ISTREE *ist;                  /* created item set tree */
-  ISNODE *root;                 /* root node of the tree */
+  int     i, cnt;               /* loop variable, number of items */
+  SUPP    max;                  /* maximal support of an item */
+  ISTREE  *ist;                 /* created item set tree */
+  ISLEVEL *lvl;                 /* level of the root node */
+  ISNODE  *root;                /* root node of the tree */
 
   assert(base                   /* check the function arguments */
      && (supp >= 0) && (conf >= 0) && (conf <= 1));
 
-  /* --- allocate memory --- */ 
+  /* --- allocate memory --- */
   cnt = ib_cnt(base);           /* get the number of items */
   ist = (ISTREE*)malloc(sizeof(ISTREE));
   if (!ist) return NULL;        /* allocate the tree body */
-  ist->lvls = (ISNODE**)malloc(BLKSIZE *sizeof(ISNODE*));
+  ist->lvls = (ISLEVEL*)calloc(BLKSIZE, sizeof(ISLEVEL));
   if (!ist->lvls) {                  free(ist); return NULL; }
   ist->buf  = (int*)    malloc(BLKSIZE *sizeof(int));
   if (!ist->buf)  { free(ist->lvls); free(ist); return NULL; }
-  ist->map  = (int*)    malloc(cnt *sizeof(int));
+  ist->map  = (int*)    malloc((cnt+1) *sizeof(int));
   if (!ist->map)  { free(ist->buf);
                     free(ist->lvls); free(ist); return NULL; }
-  n = cnt +PAD(cnt);            /* compute the array size */
-  ist->lvls[0] = ist->curr =    /* allocate a root node */
-  root = (ISNODE*)calloc(1, sizeof(ISNODE) +(n-1) *sizeof(int));
-  if (!root)      { free(ist->map);  free(ist->buf);
-                    free(ist->lvls); free(ist); return NULL; }
+  max = ib_getwgt(base);        /* find the maximal support */
+  for (i = cnt; --i >= 0; )     /* (the counters of the root level */
+    if (ib_getfrq(base, i) > max) max = ib_getfrq(base, i);
+  lvl = ist->lvls;              /* are the item frequencies) */
+  lvl->cw    = _width(max);     /* and choose the counter width */
+  lvl->nodes = root = (ISNODE*)malloc(sizeof(ISNODE));
+  lvl->cnts  = malloc((size_t)(cnt+1) *_cwsize[lvl->cw]);
+  if (!lvl->nodes || !lvl->cnts) { _clear(lvl); free(ist->map);
+    free(ist->buf); free(ist->lvls); free(ist); return NULL; }
+  lvl->cnt = lvl->nsz = 1;      /* the root level has a single node */
+  lvl->ccnt = lvl->csz = cnt;   /* with a counter for each item */
 
   /* --- initialize structures --- */
   ist->base   = base;           /* copy parameters to the structure */
@@ -684,9 +1711,14 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   ist->wgt    = ib_getwgt(base);
   ist->maxht  = BLKSIZE;
   ist->height = 1;
+  ist->dhp    = NULL; ist->dhpsz = ist->dhpk = 0;
+  ist->tops   = NULL; ist->topk  = ist->tcnt = ist->tlvl = 0;
+  ist->thcnt  = 1;
+  ist->maxmem = 0;
+  ist->beg    = 0; ist->end = cnt;
   ist->rule   = (supp > 0)         ? supp : 1;
   ist->smax   = (smax > ist->rule) ? smax : ist->rule;
-  if (!(mode & APP_HEAD)) supp = (int)ceil(conf *supp);
+  if (!(mode & APP_HEAD)) supp = (SUPP)ceil(conf *(double)supp);
   ist->supp   = (supp > 0)         ? supp : 1;
   ist->conf   = conf *(1.0-DBL_EPSILON);
   /* Multiplying the minimum confidence with (1.0-DBL_EPSILON) takes */
@@ -699,15 +1731,20 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
   ist->ndcnt  = 1;   ist->ndprn = ist->mapsz = 0;
   ist->sccnt  = ist->scnec = cnt; ist->scprn = 0;
   ist->cpcnt  = ist->cpnec =      ist->cpprn = 0;
+  ist->dhprn  = 0;
   #endif                        /* initialize the benchmark variables */
+  root->parent = -1;            /* initialize the root node */
+  root->offset = root->chcnt = root->id = root->cnts = root->chn = 0;
+  root->size   = cnt;           /* and copy the item frequencies */
+  while (--cnt >= 0) _setcnt(lvl, cnt, ib_getfrq(base, cnt));
+  ist->curr   = root; ist->clvl = 0;
   ist_setsize(ist, 1, 1, 1);    /* init. the extraction variables */
   ist_seteval(ist, IST_NONE, IST_NONE, 1, INT_MAX);
   ist_init(ist);
-  root->parent = root->succ  = NULL;
-  root->offset = root->chcnt = root->id = 0;
-  root->size   = n;             /* initialize the root node */
-  while (--cnt >= 0)            /* copy the item frequencies */
-    root->cnts[cnt] = ib_getfrq(base, cnt); 
+  #ifdef BENCH                  /* if benchmark version, */
+  ist->memsz = _memsz(ist);     /* note the memory usage */
+  ist->cntsz = _cntsz(ist);     /* and that of the counters */
+  #endif
   return ist;                   /* return created item set tree */
 }  /* ist_create() */
 
@@ -715,161 +1752,581 @@ ISTREE* ist_create (ITEMBASE *base, int mode,
 
 void ist_delete (ISTREE *ist)
 {                               /* --- delete an item set tree */
-  int    i;                     /* loop variables */
-  ISNODE *node, *t;             /* to traverse the nodes */
+  int i;                        /* loop variable */
 
   assert(ist);                  /* check the function argument */
-  for (i = ist->height; --i >= 0; ) {
-    for (node = ist->lvls[i]; node; ) {
-      t = node; node = node->succ; free(t); }
-  }                             /* delete all nodes, */
+  for (i = ist->height; --i >= 0; )
+    _clear(ist->lvls +i);       /* delete all levels, */
   free(ist->lvls);              /* the level array, */
   free(ist->map);               /* the identifier map, */
   free(ist->buf);               /* the path buffer, */
+  if (ist->dhp) free(ist->dhp); /* the hash bucket counters, */
+  if (ist->tops) free(ist->tops);/* the top-k support heap, */
   free(ist);                    /* and the tree body */
 }  /* ist_delete() */
 
+/*--------------------------------------------------------------------*/
+
+int ist_dhp (ISTREE *ist, int size)
+{                               /* --- set number of hash buckets */
+  assert(ist);                  /* check the function argument */
+  if (ist->dhp) free(ist->dhp); /* delete old bucket counters */
+  ist->dhp   = NULL;            /* and clear the hash variables */
+  ist->dhpsz = ist->dhpk = 0;   /* (no DHP pruning) */
+  if (size <= 0) return 0;      /* if no buckets requested, abort */
+  ist->dhp = (SUPP*)malloc((size_t)size *sizeof(SUPP));
+  if (!ist->dhp) return -1;     /* create the bucket counters */
+  ist->dhpsz = size;            /* and note their number */
+  return 0;                     /* return 'ok' */
+}  /* ist_dhp() */
+
+/*--------------------------------------------------------------------*/
+
+void ist_setsupp (ISTREE *ist, SUPP supp)
+{                               /* --- set the minimum support */
+  assert(ist);                  /* check the function argument */
+  ist->rule = (supp > 0) ? supp : 1;
+  if (ist->smax < ist->rule) ist->smax = ist->rule;
+  if (!(ist->mode & APP_HEAD)) supp = (SUPP)ceil(ist->conf *(double)supp);
+  ist->supp = (supp > 0) ? supp : 1;
+}  /* ist_setsupp() */          /* (as in ist_create()) */
+
+/*--------------------------------------------------------------------*/
+
+int ist_topk (ISTREE *ist, int k, int min)
+{                               /* --- set number of sets to find */
+  assert(ist);                  /* check the function argument */
+  if (ist->tops) free(ist->tops);
+  ist->tops = NULL;             /* delete an old support heap */
+  ist->topk = ist->tcnt = 0;    /* and clear the top-k variables */
+  if (k <= 0) return 0;         /* if no top-k search, abort */
+  ist->tops = (SUPP*)malloc((size_t)k *sizeof(SUPP));
+  if (!ist->tops) return -1;    /* create the support heap */
+  ist->topk = k;                /* note the number of item sets */
+  ist->tlvl = (min > 0) ? min-1 : 0;  /* and the first level */
+  return 0;                     /* return 'ok' */
+}  /* ist_topk() */
+
+/*--------------------------------------------------------------------*/
+
+static void _tkadd (ISTREE *ist, SUPP supp)
+{                               /* --- add a support to the heap */
+  int  i, k;                    /* heap indices */
+  SUPP *h = ist->tops;          /* min-heap of the best supports */
 
+  if (ist->tcnt < ist->topk) {  /* if the heap is not yet full, */
+    i = ist->tcnt++;            /* append the support and sift up */
+    while ((i > 0) && (h[k = (i-1) >> 1] > supp)) {
+      h[i] = h[k]; i = k; }     /* (move larger parents down) */
+    h[i] = supp; return;        /* store the new support */
+  }
+  if (supp <= h[0]) return;     /* replace the smallest support */
+  for (i = 0; (k = i+i+1) < ist->tcnt; i = k) {
+    if ((k+1 < ist->tcnt) && (h[k+1] < h[k])) k++;
+    if (h[k] >= supp) break;    /* find the smaller child */
+    h[i] = h[k];                /* and sift the new support down */
+  }                             /* (move smaller children up) */
+  h[i] = supp;                  /* store the new support */
+}  /* _tkadd() */
+
+/*--------------------------------------------------------------------*/
 
-void ist_count (ISTREE *ist, const int *items, int n, int wgt)
+SUPP ist_raise (ISTREE *ist)
+{                               /* --- raise the minimum support */
+  int     i;                    /* loop variable */
+  SUPP    s;                    /* support of an item set */
+  ISLEVEL *lvl;                 /* to traverse the levels */
+
+  assert(ist);                  /* check the function argument */
+  if (ist->topk <= 0) return ist->supp;
+  for ( ; ist->tlvl < ist->height; ist->tlvl++) {
+    lvl = ist->lvls +ist->tlvl; /* traverse the new levels */
+    if (lvl->spec) break;       /* (a speculative level is counted */
+    for (i = lvl->ccnt; --i >= 0; ) {      /* with the next one) */
+      s = _getcnt(lvl, i);      /* traverse the support counters */
+      if ((s >= ist->supp) && (s <= ist->smax))
+        _tkadd(ist, s);         /* add the supports of the sets */
+    }                           /* that may be reported */
+  }                             /* to the top-k support heap */
+  if ((ist->tcnt >= ist->topk)  /* if k sets have been found, */
+  &&  (ist->tops[0] > ist->supp))  /* raise the minimum support */
+    ist->supp = ist->rule = ist->tops[0];
+  return ist->supp;             /* return the new minimum support */
+}  /* ist_raise() */
+
+
+
+void ist_count (ISTREE *ist, const int *items, int n, SUPP wgt)
 {                               /* --- count a transaction */
+  int h;                        /* min. size of a counted item set */
+
   assert(ist                    /* check the function arguments */
      && (n >= 0) && (items || (n <= 0)));
-  if (n >= ist->height)         /* recursively count the transaction */
-    _count(ist->lvls[0], items, n, wgt, ist->height);
+  if (_dhpinit(ist))            /* hash the item sets for DHP */
+    _dhpt(ist, items, n, wgt);  /* (root counters are initialized */
+  h = ist->height -SPEC(ist);   /* from item base) */
+  if ((ist->height > 1) && (n >= h))
+    _count(ist->lvls, ist->lvls->nodes, items, n, wgt, h, NULL);
 }  /* ist_count() */
 
 
 
 void ist_countt (ISTREE *ist, const TRACT *t)
 {                               /* --- count a transaction */
-  int k;                        /* number of items */
+  int k, h;                     /* number of items, min. set size */
 
   assert(ist && t);             /* check the function arguments */
-  k = t_size(t);                /* get the transaction size and */
-  if (k >= ist->height)         /* count the transaction recursively */
-    _count(ist->lvls[0], t_items(t), k, t_wgt(t), ist->height);
+  k = t_size(t);                /* get the transaction size */
+  if (_dhpinit(ist))            /* hash the item sets for DHP */
+    _dhpt(ist, t_items(t), k, t_wgt(t));
+  h = ist->height -SPEC(ist);   /* get the min. counted set size */
+  if ((ist->height > 1) && (k >= h))
+    _count(ist->lvls, ist->lvls->nodes, t_items(t), k, t_wgt(t),
+           h, NULL);            /* count the transaction recursively */
 }  /* ist_countt() */
 
 
 
-void ist_countb (ISTREE *ist, const TABAG *bag)
+void ist_countb (ISTREE *ist, TABAG *bag, int trim)
 {                               /* --- count a transaction bag */
-  int   i, k;                   /* loop variable, number of items */
+  int   i, k, h;                /* loop variables, min. set size */
   TRACT *t;                     /* to traverse the transactions */
+  int   *marks = NULL;          /* markers for the used items */
+  int   *s, *d;                 /* to traverse the items */
+  PAIRS pc;                     /* pair counter for the second level */
 
   assert(ist && bag);           /* check the function arguments */
-  if (!tb_max(bag) >= ist->height)
+  if (_dhpinit(ist)) {          /* if to hash the item sets for DHP */
+    for (i = tb_cnt(bag); --i >= 0; ) {
+      t = tb_tract(bag, i);     /* traverse the transactions */
+      _dhpt(ist, t_items(t), t_size(t), t_wgt(t));
+    }                           /* hash the item sets */
+  }                             /* of the next level */
+  h = ist->height -SPEC(ist);   /* get the min. counted set size */
+  if ((ist->height < 2)         /* the root counters are initialized */
+  ||  (tb_max(bag) < h))        /* from the item base */
     return;                     /* check for suff. long transactions */
+  if ((ist->height == 2)        /* if the pair kernel can be used */
+  &&  (_pairinit(&pc, ist, _pairmem(ist)) == 0)) {
+    for (i = tb_cnt(bag); --i >= 0; ) {
+      t = tb_tract(bag, i);     /* traverse the transactions */
+      _pairs(&pc, t_items(t), t_size(t), t_wgt(t));
+    }                           /* count the pairs of items */
+    _pairexit(&pc);             /* add the pair counters to the tree */
+    if (trim) tb_filter(bag, 3, NULL);
+    return;                     /* (use dedicated pair counting; */
+  }                             /* all items are in candidate pairs) */
+  if (trim)                     /* if to trim the transactions */
+    marks = (int*)calloc((size_t)ist_itemcnt(ist), sizeof(int));
   for (i = tb_cnt(bag); --i >= 0; ) {
     t = tb_tract(bag, i);       /* traverse the transactions */
     k = t_size(t);              /* get the transaction size and */
-    if (k >= ist->height)       /* count the transaction recursively */
-      _count(ist->lvls[0], t_items(t), k, t_wgt(t), ist->height);
-  }
-}  /* ist_countt() */
+    if (k < h)                  /* skip transactions that are */
+      continue;                 /* too short for the next level */
+    _count(ist->lvls, ist->lvls->nodes, t_items(t), k, t_wgt(t),
+           h, marks);           /* count the transaction recursively */
+    if (!marks) continue;       /* if not to trim the transaction, */
+    for (s = d = t_items(t); *s >= 0; s++)      /* keep only items */
+      if (marks[*s]) { marks[*s] = 0; *d++ = *s; }  /* that were used */
+    t_size(t) = (int)(d -t_items(t)); *d = -1;  /* for a counter */
+  }                             /* (an unused item cannot be in */
+  if (marks) {                  /* a candidate of the next level) */
+    free(marks);                /* delete the item markers and */
+    tb_filter(bag, ist->height+1, NULL);
+  }                             /* remove transactions that are */
+}  /* ist_countb() */           /* too short for the next level */
 
 
 void ist_countx (ISTREE *ist, const TATREE *tree)
 {                               /* --- count transaction in tree */
+  int   *path;                  /* path in the transaction tree */
+  PAIRS pc;                     /* pair counter for the second level */
+
   assert(ist && tree);          /* check the function arguments */
-  _countx(ist->lvls[0], tt_root(tree), ist->height);
+  if (_dhpinit(ist)) {          /* if to hash the item sets for DHP */
+    path = (int*)malloc((size_t)(tt_max(tree)+1) *sizeof(int));
+    if (!path) ist->dhpk = 0;   /* create a path buffer */
+    else { _dhpx(ist, tt_root(tree), path, 0); free(path); }
+  }                             /* hash the item sets of the tree */
+  if (ist->height < 2) return;  /* (root counters are initialized) */
+  if ((ist->height == 2)        /* if the pair kernel can be used */
+  &&  (_pairinit(&pc, ist, _pairmem(ist)) == 0)) {
+    _pairx(&pc, tt_root(tree)); /* count the pairs of items and */
+    _pairexit(&pc); return;     /* add the pair counters to the tree */
+  }                             /* (use dedicated pair counting) */
+  _countx(ist->lvls, ist->lvls->nodes, tt_root(tree),
+          ist->height -SPEC(ist));
 }  /* ist_countx() */           /* recursively count the trans. tree */
 
 /*--------------------------------------------------------------------*/
 
+void ist_countall (ISTREE *ist, const int *items, int n, SUPP wgt)
+{                               /* --- count a trans. on all levels */
+  assert(ist                    /* check the function arguments */
+     && (n >= 0) && (items || (n <= 0)));
+  if (ist->height > 1)          /* count all item sets of a trans. */
+    _countall(ist->lvls, ist->lvls->nodes, items, n, wgt);
+}  /* ist_countall() */
+
+/*----------------------------------------------------------------------
+For a sliding window, a transaction that enters the window is counted
+on all levels (including the root counters, which are otherwise taken
+from the item base) with a positive weight and a transaction that
+leaves the window with a negative weight. The tree holds the frequent
+item sets of the window in which it was built together with their
+negative border (the candidates that turned out to be infrequent).
+The border sets are flagged (see ist_window()), and as long as none of
+them becomes frequent, no frequent item set can be missing from the
+tree: a frequent set that is not in the tree would have a subset in
+the negative border that is frequent as well.
+----------------------------------------------------------------------*/
+
+void ist_slide (ISTREE *ist, const int *items, int n, SUPP wgt)
+{                               /* --- add/remove a trans. (window) */
+  int     i;                    /* loop variable */
+  ISLEVEL *lvl;                 /* root level of the tree */
+
+  assert(ist                    /* check the function arguments */
+     && (n >= 0) && (items || (n <= 0)));
+  lvl = ist->lvls;              /* update the root counters */
+  for (i = n; --i >= 0; )       /* (the counter index of an item */
+    _inccnt(lvl, items[i], wgt);/* in the root node is the item) */
+  if (ist->height > 1)          /* count all item sets of a trans. */
+    _countall(lvl, lvl->nodes, items, n, wgt);
+}  /* ist_slide() */
+
+/*--------------------------------------------------------------------*/
+
+int ist_window (ISTREE *ist, int flag)
+{                               /* --- check the window border */
+  int     i, k, n = 0;          /* loop variables, number of sets */
+  SUPP    s;                    /* support of an item set */
+  ISLEVEL *lvl;                 /* to traverse the levels */
+
+  assert(ist);                  /* check the function argument */
+  for (k = 0; k < ist->height; k++) {
+    lvl = ist->lvls +k;         /* traverse the levels */
+    for (i = lvl->ccnt; --i >= 0; ) {
+      s = _getcnt(lvl, i);      /* traverse the counters */
+      if      (s < 0)           /* count the flagged border sets */
+        n += (COUNT(s) >= ist->supp) ? 1 : 0;   /* that are frequent */
+      else if (flag && (s < ist->supp))  /* flag the infrequent sets */
+        _setcnt(lvl, i, s | S_SKIP);     /* (new negative border) */
+    }
+  }
+  return n;                     /* return the number of border sets */
+}  /* ist_window() */           /* that have become frequent */
+
+/*--------------------------------------------------------------------*/
+
+int ist_cands (ISTREE *ist, TABAG *bag)
+{                               /* --- mark candidates of a level */
+  int     i, c, n = 0;          /* loop variable, counter, number */
+  TRACT   *t;                   /* to traverse the item sets */
+  ISLEVEL *lvl;                 /* level of the counter of a set */
+  SUPP    s;                    /* value of the candidate counters */
+
+  assert(ist && bag);           /* check the function arguments */
+  if (ist->height < 2) return 0;/* the root has no candidates */
+  s = _maxcnt(ist->lvls);       /* get the largest item support */
+  for (i = tb_cnt(bag); --i >= 0; ) {
+    t = tb_tract(bag, i);       /* traverse the item sets */
+    if (t_size(t) != ist->height) continue;
+    lvl = ist->lvls;            /* find the counter of the set */
+    c   = _counter(&lvl, lvl->nodes, t_items(t), t_size(t));
+    if (c < 0) continue;        /* (if the set has one) and */
+    _setcnt(lvl, c, s); n++;    /* mark it as a candidate */
+  }                             /* by setting its counter */
+  return n;                     /* return the number of candidates */
+}  /* ist_cands() */
+
+/*--------------------------------------------------------------------*/
+
+void ist_clear (ISTREE *ist)
+{                               /* --- clear all support counters */
+  int     i, k;                 /* loop variables */
+  ISLEVEL *lvl;                 /* to traverse the levels */
+
+  assert(ist);                  /* check the function argument */
+  for (k = 0; ++k < ist->height; ) {
+    lvl = ist->lvls +k;         /* traverse the levels below the root */
+    for (i = lvl->ccnt; --i >= 0; )
+      _setcnt(lvl, i, (_getcnt(lvl, i) > 0) ? 0 : S_SKIP);
+    _hfree(lvl);                /* clear the candidate counters, */
+  }                             /* flag all other (border) counters */
+}  /* ist_clear() */            /* and delete the lookup tables */
+
+/*--------------------------------------------------------------------*/
+
+int ist_border (ISTREE *ist)
+{                               /* --- count frequent border sets */
+  int     i, k, n = 0;          /* loop variables, number of sets */
+  SUPP    s;                    /* support of a border set */
+  ISLEVEL *lvl;                 /* to traverse the levels */
+
+  assert(ist);                  /* check the function argument */
+  for (k = 0; ++k < ist->height; ) {
+    lvl = ist->lvls +k;         /* traverse the levels below the root */
+    for (i = lvl->ccnt; --i >= 0; ) {
+      s = _getcnt(lvl, i);      /* traverse the flagged counters */
+      if (s >= 0) continue;     /* and count the border sets */
+      if (COUNT(s) >= ist->supp) n++;  /* that have turned out */
+      _setcnt(lvl, i, COUNT(s));       /* to be frequent and */
+    }                           /* clear the skip flags, so that */
+  }                             /* ist_mark() is not misled */
+  return n;                     /* return the number of missed sets */
+}  /* ist_border() */
+
+/*----------------------------------------------------------------------
+For incremental mining (FUP), the deepest level is counted only on the
+new transactions, and the supports of the sets of an earlier run (the
+frequent sets and the negative border, given as a transaction bag with
+the supports as weights) are added. A set that was not counted in the
+earlier run had an infrequent subset then, so its old support is at
+most the given bound (negative: unknown). If such a set may now reach
+the minimum support, the old transactions are counted, but only for the
+nodes that contain such sets (the other leaves are flagged like the
+subtrees that are skipped in counting, see _needed()). Sets that cannot
+reach the minimum support get a zero counter, so that they are not saved
+as if their support were known (see ist_save()).
+----------------------------------------------------------------------*/
+
+static void _fupset (ISTREE *ist, TABAG *bag, int add)
+{                               /* --- flag or add known supports */
+  int     i, c;                 /* loop variable, counter index */
+  TRACT   *t;                   /* to traverse the item sets */
+  ISLEVEL *lvl;                 /* level of the counter of a set */
+  SUPP    s;                    /* support of an item set */
+
+  for (i = tb_cnt(bag); --i >= 0; ) {
+    t = tb_tract(bag, i);       /* traverse the known item sets */
+    if (t_size(t) != ist->height) continue;
+    lvl = ist->lvls;            /* find the counter of the set */
+    c   = _counter(&lvl, lvl->nodes, t_items(t), t_size(t));
+    if (c < 0) continue;        /* skip sets that are not in the tree */
+    s   = _getcnt(lvl, c);      /* get the current counter value */
+    if      (!add)  _setcnt(lvl, c, s | S_SKIP);
+    else if (s < 0) _setcnt(lvl, c, COUNT(s) +t_wgt(t));
+  }                             /* flag the sets with known support */
+}  /* _fupset() */              /* or add their supports */
+
+/*--------------------------------------------------------------------*/
+
+int ist_fup (ISTREE *ist, TABAG *bag, SUPP bound,
+             const TATREE *tree, TABAG *old)
+{                               /* --- add supports of an earlier run */
+  int     i, k, n = 0;          /* loop variables, number of sets */
+  int     cnt;                  /* whether to count a node */
+  ISLEVEL *lvl;                 /* deepest level of the tree */
+  ISNODE  *node;                /* to traverse the nodes */
+  SUPP    s;                    /* support of an item set */
+
+  assert(ist && bag && (tree || old));  /* check the arguments */
+  if (ist->height < 2) return 0;/* the root counters are complete */
+  _fupset(ist, bag, 0);         /* flag the sets with known support */
+  lvl = ist->lvls +ist->height -1;
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    for (cnt = 0, i = node->size; --i >= 0; ) {
+      s = _getcnt(lvl, node->cnts +i);
+      if ((s >= 0) && ((bound < 0) || (s +bound >= ist->supp))) {
+        cnt = 1; n++; }         /* find the unknown sets */
+    }                           /* that may be frequent and */
+    if (!cnt) node->chcnt |= F_SKIP;       /* flag all other nodes */
+  }
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    if ((n > 0) && (ist->height == 2))
+      node->chcnt = 0;          /* pairs are counted in all nodes */
+    for (i = node->size; --i >= 0; ) {
+      s = _getcnt(lvl, k = node->cnts +i);
+      if      (node->chcnt == 0) _setcnt(lvl, k, COUNT(s));
+      else if (s >= 0)           _setcnt(lvl, k, 0);
+    }                           /* the counted nodes become exact, */
+  }                             /* unknown sets in other nodes are */
+  if (n > 0) {                  /* cleared (they are infrequent) */
+    _needed(ist->lvls, ist->lvls->nodes);
+    if (tree) ist_countx(ist, tree);  /* skip subtrees without */
+    else      ist_countb(ist, old, 0);/* counted nodes and count */
+    for (k = 0; k < ist->height -1; k++) {
+      lvl = ist->lvls +k;       /* traverse the inner levels */
+      for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+        if (CHCNT(node) > 0) node->chcnt = CHCNT(node);
+    }                           /* clear the skip flags of all nodes */
+  }                             /* with children (nodes without */
+  lvl = ist->lvls +ist->height -1;     /* children stay flagged) */
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    node->chcnt = 0;            /* clear the flags of the leaves */
+  if (n > 0)                    /* and restore the skip flags */
+    _needed(ist->lvls, ist->lvls->nodes);  /* for the next level */
+  _fupset(ist, bag, 1);         /* add the old supports of the */
+  return n;                     /* known sets in uncounted nodes */
+}  /* ist_fup() */
+
+/*--------------------------------------------------------------------*/
+
+int ist_save (ISTREE *ist, FILE *file)
+{                               /* --- save the counted item sets */
+  int     i, c, k, n = 0;       /* loop variables, number of sets */
+  int     *items;               /* path to the current node */
+  ISLEVEL *lvl, *l;             /* to traverse the levels */
+  ISNODE  *node, *curr;         /* to traverse the nodes */
+  SUPP    s;                    /* support of an item set */
+
+  assert(ist && file);          /* check the function arguments */
+  for (k = 0; ++k < ist->height; ) {
+    lvl = ist->lvls +k;         /* traverse the levels below the root */
+    for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+      items = ist->buf +ist->maxht;
+      for (curr = node, l = lvl; curr->parent >= 0; l--) {
+        *--items = ID(curr); curr = PARENT(l, curr); }
+      for (i = 0; i < node->size; i++) {
+        s = COUNT(_getcnt(lvl, node->cnts +i));
+        if (s <= 0) continue;   /* skip unknown and empty sets */
+        fprintf(file, SUPP_FMT, s);
+        for (c = 0; c < k; c++) {
+          fputc(' ', file); fputs(ib_name(ist->base, items[c]), file); }
+        fputc(' ', file);       /* write the support and the items */
+        fputs(ib_name(ist->base, _item(lvl, node, i)), file);
+        fputc('\n', file); n++; /* (an item set and its support */
+      }                         /* per record, support first; */
+    }                           /* the root level holds the item */
+  }                             /* frequencies and is not saved) */
+  return (ferror(file)) ? -1 : n;
+}  /* ist_save() */             /* return the number of sets */
+
+/*--------------------------------------------------------------------*/
+
 void ist_prune (ISTREE *ist)
 {                               /* --- prune counters and pointers */
-  int    i, k, n;               /* loop variables */
-  int    *c, *map;              /* counter array, item identifier map */
-  ISNODE **np, *node;           /* to traverse the nodes */
-  ISNODE **chn;                 /* child node array */
+  int     i, j, k, n, c, m;     /* loop variables, array positions */
+  int     o, *map, *chn;        /* counter position, id. map, children */
+  size_t  z;                    /* size of a counter in bytes */
+  unsigned int w, b;            /* bitmap word and its lowest bit */
+  ISLEVEL *lvl, *par;           /* deepest level and its parent level */
+  ISNODE  *node, *cld;          /* to traverse the nodes */
 
   assert(ist);                  /* check the function argument */
   if (ist->height <= 1)         /* if there is only the root node, */
     return;                     /* there is nothing to prune */
+  lvl = ist->lvls +ist->height -1;
+  z   = _cwsize[lvl->cw];       /* get the deepest level */
+  _hfree(lvl);                  /* and delete its lookup table */
 
   /* -- prune counters for infrequent items -- */
-  for (node = ist->lvls[ist->height-1]; node; node = node->succ) {
-    c = node->cnts;             /* traverse the deepest level */
+  for (c = m = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++){
+    o = node->cnts;             /* traverse the deepest level */
+    k = node->size;             /* and note the old node size */
     if (node->offset >= 0) {    /* if a pure array is used */
       for (n = node->size; --n >= 0; ) /* find the last */
-        if (c[n] >= ist->supp) break;  /* frequent item */
+        if (_getcnt(lvl, o+n) >= ist->supp) break;  /* frequent item */
       for (i = 0; i < n; i++)          /* find the first */
-        if (c[i] >= ist->supp) break;  /* frequent item  */
-      node->size = ++n-i;       /* set the new node size */
-      #ifdef BENCH              /* if benchmark version */
-      k = node->size -(n-i);    /* get the number of pruned counters */
-      ist->sccnt -= k;          /* update the number of counters */
-      ist->scprn += k;          /* and of pruned counters */
-      #endif                    /* update the memory usage */
-      if (i > 0) {              /* if there are leading infreq. items */
-        node->offset += i;      /* set the new item offset */
-        for (k = 0; i < n; i++) /* copy the frequent items */
-          c[k++] = c[i];        /* to the front of the array */
-      } }
+        if (_getcnt(lvl, o+i) >= ist->supp) break;  /* frequent item */
+      node->size    = ++n-i;    /* set the new node size */
+      node->offset += i;        /* and the new item offset */
+      memmove((char*)lvl->cnts +(size_t)c *z,
+              (char*)lvl->cnts +(size_t)(o+i) *z, (size_t)node->size *z); }
+    else if (BITMAP(node)) {    /* if a bitmap is used */
+      map = MAP(lvl, node);     /* get the bitmap and its size */
+      j   = 2 +2*map[1];        /* and move it to its new position */
+      memmove(lvl->map +m, map, (size_t)j *sizeof(int));
+      map = lvl->map +m;        /* traverse the words of the bitmap */
+      for (n = i = 0; i < k; map += 2) {
+        for (w = (unsigned int)map[2]; w; w &= w-1) {
+          if (_getcnt(lvl, o+i) >= ist->supp)
+            _setcnt(lvl, c+n++, _getcnt(lvl, o+i));
+          else {                /* keep the counters of frequent */
+            b = w & (~w+1);     /* items and clear the bits */
+            map[2] &= (int)~b;  /* of the infrequent items */
+          }                     /* (lowest bit set in the word) */
+          i++;                  /* count the traversed items */
+        }
+      }
+      map = lvl->map +m;        /* recompute the word ranks */
+      _bmrank(map);             /* of the compacted bitmap */
+      node->size   = n;         /* set the new node size */
+      node->offset = -1-m;      /* and the new position of the map */
+      if (n > 0) m += j;        /* (counters and map are compacted) */
+      #ifdef BENCH              /* if benchmark version, */
+      else ist->mapsz -= j;     /* update the total item map size */
+      #endif
+    }
     else {                      /* if an identifier map is used */
-      map = c +node->size;      /* get the item identifier map */
+      map = MAP(lvl, node);     /* get the item identifier map */
       for (i = n = 0; i < node->size; i++) {
-        if (c[i] >= ist->supp) {
-          c[n] = c[i]; map[n++] = map[i]; }
+        if (_getcnt(lvl, o+i) < ist->supp) continue;
+        _setcnt(lvl, c+n, _getcnt(lvl, o+i)); lvl->map[m+n] = map[i]; n++;
       }                         /* remove infrequent items */
-      k = node->size -n;        /* get the number of pruned counters */
-      if (k <= 0) continue;     /* if no items were pruned, continue */
+      node->size   = n;         /* set the new node size */
+      node->offset = -1-m;      /* and the new position of the map */
+      m += n;                   /* (counters and map are compacted) */
       #ifdef BENCH              /* if benchmark version, */
-      ist->sccnt -= k;          /* update the number of counters */
-      ist->scprn += k;          /* and of pruned counters */
-      ist->mapsz -= k;          /* update the total item map size */
+      ist->mapsz -= k -n;       /* update the total item map size */
       #endif
-      node->size = n; c += n;   /* set the new node size */
-      for (i = 0; i < n; i++)   /* move the item identifier map */
-        c[i] = map[i];          /* so that it starts directly */
-    }                           /* after the support counters */
+    }
+    node->cnts = c;             /* set the new counter position */
+    c += node->size;            /* and compute the next position */
+    #ifdef BENCH                /* if benchmark version */
+    ist->sccnt -= k -node->size;/* update the number of counters */
+    ist->scprn += k -node->size;/* and of pruned counters */
+    #endif
   }
+  lvl->ccnt = c; lvl->mcnt = m; /* set the new array sizes */
+
+  /* -- number the non-empty nodes -- */
+  for (k = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    node->chn = (node->size > 0) ? k++ : -1;
+  /* The child index field of the deepest nodes is not needed, */
+  /* so it is used to store the new indices of the nodes.      */
 
   /* -- prune pointers to empty children -- */
-  for (node = ist->lvls[ist->height-2]; node; node = node->succ) {
+  par = lvl -1; cld = lvl->nodes;
+  for (c = 0, node = par->nodes; node < par->nodes +par->cnt; node++) {
     n = CHCNT(node);            /* traverse the parent nodes */
     if (n <= 0) continue;       /* skip childless nodes */
+    chn = CHN(par, node);       /* get the child node array */
     if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
       while (--n >= 0)          /* find the last  non-empty child */
-        if (chn[n] && (chn[n]->size > 0)) break;                
+        if ((chn[n] >= 0) && (cld[chn[n]].size > 0)) break;
       for (i = 0; i < n; i++)   /* find the first non-empty child */
-        if (chn[i] && (chn[i]->size > 0)) break;             
-      node->chcnt = ++n-i;      /* set the new number of children */
-      #ifdef BENCH              /* if benchmark version, */
-      k = node->chcnt -(n-i);   /* get the number of pruned pointers */
-      ist->cpcnt -= k;          /* update the number of pointers */
-      ist->cpprn += k;          /* and of pruned pointers */
-      #endif
-      for (k = 0; i < n; i++)   /* remove all empty children */
-        chn[k++] = (chn[i] && (chn[i]->size > 0)) ? chn[i] : NULL; }
+        if ((chn[i] >= 0) && (cld[chn[i]].size > 0)) break;
+      for (k = 0; i <= n; i++)  /* remove all empty children */
+        par->chn[c+k++] = (chn[i] >= 0) ? cld[chn[i]].chn : -1; }
+    else if (BITMAP(node)) {    /* if a bitmap is used */
+      for (i = k = 0; i < n; i++) {
+        par->chn[c+i] = ((chn[i] >= 0) && (cld[chn[i]].size > 0))
+                      ? cld[chn[i]].chn : -1;
+        if (par->chn[c+i] >= 0) k++;
+      }                         /* keep an index for each counter */
+      k = (k > 0) ? n : 0; }    /* unless all children are empty */
     else {                      /* if an item identifier map is used */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
       for (i = k = 0; i < n; i++)
-        if (chn[i]->size > 0)   /* collect the child nodes */
-          chn[k++] = chn[i];    /* that are not empty */
-      node->chcnt = k;          /* set the new number of children */
-      #ifdef BENCH              /* if benchmark version, */
-      n -= k;                   /* get the number of pruned pointers */
-      ist->cpcnt -= n;          /* update the number of pointers */
-      ist->cpprn += n;          /* and of pruned pointers */
-      #endif
-    }                 
+        if (cld[chn[i]].size > 0)  /* collect the child nodes */
+          par->chn[c+k++] = cld[chn[i]].chn;
+    }                           /* that are not empty */
+    #ifdef BENCH                /* if benchmark version, */
+    ist->cpcnt -= CHCNT(node)-k;/* update the number of pointers */
+    ist->cpprn += CHCNT(node)-k;/* and of pruned pointers */
+    #endif
+    node->chcnt = k;            /* set the new number of children */
+    node->chn   = c; c += k;    /* and the new child array position */
     if (node->chcnt <= 0)       /* if all children were removed, */
       node->chcnt |= F_SKIP;    /* set the skip flag, so that */
   }                             /* no recounting takes place */
+  par->kcnt = c;                /* set the new child array size */
 
   /* -- remove empty children -- */
-  for (np = ist->lvls +ist->height-1; *np; ) {
-    node = *np;                 /* traverse the deepest level again */
-    if (node->size > 0) { np = &node->succ; continue; }
-    *np = node->succ; free(node); /* remove empty nodes */
+  for (k = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    node->chn = 0;              /* traverse the deepest level again */
+    if (node->size > 0) { lvl->nodes[k++] = *node; continue; }
     #ifdef BENCH                /* if benchmark version */
     ist->ndcnt--; ist->ndprn++; /* update the number nodes */
     #endif                      /* and of pruned nodes */
-  }
+  }                             /* (remove empty nodes) */
+  lvl->cnt = k;                 /* set the new number of nodes */
+  _shrink(lvl); _shrink(par);   /* and release unused memory */
+  #ifdef BENCH                  /* if benchmark version, */
+  ist->memsz = _memsz(ist);     /* note the memory usage */
+  ist->cntsz = _cntsz(ist);     /* and that of the counters */
+  #endif
 }  /* ist_prune() */
 
 /*--------------------------------------------------------------------*/
@@ -879,147 +2336,396 @@ int ist_check (ISTREE *ist, int *marks)
   int i, n;                     /* loop variable, number of items */
 
   assert(ist);                  /* check the function argument */
-  for (i = ist->lvls[0]->size; --i >= 0; )
+  for (i = ist->lvls->nodes->size; --i >= 0; )
     marks[i] = 0;               /* clear the marker array */
-  _used(ist->lvls[0], marks, ist->supp);
-  for (n = 0, i = ist->lvls[0]->size; --i >= 0; )
+  _used(ist->lvls, ist->lvls->nodes, marks, ist->supp);
+  for (n = 0, i = ist->lvls->nodes->size; --i >= 0; )
     if (marks[i]) n++;          /* count used items */
   return n;                     /* and return this number */
 }  /* ist_check() */
 
 /*--------------------------------------------------------------------*/
 
+static int _addnode (ISTREE *ist, ISLEVEL *lvl, ISLEVEL *cl,
+                     ISLEVEL *kl, ISNODE *node)
+{                               /* --- add the children of a node */
+  int    i, k, n;               /* loop variable, node counter */
+  SUPP   spx;                   /* support for a perfect extension */
+  int    frst;                  /* index of first child of a node */
+  int    *chn;                  /* child node array */
+  int    *map;                  /* bitmap of a node */
+  ISNODE *cld;                  /* nodes of the new level */
+  void   *t;                    /* temporary buffer for reallocation */
+
+  ist->node = node;             /* note the node for evaluation */
+  frst = cl->cnt;               /* note start of the child node list */
+  spx  = _spx(ist, lvl, node);  /* get support for perfect extension */
+  for (i = 0; i < node->size; i++)
+    if (_child(ist, lvl, cl, node, i, spx) < 0)
+      return -1;                /* create a child node if necessary */
+  n = cl->cnt -frst;            /* get the number of children */
+  if (n <= 0) {                 /* if no child node was created, */
+    node->chcnt = F_SKIP; return 0; }         /* skip the node */
+  #ifdef BENCH                  /* if benchmark version, */
+  ist->cpnec += n;              /* sum the number of */
+  #endif                        /* necessary child pointers */
+  cld = cl->nodes;              /* get the nodes of the new level */
+  if      (node->offset >= 0)   /* if a pure counter array is used, */
+    n = ID(cld +cl->cnt-1) -ID(cld +frst) +1;
+  else if (BITMAP(node))        /* always add a pure child array, */
+    n = node->size;             /* for a bitmap one per counter, */
+                                /* otherwise add a compact array */
+  t = _enlarge(kl->chn, &kl->ksz, kl->kcnt +n, sizeof(int));
+  if (!t) return -1;            /* enlarge the child index array */
+  kl->chn     = (int*)t;        /* and add a child array */
+  node->chn   = kl->kcnt;       /* to the current node */
+  node->chcnt = n;              /* (note its position and size) */
+  kl->kcnt   += n;
+  #ifdef BENCH                  /* if benchmark version, */
+  ist->cpcnt += n;              /* sum the number of child pointers */
+  #endif
+  chn = kl->chn +node->chn;     /* get the child node array */
+  if (node->offset >= 0) {      /* if a pure array is used */
+    while (--n >= 0) chn[n] = -1;
+    k = ID(cld +frst);          /* clear the child node array */
+    for (i = frst; i < cl->cnt; i++)
+      chn[ID(cld +i) -k] = i; } /* set the child node indices */
+  else if (BITMAP(node)) {      /* if a bitmap is used */
+    while (--n >= 0) chn[n] = -1;
+    map = MAP(lvl, node);       /* clear the child node array */
+    for (i = frst; i < cl->cnt; i++)
+      chn[_bmfind(map, ID(cld +i))] = i; }
+  else {                        /* if an identifier map is used */
+    for (i = 0; i < n; i++)     /* set the child node indices */
+      chn[i] = frst +i;         /* (children are consecutive */
+  }                             /*  in the node array of the level) */
+  return 0;                     /* return 'ok' */
+}  /* _addnode() */
+
+/*----------------------------------------------------------------------
+If compiled with IST_THREADS, the nodes of the deepest level are split
+into contiguous ranges of similar (estimated) work, one per thread.
+Each worker creates the children of its nodes in arenas of its own
+(node, counter, map and child index arrays) with a copy of the tree
+that has its own buffers. Since the ranges are in traversal order, the
+arenas are concatenated in worker order, with node, counter, map and
+child indices rebased, which yields exactly the sequential result.
+Workers only read the counters of other nodes (and strip skip flags,
+see _cands()), lookup tables are built before the threads start.
+----------------------------------------------------------------------*/
+#ifdef IST_THREADS
+
+static void* _worker (void *data)
+{                               /* --- add children of a node range */
+  WORKER *w = (WORKER*)data;    /* worker data */
+  ISLEVEL *lvl;                 /* deepest level of the tree */
+  ISNODE  *node;                /* to traverse the nodes */
+
+  lvl = w->ist.lvls +w->ist.height -1;
+  for (node = w->beg; node < w->end; node++)
+    if (_addnode(&w->ist, lvl, &w->cl, &w->kl, node) < 0) {
+      w->err = -1; break; }     /* add the children of the nodes */
+  return NULL;                  /* to the arenas of the worker */
+}  /* _worker() */
+
+/*--------------------------------------------------------------------*/
+
+static int _addpar (ISTREE *ist, ISLEVEL *lvl, ISLEVEL *cl)
+{                               /* --- add children in parallel */
+  int     i, k, n, r = 0;       /* loop variables, result */
+  double  sum, tot;             /* (estimated) work of the nodes */
+  int     nb, cb, mb, kb;       /* bases of the worker arenas */
+  size_t  z;                    /* size of a counter in bytes */
+  WORKER  *wrk, *w;             /* workers and current worker */
+  ISNODE  *node;                /* to traverse the nodes */
+  void    *p;                   /* buffer for reallocation */
+
+  n = (ist->thcnt < lvl->cnt /IST_THDMIN)
+    ?  ist->thcnt : lvl->cnt /IST_THDMIN;
+  if (n <= 1) return 1;         /* check for enough nodes per thread */
+  z = _cwsize[cl->cw];          /* get the size of the counters */
+  _hready(ist, lvl);            /* build the lookup tables */
+  if ((ist->eval > IST_NONE) && (ist->agg > IST_NONE)) {
+    for (i = ist->height-1; --i > 0; )
+      _hready(ist, ist->lvls +i);
+  }                             /* (workers must not build tables) */
+  wrk = (WORKER*)calloc((size_t)n, sizeof(WORKER));
+  if (!wrk) return -1;          /* create the worker array */
+  for (tot = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    tot += (double)node->size *node->size;
+  node = lvl->nodes;            /* estimate the total work */
+  for (sum = 0, i = 0; i < n; i++) {
+    w = wrk +i; w->ist = *ist;  /* traverse the workers */
+    w->ist.map = (int*)malloc((size_t)(ist_itemcnt(ist)+1)*sizeof(int));
+    w->ist.buf = (int*)malloc((size_t)ist->maxht *sizeof(int));
+    if (!w->ist.map || !w->ist.buf) r = -1;
+    #ifdef BENCH                /* if benchmark version, */
+    w->ist.ndcnt = w->ist.mapsz = w->ist.sccnt = w->ist.scnec = 0;
+    w->ist.cpcnt = w->ist.cpnec = w->ist.dhprn = 0;
+    #endif                      /* clear the benchmark counters */
+    w->cl.cw = cl->cw;          /* set the counter width */
+    w->beg   = node;            /* and the node range of the worker */
+    while ((node < lvl->nodes +lvl->cnt)
+    &&     ((i >= n-1) || (sum < tot *(i+1) /n))) {
+      sum += (double)node->size *node->size; node++; }
+    w->end   = node;            /* distribute the nodes so that */
+  }                             /* the workers have similar work */
+  if (r == 0) {                 /* if the workers could be set up */
+    for (i = 1; i < n; i++)     /* start all but the first worker */
+      if (pthread_create(&wrk[i].thread, NULL, _worker, wrk+i) != 0)
+        wrk[i].err = 1;         /* (if a thread cannot be created, */
+    _worker(wrk);               /* the worker is run afterwards) */
+    for (i = 1; i < n; i++) {   /* wait for the workers */
+      if (!wrk[i].err) pthread_join(wrk[i].thread, NULL);
+      else { wrk[i].err = 0; _worker(wrk+i); }
+    }                           /* run workers without a thread */
+    for (i = 0; i < n; i++)     /* check for errors */
+      if (wrk[i].err) r = -1;   /* in any of the workers */
+  }
+  for (nb = cb = mb = kb = 0, i = 0; i < n; i++) {
+    nb += wrk[i].cl.cnt;  cb += wrk[i].cl.ccnt;
+    mb += wrk[i].cl.mcnt; kb += wrk[i].kl.kcnt;
+  }                             /* sum the sizes of the arenas */
+  if ((r == 0) && (nb > 0)) {   /* if children have been created, */
+    cl->nodes = (ISNODE*)malloc((size_t)nb *sizeof(ISNODE));
+    cl->cnts  = malloc((size_t)cb *z);   /* allocate the arrays */
+    cl->map   = (mb > 0) ? (int*)malloc((size_t)mb *sizeof(int)) : NULL;
+    if (!cl->nodes || !cl->cnts || ((mb > 0) && !cl->map)) r = -1;
+    else { cl->nsz = nb; cl->csz = cb; cl->msz = mb; }
+    p = (r != 0) ? NULL         /* enlarge the child index array */
+      : _enlarge(lvl->chn, &lvl->ksz, lvl->kcnt +kb, sizeof(int));
+    if (p) lvl->chn = (int*)p;  /* (in the deepest level) */
+    else   r = -1;              /* if the level could not be created, */
+  }                             /* the trees of the workers are lost */
+  for (nb = cb = mb = 0, kb = lvl->kcnt, i = 0; i < n; i++) {
+    w = wrk +i;                 /* traverse the workers */
+    if ((r == 0) && cl->nodes) {/* if all arrays could be created */
+      for (k = 0; k < w->cl.cnt; k++) {
+        node = cl->nodes +nb +k;/* copy the nodes of the worker */
+        *node = w->cl.nodes[k]; /* and rebase their counter */
+        node->cnts += cb;       /* and map positions */
+        if (node->offset < 0) node->offset -= mb;
+      }
+      memcpy((char*)cl->cnts +(size_t)cb *z, w->cl.cnts,
+             (size_t)w->cl.ccnt *z);
+      if (w->cl.mcnt > 0)       /* copy the counters and the maps */
+        memcpy(cl->map +mb, w->cl.map, (size_t)w->cl.mcnt *sizeof(int));
+      for (k = 0; k < w->kl.kcnt; k++)
+        lvl->chn[kb+k] = (w->kl.chn[k] < 0) ? -1 : w->kl.chn[k] +nb;
+      for (node = w->beg; node < w->end; node++)
+        if (node->chcnt > 0) node->chn += kb;
+      #ifdef BENCH              /* copy the child indices and */
+      ist->ndcnt += w->ist.ndcnt; ist->mapsz += w->ist.mapsz;
+      ist->sccnt += w->ist.sccnt; ist->scnec += w->ist.scnec;
+      ist->cpcnt += w->ist.cpcnt; ist->cpnec += w->ist.cpnec;
+      ist->dhprn += w->ist.dhprn;
+      #endif                    /* sum the benchmark counters */
+      nb += w->cl.cnt;  cb += w->cl.ccnt;
+      mb += w->cl.mcnt; kb += w->kl.kcnt;
+    }                           /* advance the bases */
+    if (w->ist.map) free(w->ist.map);
+    if (w->ist.buf) free(w->ist.buf);
+    _clear(&w->cl); _clear(&w->kl);
+  }                             /* delete the worker arenas */
+  free(wrk);                    /* and the worker array */
+  if (r != 0) return -1;        /* check for an error */
+  cl->cnt = nb; cl->ccnt = cb;  /* set the sizes of the new level */
+  cl->mcnt = mb; lvl->kcnt = kb;/* and of the child index array */
+  return 0;                     /* return 'ok' */
+}  /* _addpar() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
 int ist_addlvl (ISTREE *ist)
 {                               /* --- add a level to item set tree */
-  int    i, n;                  /* loop variable, node counter */
-  int    spx;                   /* support for a perfect extension */
-  ISNODE **np;                  /* to traverse the nodes */
-  ISNODE *node;                 /* current node in deepest level */
-  ISNODE *par;                  /* parent of current node */
-  ISNODE *cur;                  /* current node in new level (child) */
-  ISNODE **frst;                /* first child of current node */
-  ISNODE *last;                 /* last  child of current node */
-  ISNODE **end;                 /* end of node list of new level */
-  ISNODE **chn;                 /* child node array */
-  void   *t;                    /* temporary buffer for reallocation */
+  int     n;                    /* new size of the level array */
+  int     kcnt;                 /* old number of child indices */
+  size_t  z;                    /* memory used by the existing levels */
+  ISLEVEL *lvl;                 /* deepest level of the tree */
+  ISLEVEL *cl;                  /* new level (children) */
+  ISNODE  *node;                /* current node in deepest level */
+  void    *t;                   /* temporary buffer for reallocation */
 
   assert(ist);                  /* check the function arguments */
 
   /* --- enlarge level array --- */
   if (ist->height >= ist->maxht) {
     n = ist->maxht +BLKSIZE;    /* if the level array is full */
-    t = realloc(ist->lvls, n *sizeof(ISNODE*));
+    t = realloc(ist->lvls, n *sizeof(ISLEVEL));
     if (!t) return -1;          /* enlarge the level array */
-    ist->lvls = (ISNODE**)t;    /* and set the new array */
+    ist->lvls = (ISLEVEL*)t;    /* and set the new array */
+    memset(ist->lvls +ist->maxht, 0, BLKSIZE *sizeof(ISLEVEL));
     t = realloc(ist->buf,  n *sizeof(int));
     if (!t) return -1;          /* enlarge the buffer array */
     ist->buf   = (int*)t;       /* and set the new array */
     ist->maxht = n;             /* set the new array size */
   }                             /* (applies to buf and levels) */
-  end  = ist->lvls +ist->height;
-  *end = NULL;                  /* start a new tree level */
+  lvl  = ist->lvls +ist->height -1;
+  cl   = lvl +1;                /* get the deepest level and */
+  memset(cl, 0, sizeof(ISLEVEL));  /* start a new tree level */
+  cl->cw = ((lvl->spec) || (ist->mode & IST_WINDOW))
+         ? lvl->cw : _width(_maxcnt(lvl));
+  kcnt = lvl->kcnt;             /* the support of an item set cannot */
+                                /* exceed the support of its subsets */
+                                /* (in a sliding window it can grow */
+                                /* up to the total weight, which the */
+                                /* root counter width can hold) */
+  z = (ist->maxmem > 0) ? _memsz(ist) : 0;
 
   /* --- add tree level --- */
-  for (np = ist->lvls +ist->height -1; *np; np = &(*np)->succ) {
-    node = ist->node = *np;     /* traverse the deepest nodes */
-    frst = end; last = NULL;    /* note start of the child node list */
-    if (!(ist->mode & IST_PERFECT)) spx = INT_MAX;
-    else if (!node->parent)         spx = ist->wgt;
-    else spx = _getsupp(node->parent, &node->id, 1);
-    spx = COUNT(spx);           /* get support for perfect extension */
-    for (i = n = 0; i < node->size; i++) {
-      cur = _child(ist,node,i,spx);   /* traverse the counter array */
-      if (!cur) continue;       /* create a child node if necessary */
-      if (cur == (void*)-1) { *end = NULL; _cleanup(ist); return -1; }
-      *end = last = cur;        /* add node at the end of the list */
-      end  = &cur->succ; n++;   /* that contains the new level */
-    }                           /* and advance the end pointer */
-    if (n <= 0) {               /* if no child node was created, */
-      node->chcnt = F_SKIP; continue; }         /* skip the node */
-    *end = NULL;                /* terminate the child node list */
-    #ifdef BENCH                /* if benchmark version, */
-    ist->cpnec += n;            /* sum the number of */
-    #endif                      /* necessary child pointers */
-    chn = np; par = node->parent;
-    if (par) {                  /* if there is a parent node */
-      if (par->offset >= 0) {   /* if a pure array is used */
-        chn = (ISNODE**)(par->cnts +par->size +PAD(par->size));
-        chn += ID(node) -ID(chn[0]); }
-      else {                    /* if an identifier map is used */
-        chn = (ISNODE**)(par->cnts +par->size +    par->size);
-        chn += _search(ID(node), chn, CHCNT(par));
-      }                         /* find the child node pointer */
-    }                           /* in the parent node */
-    if (node->offset >= 0) {    /* if a pure counter array is used, */
-      i = (node->size +PAD(node->size) -1) *sizeof(int);
-      n = ID(last)-ID(*frst)+1;}/* always add a pure child array */
-    else {                      /* if an identifier map is used */
-      i = (node->size +    node->size  -1) *sizeof(int);
-    }                           /* add a compact child array */
-    node = (ISNODE*)realloc(node, sizeof(ISNODE) +i +n *sizeof(ISNODE));
-    if (!node) { _cleanup(ist); return -1; }
-    node->chcnt = n;            /* add a child array to the node */
-    #ifdef BENCH                /* if benchmark version, */
-    ist->cpcnt += n;            /* sum the number of child pointers */
-    #endif
-    *chn = *np = node;          /* set the new (reallocated) node */
-    if (node->offset >= 0) {    /* if a pure array is used */
-      chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-      while (--n >= 0) chn[n] = NULL;
-      i   = ID(*frst);          /* get the child node array */
-      for (cur = *frst; cur; cur = cur->succ) {
-        chn[ID(cur)-i] = cur;   /* set the child node pointer */
-        cur->parent    = node;  /* and the parent pointer */
-      } }                       /* in the new node */
-    else {                      /* if an identifier map is used */
-      chn = (ISNODE**)(node->cnts +node->size +node->size);
-      i   = 0;                  /* get the child node array */
-      for (cur = *frst; cur; cur = cur->succ) {
-        chn[i++]    = cur;      /* set the child node pointer */
-        cur->parent = node;     /* and the parent pointer */
-      }                         /* in the new node */
-    }                           /* (store pointers to children */
-  }                             /*  in the current node) */
-  if (!ist->lvls[ist->height])  /* if no child has been added, */
-    return 1;                   /* abort the function, otherwise */
+  ist->level = ist->height -1;  /* note the level for evaluation */
+  #ifdef IST_THREADS            /* if to use several threads */
+  n = _addpar(ist, lvl, cl);    /* try to add the level in parallel */
+  if (n < 0) { _cleanup(ist, kcnt); return -1; }
+  if (n > 0)                    /* if not done in parallel, */
+  #endif                        /* add the level sequentially */
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    if (_addnode(ist, lvl, cl, lvl, node) < 0) {
+      _cleanup(ist, kcnt); return -1; }
+    if ((ist->maxmem > 0) && (cl->cnt > 0)  /* if the new level */
+    &&  (z +_lvlsz(cl) > ist->maxmem)) {   /* exceeds the budget, */
+      _cleanup(ist, kcnt); return 2; }     /* remove it again */
+  }                             /* add the children of all nodes */
+  if (cl->cnt <= 0) {           /* if no child has been added, */
+    _clear(cl); return 1; }     /* abort the function, otherwise */
+  if ((ist->maxmem > 0)         /* check the memory budget again */
+  &&  (z +_lvlsz(cl) > ist->maxmem)) {     /* (needed if the level */
+    _cleanup(ist, kcnt); return 2; }       /* was added in parallel) */
+  _shrink(cl); _shrink(lvl);    /* release the reserve space */
   ist->height++;                /* increment the level counter */
-  _needed(ist->lvls[0]);        /* mark unnecessary subtrees */
+  _needed(ist->lvls, ist->lvls->nodes);  /* mark unnecessary subtrees */
+  #ifdef BENCH                  /* if benchmark version, */
+  ist->memsz = _memsz(ist);     /* note the memory usage */
+  ist->cntsz = _cntsz(ist);     /* and that of the counters */
+  #endif
   return 0;                     /* return 'ok' */
 }  /* ist_addlvl() */
 
+/*----------------------------------------------------------------------
+A speculative level is added below a level that has not been counted
+yet, so that both levels are counted in the same pass. Since the
+supports of the uncounted sets are unknown, a set is extended with all
+items that are not excluded by the item appearances and its subsets
+are only required to exist (rather than to be frequent). Afterwards
+ist_commit() clears the counters of all sets that would not have been
+created with the supports known, so that the result is the same as if
+the levels had been counted in two passes. Note that this is not only
+the set of candidates: if _child() would have used a pure counter
+array, it would also have counted the other items in the range of the
+candidates (and such sets may be frequent, for example if one of the
+candidate items is a perfect extension), so these counters are kept.
+----------------------------------------------------------------------*/
+
+int ist_addspec (ISTREE *ist, int max)
+{                               /* --- add a speculative level */
+  int     r;                    /* result of ist_addlvl() */
+  double  n;                    /* (estimated) number of counters */
+  ISLEVEL *lvl;                 /* deepest level of the tree */
+  ISNODE  *node;                /* to traverse the nodes */
+
+  assert(ist);                  /* check the function arguments */
+  if (ist->height < 2) return 1;/* the root level is always counted */
+  lvl = ist->lvls +ist->height -1;
+  for (n = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    n += 0.5 *node->size *(node->size -1);
+  if (n > max) return 1;        /* estimate the number of counters */
+  lvl->spec = 1;                /* mark the deepest level as uncounted */
+  r = ist_addlvl(ist);          /* and add a level below it */
+  if (r == 0) return 0;         /* if the level was added, abort */
+  lvl = ist->lvls +ist->height -1;
+  lvl->spec = 0;                /* otherwise clear the level flag */
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    node->chcnt = 0;            /* and the skip flags of the nodes */
+  return r;                     /* return the error indicator */
+}  /* ist_addspec() */
+
+/*--------------------------------------------------------------------*/
+
+void ist_commit (ISTREE *ist)
+{                               /* --- commit a speculative level */
+  int     i, j, k, m, n;        /* loop variables, number of cands. */
+  int     *chn;                 /* child node array */
+  ISLEVEL *lvl, *cl;            /* speculative level and its children */
+  ISNODE  *node, *cld;          /* to traverse the nodes */
+  SUPP    spx;                  /* support for a perfect extension */
+  size_t  z;                    /* size of the counters of _child() */
+
+  assert(ist);                  /* check the function argument */
+  if (ist->height < 3) return;  /* check for a speculative level */
+  lvl = ist->lvls +ist->height -2;
+  if (!lvl->spec) return;       /* get the formerly uncounted level */
+  lvl->spec = 0;  cl = lvl +1;  /* and clear its speculation flag */
+  ist->height--;                /* (checks must see the old height) */
+  ist->level = ist->height -1;  /* note the level for evaluation */
+  z = _cwsize[_width(_maxcnt(lvl))];   /* (see ist_addlvl()) */
+  for (node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++) {
+    if (node->chcnt <= 0) continue;  /* traverse nodes with children */
+    ist->node = node;           /* note the node for evaluation */
+    spx = _spx(ist, lvl, node); /* get support for perfect extension */
+    chn = CHN(lvl, node);       /* and the child node array */
+    for (j = 0; j < node->chcnt; j++) {
+      if (chn[j] < 0) continue; /* traverse the child nodes */
+      cld = cl->nodes +chn[j];  /* and collect their candidates */
+      i   = _index(lvl, node, ID(cld));
+      n   = (i >= 0) ? _cands(ist, lvl, node, i, spx) : 0;
+      if (n > 0) {              /* if a child would be created, */
+        k = n;                  /* get the structure it would have */
+        if ((_layout(ist, z, &k, &m) == 0) && (m <= 0)) {
+          for (i = k; --i >= 0; )   /* if it is a pure array, keep */
+            ist->map[i] = ist->map[0] +i;     /* all counters in */
+          n = k;                /* the range of the candidates */
+        }                       /* (they would have been counted) */
+      }
+      for (m = i = 0; i < cld->size; i++) {
+        while ((m < n) && (ist->map[m] < _item(cl, cld, i))) m++;
+        if ((m >= n) || (ist->map[m] != _item(cl, cld, i)))
+          _setcnt(cl, cld->cnts +i, 0);
+      }                         /* clear the counters of all sets */
+    }                           /* that are not candidates */
+  }                             /* (they would not have been created */
+  ist->height++;                /* if the supports had been known) */
+}  /* ist_commit() */
+
 /*--------------------------------------------------------------------*/
 
 void ist_up (ISTREE *ist, int root)
 {                               /* --- go up in item set tree */
   assert(ist && ist->curr);     /* check the function argument */
-  if      (root)                /* if root flag set, */
-    ist->curr = ist->lvls[0];   /* go to the root node */
-  else if (ist->curr->parent)   /* if it exists, go to the parent */
-    ist->curr = ist->curr->parent;
+  if      (root) {              /* if root flag set, */
+    ist->curr = ist->lvls->nodes; ist->clvl = 0; }  /* go to the root */
+  else if (ist->curr->parent >= 0) {    /* if it exists, */
+    ist->curr = PARENT(ist->lvls +ist->clvl, ist->curr);
+    ist->clvl--;                /* go to the parent node */
+  }
 }  /* ist_up() */
 
 /*--------------------------------------------------------------------*/
 
 int ist_down (ISTREE *ist, int item)
 {                               /* --- go down in item set tree */
-  ISNODE *node;                 /* current node */
-  ISNODE **chn;                 /* child node array */
-  int    cnt;                   /* number of children */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node;                /* current node */
+  int     *chn;                 /* child node array */
+  int     cnt;                  /* number of children */
 
   assert(ist && ist->curr);     /* check the function argument */
-  node = ist->curr;             /* get the current node */
+  lvl  = ist->lvls +ist->clvl;  /* get the current node */
+  node = ist->curr;             /* and its level */
   cnt  = CHCNT(node);           /* if there are no child nodes, */
   if (cnt <= 0) return -1;      /* abort the function */
+  chn  = CHN(lvl, node);        /* get the child node array */
   if (node->offset >= 0) {      /* if a pure array is used */
-    chn   = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-    item -= ID(chn[0]);         /* compute index in child node array */
-    if ((item >= cnt) || !chn[item]) return -1; }
-  else {                        /* if an identifier map is used */
-    chn   = (ISNODE**)(node->cnts +node->size +    node->size);
-    item  = _search(item, chn, cnt);
-  }                             /* search for the proper index */
+    item -= ID(lvl[1].nodes +chn[0]);
+    if ((item < 0) || (item >= cnt) || (chn[item] < 0)) return -1; }
+  else if (BITMAP(node)) {      /* if a bitmap is used */
+    item  = _bmfind(MAP(lvl, node), item);
+    if ((item >= 0) && (chn[item] < 0)) return -1; }
+  else                          /* if an identifier map is used */
+    item  = _search(item, chn, cnt, lvl[1].nodes);
   if (item < 0) return -1;      /* if index is out of range, abort */
-  ist->curr = chn[item];        /* otherwise go to the child node */
+  ist->curr = lvl[1].nodes +chn[item];
+  ist->clvl++;                  /* otherwise go to the child node */
   return 0;                     /* return 'ok' */
 }  /* ist_down() */
 
@@ -1038,101 +2744,203 @@ int ist_next (ISTREE *ist, int item)
     if (i <  0) return node->offset;
     if (i >= node->size) return -1;
     return item +1; }           /* return the next item identifier */
+  else if (BITMAP(node)) {      /* if a bitmap is used */
+    map = MAP(ist->lvls +ist->clvl, node);
+    i   = _bmcount(map, item+1);/* count the items up to the given */
+    return (i < node->size) ? _bmitem(map, i) : -1; }
   else {                        /* if an identifier map is used */
-    map = node->cnts +(n = node->size);
-    i = int_bsearch(item, map, n);
-    i = (i < 0) ? -1-i : i+1;   /* try to find the item in the map */
+    map = MAP(ist->lvls +ist->clvl, node);
+    i   = int_bsearch(item, map, n = node->size);
+    i   = (i < 0) ? -1-i : i+1; /* try to find the item in the map */
     return (i < n) ? map[i] : -1;
   }                             /* return the following item */
 }  /* ist_next() */
 
 /*--------------------------------------------------------------------*/
 
-int ist_supp (ISTREE *ist, int item)
+SUPP ist_supp (ISTREE *ist, int item)
 {                               /* --- get support for an item */
-  ISNODE *node;                 /* current node in tree */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node;                /* current node in tree */
 
   assert(ist && ist->curr);     /* check the function argument */
-  node = ist->curr;             /* get the current node */
-  if (node->offset >= 0) {      /* if pure arrays are used, */
-    item -= node->offset;       /* get index in counter array */
-    if (item >= node->size) return 0; }
-  else                          /* if an identifier map is used */
-    item = int_bsearch(item, node->cnts +node->size, node->size);
+  lvl  = ist->lvls +ist->clvl;  /* get the current node */
+  node = ist->curr;             /* and its level */
+  item = _index(lvl, node, item);  /* get index in counter array */
   if (item < 0) return 0;       /* abort if index is out of range */
-  return COUNT(node->cnts[item]);
+  return COUNT(_getcnt(lvl, node->cnts +item));
 }  /* ist_supp() */             /* return the item set support */
 
 /*--------------------------------------------------------------------*/
 
-int ist_suppx (ISTREE *ist, int *items, int n)
+SUPP ist_suppx (ISTREE *ist, int *items, int n)
 {                               /* --- get support of an item set */
   assert(ist                    /* check the function arguments */
      && (n >= 0) && (items || (n <= 0)));
   if (n <= 0)                   /* if the item set is empty, */
     return COUNT(ist->wgt);     /* return the total trans. weight */
-  return COUNT(_getsupp(ist->lvls[0], items, n));
+  return COUNT(_getsupp(ist->lvls, ist->lvls->nodes, items, n));
 }  /* ist_suppx() */            /* return the item set support */
 
 /*--------------------------------------------------------------------*/
 
+static void _marklvl (ISTREE *ist, int k, ISNODE *beg, ISNODE *end,
+                      int mode)
+{                               /* --- mark the sets of a node range */
+  int     i, c;                 /* loop variable, counter position */
+  ISLEVEL *lvl;                 /* level of the nodes */
+  ISNODE  *node;                /* to traverse the nodes */
+  SUPP    supp = -1, s;         /* support of an item set */
+
+  lvl = ist->lvls +k;           /* get the level of the nodes */
+  if ((mode      & IST_EVAL)    /* if maximal sets w.r.t. evaluation */
+  &&  (ist->eval > IST_NONE)) { /* and evaluation measure is given */
+    ist->level = k;             /* note the level for evaluation */
+    for (node = beg; node < end; node++) {
+      ist->node = node;         /* traverse the nodes of the range */
+      c = node->cnts;           /* and get its counter position */
+      for (i = node->size; --i >= 0; ) {
+        ist->index = i;         /* traverse the items in each node */
+        s = _getcnt(lvl, c+i);  /* get the item set support */
+        if ((s               >=  0)
+        && ((s               <  ist->supp)
+        ||  (_aggregate(ist) <  ist->minval))) {
+          _setcnt(lvl, c+i, s | S_SKIP); continue; }
+        if (mode & IST_CLOSED) supp = s;
+        _marksub(ist, lvl, node, i, supp);
+      }                         /* mark relevant n-1 subsets */
+    } }
+  else {                        /* if to use only the support */
+    for (node = beg; node < end; node++) {
+      c = node->cnts;           /* traverse the nodes of the range */
+      for (i = node->size; --i >= 0; ) {
+        s = _getcnt(lvl, c+i);  /* get the item set support */
+        if (s < ist->supp) {
+          _setcnt(lvl, c+i, s | S_SKIP); continue; }
+        if (mode == IST_CLOSED) supp = s;
+        _marksub(ist, lvl, node, i, supp);
+      }                         /* mark all n-1 subsets */
+    }                           /* of the current item set */
+  }
+}  /* _marklvl() */
+
+/*----------------------------------------------------------------------
+The sets of a level only flag their n-1 subsets in the level above and
+their own infrequent counters, while the counters of the level itself
+are only read, so that the nodes of a level can be marked in any order.
+If compiled with IST_THREADS, the nodes are split into contiguous ranges
+of similar size, one per thread, with a copy of the tree that has its
+own path buffer. Several threads may flag the same subset, which is done
+with an atomic update (see _skip()). Lookup tables are built before the
+threads start; the levels are processed one after the other.
+----------------------------------------------------------------------*/
+#ifdef IST_THREADS
+
+static void* _marker (void *data)
+{                               /* --- mark the sets of a node range */
+  WORKER *w = (WORKER*)data;    /* worker data */
+  _marklvl(&w->ist, w->level, w->beg, w->end, w->mode);
+  return NULL;                  /* mark the sets of the nodes */
+}  /* _marker() */
+
+/*--------------------------------------------------------------------*/
+
+static int _markpar (ISTREE *ist, int k, int mode)
+{                               /* --- mark a level in parallel */
+  int     i, n, r = 0;          /* loop variables, result */
+  double  sum, tot;             /* (estimated) work of the nodes */
+  WORKER  *wrk, *w;             /* workers and current worker */
+  ISLEVEL *lvl;                 /* level to mark */
+  ISNODE  *node;                /* to traverse the nodes */
+
+  lvl = ist->lvls +k;           /* get the level to mark */
+  n = (ist->thcnt < lvl->cnt /IST_THDMIN)
+    ?  ist->thcnt : lvl->cnt /IST_THDMIN;
+  if (n <= 1) return 1;         /* check for enough nodes per thread */
+  for (i = k; --i > 0; )        /* build the lookup tables */
+    _hready(ist, ist->lvls +i); /* (workers must not build tables) */
+  wrk = (WORKER*)calloc((size_t)n, sizeof(WORKER));
+  if (!wrk) return 1;           /* create the worker array */
+  for (tot = 0, node = lvl->nodes; node < lvl->nodes +lvl->cnt; node++)
+    tot += node->size;          /* estimate the total work */
+  node = lvl->nodes;            /* traverse the workers */
+  for (sum = 0, i = 0; i < n; i++) {
+    w = wrk +i; w->ist = *ist;  /* copy the tree and get */
+    w->ist.buf = (int*)malloc((size_t)ist->maxht *sizeof(int));
+    if (!w->ist.buf) r = 1;     /* a path buffer of its own */
+    w->level = k; w->mode = mode;
+    w->beg   = node;            /* set the node range of the worker */
+    while ((node < lvl->nodes +lvl->cnt)
+    &&     ((i >= n-1) || (sum < tot *(i+1) /n))) {
+      sum += node->size; node++; }
+    w->end   = node;            /* distribute the nodes so that */
+  }                             /* the workers have similar work */
+  if (r == 0) {                 /* if the workers could be set up */
+    for (i = 1; i < n; i++)     /* start all but the first worker */
+      if (pthread_create(&wrk[i].thread, NULL, _marker, wrk+i) != 0)
+        wrk[i].err = 1;         /* (if a thread cannot be created, */
+    _marker(wrk);               /* the worker is run afterwards) */
+    for (i = 1; i < n; i++) {   /* wait for the workers */
+      if (!wrk[i].err) pthread_join(wrk[i].thread, NULL);
+      else _marker(wrk+i);      /* run workers without a thread */
+    }
+  }                             /* (if the setup failed, */
+  for (i = 0; i < n; i++)       /* the level is marked sequentially) */
+    if (wrk[i].ist.buf) free(wrk[i].ist.buf);
+  free(wrk);                    /* delete the buffers */
+  return r;                     /* and the worker array */
+}  /* _markpar() */
+
+#endif
+/*--------------------------------------------------------------------*/
+
 void ist_mark (ISTREE *ist, int mode)
 {                               /* --- mark frequent item sets */
-  int    i, k;                  /* loop variables */
-  ISNODE *node;                 /* to traverse the nodes */
-  int    supp;                  /* support of an item set */
+  int     i, k;                 /* loop variables */
+  ISLEVEL *lvl;                 /* to traverse the levels */
+  SUPP    supp, s;              /* support of an item set */
 
   assert(ist);                  /* check the function argument */
   if ((mode & ~IST_EVAL) == IST_CLEAR) {
-    ist->wgt &= ~F_SKIP;        /* if to clear all skip flags */
-    for (k = 0; ++k < ist->height; )
-      for (node = ist->lvls[k]; node; node = node->succ)
-        for (i = node->size; --i >= 0; )
-          node->cnts[i] &= ~F_SKIP;
-    return;                     /* clear skip flags of all sets */
-  }                             /* and abort the function */
+    ist->wgt &= ~S_SKIP;        /* if to clear all skip flags */
+    for (k = 0; ++k < ist->height; ) {
+      lvl = ist->lvls +k;       /* traverse the levels */
+      for (i = lvl->ccnt; --i >= 0; )
+        _setcnt(lvl, i, COUNT(_getcnt(lvl, i)));
+    }                           /* clear skip flags of all sets */
+    return;                     /* and abort the function */
+  }
   if ((mode      & IST_EVAL)    /* if maximal sets w.r.t. evaluation */
   &&  (ist->eval > IST_NONE)) { /* and evaluation measure is given */
-    supp = -1;                  /* set default support filter */
     for (k = ist->height; --k > 0; ) {
-      for (node = ist->lvls[k]; node; node = node->succ) {
-        ist->node = node;       /* traverse the node of each level */
-        for (i = node->size; --i >= 0; ) {
-          ist->index = i;       /* traverse the items in each node */
-          if ((node->cnts[i]   >=  0)
-          && ((node->cnts[i]   <  ist->supp)
-          ||  (_aggregate(ist) <  ist->minval))) {
-            node->cnts[i] |= F_SKIP; continue; }
-          if (mode & IST_CLOSED) supp = node->cnts[i];
-          _marksub(ist, node, i, supp);
-	}                       /* traverse the tree bottom up */
-      }                         /* (that is, from leaves to root) */
-    }                           /* and mark relevant n-1 subsets */
+      lvl = ist->lvls +k;       /* traverse the tree bottom up */
+      #ifdef IST_THREADS        /* (that is, from leaves to root) */
+      if (_markpar(ist, k, mode) > 0)
+      #endif                    /* and mark relevant n-1 subsets */
+      _marklvl(ist, k, lvl->nodes, lvl->nodes +lvl->cnt, mode);
+    }
     supp = (mode & IST_CLOSED) ? ist->wgt : ist->supp;
-    node = ist->lvls[0];        /* traverse the root node elements */
-    for (i = node->size; --i >= 0; ) {
-      if ((node->cnts[i] >= supp) || (node->cnts[i] < 0)) {
-        ist->wgt |= F_SKIP; break; }
+    lvl  = ist->lvls;           /* traverse the root node elements */
+    for (i = lvl->nodes->size; --i >= 0; ) {
+      s = _getcnt(lvl, i);      /* traverse the item frequencies */
+      if ((s >= supp) || (s < 0)) {
+        ist->wgt |= S_SKIP; break; }
     } }                         /* mark the empty set if necessary */
   else {                        /* if to use only the support */
     supp = (mode & IST_CLOSED) ? ist->wgt : ist->supp;
-    node = ist->lvls[0];        /* traverse the root node elements */
-    for (i = node->size; --i >= 0; ) {
-      if (node->cnts[i] >= supp) {
-        ist->wgt |= F_SKIP; break; }
+    lvl  = ist->lvls;           /* traverse the root node elements */
+    for (i = lvl->nodes->size; --i >= 0; ) {
+      if (_getcnt(lvl, i) >= supp) {
+        ist->wgt |= S_SKIP; break; }
     }                           /* mark the empty set if necessary */
-    supp = -1;                  /* set default support filter */
     for (k = 0; ++k < ist->height; ) {
-      for (node = ist->lvls[k]; node; node = node->succ) {
-        for (i = node->size; --i >= 0; ) {
-          if (node->cnts[i] < ist->supp) {
-            node->cnts[i] |= F_SKIP; continue; }
-          if (mode == IST_CLOSED) supp = node->cnts[i];
-          _marksub(ist, node, i, supp);
-        }                       /* traverse the tree top down */
-      }                         /* (that is, from root to leaves) */
-    }                           /* and mark all n-1 subsets */
-  }                             /* of the current item set */
+      lvl = ist->lvls +k;       /* traverse the tree top down */
+      #ifdef IST_THREADS        /* (that is, from root to leaves) */
+      if (_markpar(ist, k, mode) > 0)
+      #endif                    /* and mark all n-1 subsets */
+      _marklvl(ist, k, lvl->nodes, lvl->nodes +lvl->cnt, mode);
+    }                           /* of the item sets of each level */
+  }
 }  /* ist_mark() */
 
 /*--------------------------------------------------------------------*/
@@ -1147,6 +2955,19 @@ void ist_setsize (ISTREE *ist, int min, int max, int dir)
 
 /*--------------------------------------------------------------------*/
 
+void ist_setroot (ISTREE *ist, int beg, int end)
+{                               /* --- set the range of first items */
+  int n;                        /* number of items */
+
+  assert(ist);                  /* check the function argument */
+  n = ist->lvls->ccnt;          /* get the number of items */
+  if ((end < 0) || (end > n)) end = n;
+  ist->beg = (beg < 0) ? 0 : beg;     /* only the subtrees of the items */
+  ist->end = end;               /* in [beg,end) are grown and reported */
+}  /* ist_setroot() */
+
+/*--------------------------------------------------------------------*/
+
 void ist_seteval (ISTREE *ist, int eval, int agg, double minval,
                   int prune)
 {                               /* --- set additional evaluation */
@@ -1165,19 +2986,24 @@ void ist_init (ISTREE *ist)
 {                               /* --- initialize (rule) extraction */
   assert(ist);                  /* check the function argument */
   if (ist->maxsz > ist->height)  ist->maxsz = ist->height;
+  while ((ist->maxsz > 0) && (ist->lvls[ist->maxsz-1].cnt <= 0))
+    ist->maxsz--;               /* skip levels emptied by pruning */
   ist->size  = (ist->dir >= 0) ? ist->minsz : ist->maxsz;
-  ist->node  = ist->lvls[(ist->size > 0) ? ist->size -1 : 0];
+  ist->level = (ist->size > 0) ? ist->size -1 : 0;
+  ist->node  = ist->lvls[ist->level].nodes;
   ist->index = ist->item = -1;  /* initialize the */
   ist->head  = NULL;            /* extraction variables */
+  ist->hlvl  = 0;
 }  /* ist_init() */
 
 /*--------------------------------------------------------------------*/
 
-static int _emptyset (ISTREE *ist, int *supp, double *eval)
+static int _emptyset (ISTREE *ist, SUPP *supp, double *eval)
 {                               /* --- whether to report empty set */
   assert(ist);                  /* check the function argument */
   ist->size += ist->dir;        /* immediately go the next level */
-  if ((ist->wgt >= ist->supp)   /* if the empty set qualifies */
+  if ((ist->beg <= 0)           /* if the first subtrees are grown */
+  &&  (ist->wgt >= ist->supp)   /* and the empty set qualifies */
   &&  (ist->wgt <= ist->smax)   /* (w.r.t. support and evaluation) */
   && ((ist->eval == IST_NONE) || (ist->minval <= 0))) {
     if (supp) *supp = COUNT(ist->wgt);
@@ -1189,13 +3015,14 @@ static int _emptyset (ISTREE *ist, int *supp, double *eval)
 
 /*--------------------------------------------------------------------*/
 
-int ist_set (ISTREE *ist, int *set, int *supp, double *eval)
+int ist_set (ISTREE *ist, int *set, SUPP *supp, double *eval)
 {                               /* --- extract next frequent item set */
-  int    i;                     /* loop variable */
-  int    item;                  /* an item identifier */
-  ISNODE *node;                 /* current item set node */
-  int    s_set;                 /* support of the current set */
-  double val;                   /* value of evaluation measure */
+  int     i;                    /* loop variable */
+  int     item;                 /* an item identifier */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node;                /* current item set node */
+  SUPP    s_set;                /* support of the current set */
+  double  val;                  /* value of evaluation measure */
 
   assert(ist && set);           /* check the function arguments */
   if ((ist->size < ist->minsz)  /* if below the minimal size */
@@ -1206,33 +3033,39 @@ int ist_set (ISTREE *ist, int *set, int *supp, double *eval)
     return  0;                  /* check whether it qualifies */
 
   /* --- find frequent item set --- */
-  node = ist->node;             /* get the current item set node */
+  lvl  = ist->lvls +ist->level; /* get the current item set node */
+  node = ist->node;             /* and its level */
   while (1) {                   /* search for a frequent item set */
     if (++ist->index >= node->size) { /* if all subsets have been */
-      node = node->succ;        /* processed, go to the successor */
-      if (!node) {              /* if at the end of a level, */
-        ist->size += ist->dir;  /* go to the next level */
+      if (++node >= lvl->nodes +lvl->cnt) {   /* processed, go to */
+        ist->size += ist->dir;  /* the successor or the next level */
         if ((ist->size < ist->minsz)
         ||  (ist->size > ist->maxsz))
           return -1;            /* if outside size range, abort */
         if ((ist->size == 0)    /* if to report the empty item set */
         &&  _emptyset(ist, supp, eval))
           return  0;            /* check whether it qualifies */
-        node = ist->lvls[ist->size -1];
-      }                         /* get the 1st node of the new level */
+        if (ist->size <= 0)     /* if there is no further level, */
+          return -1;            /* abort the function */
+        lvl  = ist->lvls +(ist->level = ist->size -1);
+        node = lvl->nodes;      /* get the 1st node of the new level */
+      }
       ist->node  = node;        /* note the new item set node */
-      ist->index = 0;           /* start with the first item set */
-    }                           /* of the new item set node */
-    if (node->offset >= 0) item = node->offset +ist->index;
-    else                   item = node->cnts[node->size +ist->index];
+      ist->index = -1;          /* start with the first item set */
+      continue;                 /* of the new item set node */
+    }                           /* (or go to the next level) */
+    item = _item(lvl, node, ist->index);
     if (ib_getapp(ist->base, item) == APP_NONE)
       continue;                 /* skip items to ignore */
-    s_set = node->cnts[ist->index];
+    if ((node->parent < 0)      /* skip root items outside */
+    &&  ((item < ist->beg) || (item >= ist->end)))
+      continue;                 /* the range of grown subtrees */
+    s_set = _getcnt(lvl, node->cnts +ist->index);
     if ((s_set < ist->supp)     /* if the support is not sufficient */
     ||  (s_set > ist->smax))    /* or larger than the maximum, */
       continue;                 /* go to the next item set */
     /* Note that this check automatically skips all item sets that */
-    /* are marked with the flag F_SKIP, because s_set is negative  */
+    /* are marked with the flag S_SKIP, because s_set is negative  */
     /* with this flag and thus necessarily smaller than ist->supp. */
     if (ist->eval <= IST_NONE){ /* if no add. eval. measure given */
       val = 0; break; }         /* abort the loop (select the set) */
@@ -1246,28 +3079,26 @@ int ist_set (ISTREE *ist, int *set, int *supp, double *eval)
   /* --- build frequent item set --- */
   i        = ist->size;         /* get the current item set size */
   set[--i] = item;              /* and store the first item */
-  while (node->parent) {        /* while not at the root node */
-    set[--i] = ID(node);        /* add item to the item set */
-    node = node->parent;        /* and go to the parent node */
-  }
+  for ( ; node->parent >= 0; node = PARENT(lvl, node), lvl--)
+    set[--i] = ID(node);        /* add the items on the path */
   return ist->size;             /* return the item set size */
 }  /* ist_set() */
 
 /*--------------------------------------------------------------------*/
 
 int ist_rule (ISTREE *ist, int *rule,
-              int *supp, int *body, int *head, double *eval)
+              SUPP *supp, SUPP *body, SUPP *head, double *eval)
 {                               /* --- extract next association rule */
-  int    i;                     /* loop variable */
-  int    item;                  /* an item identifier */
-  ISNODE *node;                 /* current item set node */
-  ISNODE *parent;               /* parent of the item set node */
-  int    *map, n;               /* identifier map and its size */
-  int    s_set;                 /* support of set  (body & head) */
-  int    s_body;                /* support of body (antecedent) */
-  int    s_head;                /* support of head (consequent) */
-  double val;                   /* value of evaluation measure */
-  int    app;                   /* appearance flag of head item */
+  int     i;                    /* loop variable */
+  int     item;                 /* an item identifier */
+  ISLEVEL *lvl;                 /* level of the current node */
+  ISNODE  *node;                /* current item set node */
+  ISNODE  *parent;              /* parent of the item set node */
+  SUPP    s_set;                /* support of set  (body & head) */
+  SUPP    s_body;               /* support of body (antecedent) */
+  SUPP    s_head;               /* support of head (consequent) */
+  double  val;                  /* value of evaluation measure */
+  int     app;                  /* appearance flag of head item */
 
   assert(ist && rule);          /* check the function arguments */
   if (ist->size == 0)           /* if at the empty item set, */
@@ -1277,62 +3108,66 @@ int ist_rule (ISTREE *ist, int *rule,
     return -1;                  /* abort the function */
 
   /* --- find rule --- */
-  node = ist->node;             /* get the current item set node */
+  lvl  = ist->lvls +ist->level; /* get the current item set node */
+  node = ist->node;             /* and its level */
   while (1) {                   /* search for a rule */
     if (ist->item >= 0) {       /* --- select next item subset */
       *--ist->path = ist->item; /* add previous head to the path */
       ist->item = ID(ist->head);/* and get the next head item */
-      ist->head = ist->head->parent;
-      if (!ist->head)           /* if all subsets have been processed */
+      if (ist->head->parent < 0)/* if all subsets have been processed */
         ist->item = -1;         /* clear the head item to trigger the */
-    }                           /* selection of a new item set */
+      else {                    /* selection of a new item set, */
+        ist->head = PARENT(ist->lvls +ist->hlvl, ist->head);
+        ist->hlvl--;            /* otherwise go to the parent node */
+      }                         /* of the current head item node */
+    }
     if (ist->item < 0) {        /* --- select next item set */
       if (++ist->index >= node->size){/* if all subsets have been */
-        node = node->succ;      /* processed, go to the successor */
-        if (!node) {            /* if at the end of a level, go down */
+        if (++node >= lvl->nodes +lvl->cnt) {   /* processed, */
           ist->size += ist->dir;/* go to the next level */
           if ((ist->size < ist->minsz) || (ist->size <= 0)
           ||  (ist->size > ist->maxsz))
             return -1;          /* if outside the size range, abort */
-          node = ist->lvls[ist->size -1];
-        }                       /* get the 1st node of the new level */
-        ist->node = node;       /* note the new item set node and */
-        ist->index  = 0;        /* start with the first item set */
-      }                         /* of the new item set node */
-      if (node->offset >= 0) item = node->offset +ist->index;
-      else                   item = node->cnts[node->size +ist->index];
-      app = ib_getapp(ist->base, item);
+          lvl  = ist->lvls +(ist->level = ist->size -1);
+          node = lvl->nodes;    /* get the 1st node of the new level */
+        }
+        ist->node  = node;      /* note the new item set node and */
+        ist->index = -1;        /* start with the first item set */
+        continue;               /* of the new item set node */
+      }                         /* (or go to the next level) */
+      item = _item(lvl, node, ist->index);
+      app  = ib_getapp(ist->base, item);
       if ((app == APP_NONE) || ((app == APP_HEAD) && HDONLY(node)))
         continue;               /* skip sets with two head only items */
       ist->item   = item;       /* set the head item identifier */
       ist->hdonly = (app == APP_HEAD) || HDONLY(node);
       ist->head   = node;       /* set the new head item node */
+      ist->hlvl   = ist->level; /* and its level */
       ist->path   = ist->buf +ist->maxht;
     }                           /* clear the path (reinitialize it) */
     app = ib_getapp(ist->base, ist->item);
     if (!(app &  APP_HEAD)      /* get head item appearance indicator */
     ||  ((app != APP_HEAD) && ist->hdonly))
       continue;                 /* if rule is not allowed, skip it */
-    s_set = COUNT(node->cnts[ist->index]);
+    s_set = COUNT(_getcnt(lvl, node->cnts +ist->index));
     if ((s_set < ist->supp)     /* if the support is not sufficient */
     ||  (s_set > ist->smax)) {  /* or larger than the maximum, */
       ist->item = -1; continue; }   /* go to the next item set */
-    parent = node->parent;      /* get the parent node */
-    n = (int)(ist->buf +ist->maxht -ist->path);
-    if (n > 0)                  /* if there is a path, use it */
-      s_body = COUNT(_getsupp(ist->head, ist->path, n));
-    else if (!parent)           /* if there is no parent (root node), */
+    i = (int)(ist->buf +ist->maxht -ist->path);
+    if (i > 0)                  /* if there is a path, use it */
+      s_body = COUNT(_lookup(ist, ist->lvls +ist->hlvl, ist->head,
+                             ist->path, i));
+    else if (node->parent < 0)  /* if there is no parent (root node), */
       s_body = COUNT(ist->wgt); /* get the total trans. weight */
-    else if (parent->offset >= 0)  /* if a pure array is used */
-      s_body = COUNT(parent->cnts[ID(node) -parent->offset]);
-    else {                      /* if an identifier map is used */
-      map = parent->cnts +(n = parent->size);
-      s_body = COUNT(parent->cnts[int_bsearch(ID(node), map, n)]);
+    else {                      /* if there is a parent node */
+      parent = PARENT(lvl, node);
+      i      = _index(lvl-1, parent, ID(node));
+      s_body = COUNT(_getcnt(lvl-1, parent->cnts +i));
     }                           /* find array index and get support */
     if ((s_body < ist->rule)    /* if the body support is too low */
     ||  (s_set  < s_body *ist->conf))       /* or the confidence, */
       continue;                 /* go to the next item (sub)set */
-    s_head = COUNT(ist->lvls[0]->cnts[ist->item]);
+    s_head = COUNT(_getcnt(ist->lvls, ist->item));
     if ((ist->eval <= IST_NONE) /* if no add. eval. measure given */
     ||  !_evalfns[ist->eval]) { /* or the measure does not exist, */
       val = 0; break; }         /* abort the loop (select the rule) */
@@ -1346,88 +3181,94 @@ int ist_rule (ISTREE *ist, int *rule,
   if (eval) *eval = val;        /* the value of the add. measure */
 
   /* --- build rule --- */
-  if (node->offset >= 0) item = node->offset +ist->index;
-  else                   item = node->cnts[node->size +ist->index];
+  item = _item(lvl, node, ist->index);
   i = ist->size;                /* get the current item and */
   if (item != ist->item)        /* if this item is not the head, */
     rule[--i] = item;           /* add it to the rule body */
-  while (node->parent) {        /* traverse the path to the root */
-    if (ID(node) != ist->item)  /* and add all items on this */
-      rule[--i] = ID(node);     /* path to the rule body */
-    node = node->parent;        /* (except the head of the rule) */
-  }
-  rule[0] = ist->item;          /* set the head of the rule, */
-  return ist->size;             /* return the rule size */
-}  /* ist_rule() */
+  for ( ; node->parent >= 0; node = PARENT(lvl, node), lvl--)
+    if (ID(node) != ist->item)  /* traverse the path to the root */
+      rule[--i] = ID(node);     /* and add all items on this path */
+  rule[0] = ist->item;          /* to the rule body (except the head */
+  return ist->size;             /* of the rule), set the rule head, */
+}  /* ist_rule() */             /* and return the rule size */
 
 /*--------------------------------------------------------------------*/
 
-static int _report (ISTREE *ist, ISREPORT *rep, ISNODE *node, int supp)
+static int _report (ISTREE *ist, ISREPORT *rep,
+                    ISLEVEL *lvl, ISNODE *node, SUPP supp)
 {                               /* --- recursive item set reporting */
   int    i, k, c, n = 0;        /* loop variable, set counter */
-  int    spx;                   /* support for perfect extension */
+  SUPP   spx;                   /* support for perfect extension */
   int    off;                   /* item offset */
+  int    o;                     /* index of the first counter */
   int    *map;                  /* item identifier map */
-  ISNODE **chn;                 /* child node array */
+  int    *chn;                  /* child node array */
+  ISNODE *cld;                  /* nodes of the next level */
 
   assert(ist && rep);           /* check the function arguments */
+  o    = node->cnts;            /* get the counter position */
   if (!(ist->mode & IST_PERFECT))  /* if no perfext extension pruning */
-    spx = INT_MAX;              /* clear perfect extension support */
+    spx = SUPP_MAX;             /* clear perfect extension support */
   else {                        /* if perfect extensions pruning */
     spx = supp;                 /* note the parent set support */
     for (i = 0; i < node->size; i++) {
-      if (COUNT(node->cnts[i]) < spx) continue;
-      if (node->offset >= 0) k = i +node->offset;
-      else k = node->cnts[node->size +i];
-      isr_addpex(rep, k);       /* traverse the node's items and */
-    }                           /* collect the perfect extensions */
-  }                             /* in the item set reporter */
+      if (COUNT(_getcnt(lvl, o+i)) < spx) continue;
+      isr_addpex(rep, _item(lvl, node, i));
+    }                           /* traverse the node's items and */
+  }                             /* collect the perfect extensions */
   if ((supp >= 0)               /* if current item set is not marked */
-  &&  (supp <= ist->smax))      /* and does not exceed max. support, */
-    n += isr_report(rep);       /* report the current item set */
-  if (node->offset >= 0) {      /* if a pure array is used */
-    chn = (ISNODE**)(node->cnts +node->size +PAD(node->size));
-    c   = CHCNT(node);          /* get the child node array */
-    off = (c > 0) ? ID(chn[0]) : 0;
+  &&  (supp <= ist->smax)       /* and does not exceed max. support */
+  &&  ((lvl > ist->lvls) || (ist->beg <= 0)))  /* (empty set only */
+    n += isr_report(rep);       /* once), report the current item set */
+  chn = CHN(lvl, node);         /* get the child node array */
+  cld = lvl[1].nodes;           /* and the nodes of the next level */
+  c   = CHCNT(node);            /* and the number of children */
+  if ((node->offset >= 0)       /* if a pure array */
+  ||  BITMAP(node)) {           /* or a bitmap is used */
+    off = ((c > 0) && (node->offset >= 0))
+        ? ID(cld +chn[0]) -node->offset : 0;
     for (i = 0; i < node->size; i++) {
-      supp = COUNT(node->cnts[i]);
-      if ((supp <  ist->supp)   /* traverse the node's items and */
-      ||  (supp >= spx))        /* check against minimum support */
-        continue;               /* and the parent set support */
+      if ((node->parent < 0)    /* skip the root items whose */
+      &&  ((i < ist->beg) || (i >= ist->end)))   /* subtrees */
+        continue;               /* are not grown */
+      supp = COUNT(_getcnt(lvl, o+i)); /* traverse the node's items */
+      if ((supp <  ist->supp)   /* check against minimum support */
+      ||  (supp >= spx))        /* and the parent set support */
+        continue;
       ist->node  = node;        /* store the node and the index */
       ist->index = i;           /* in the node for evaluation */
-      k = node->offset +i;      /* compute the item identifier */
+      ist->level = (int)(lvl -ist->lvls);
+      k = _item(lvl, node, i);  /* get the item identifier */
       isr_add(rep, k, supp);    /* add the item to the reporter */
-      supp = node->cnts[i];     /* get the item support (with flag) */
-      k -= off;                 /* compute the child node index */
+      supp = _getcnt(lvl, o+i); /* get the item support (with flag) */
+      k = i -off;               /* compute the child node index */
       if ((k >= 0)              /* if the corresp. child node exists, */
-      &&  (k <  c) && chn[k])   /* recursively report the subtree */
-        n += _report(ist, rep, chn[k], supp);
+      &&  (k <  c) && (chn[k] >= 0))   /* recursively report subtree */
+        n += _report(ist, rep, lvl+1, cld +chn[k], supp);
       else if ((supp >= 0)      /* if the item set is not marked */
       &&       (supp <= ist->smax))
         n += isr_report(rep);   /* report the current item set */
       isr_remove(rep, 1);       /* remove the last item */
     } }                         /* from the current item set */
   else {                        /* if an identifier map is used */
-    map = node->cnts +(k = node->size);
-    chn = (ISNODE**)(map +k +PAD(k)); /* get the item id map */
-    c   = CHCNT(node);          /* and the child node array  */
-    c   = (c > 0) ? ID(chn[c-1]) : -1;
+    map = MAP(lvl, node);       /* get the identifier map */
+    c   = (c > 0) ? ID(cld +chn[c-1]) : -1;
     for (i = 0; i < node->size; i++) {
-      supp = COUNT(node->cnts[i]);
-      if ((supp <  ist->supp)   /* traverse the node's items and */
-      ||  (supp >= spx))        /* check against minimum support */
-        continue;               /* and the parent set support */
+      supp = COUNT(_getcnt(lvl, o+i)); /* traverse the node's items */
+      if ((supp <  ist->supp)   /* check against minimum support */
+      ||  (supp >= spx))        /* and the parent set support */
+        continue;
       ist->node  = node;        /* store the node and the index */
       ist->index = i;           /* in the node for evaluation */
+      ist->level = (int)(lvl -ist->lvls);
       k = map[i];               /* retrieve the item identifier */
       isr_add(rep, k, supp);    /* add the item to the reporter */
-      supp = node->cnts[i];     /* get the item support (with flag) */
+      supp = _getcnt(lvl, o+i); /* get the item support (with flag) */
       if (k <= c)               /* if there may be a child node, */
-        while (k > ID(*chn)) chn++;  /* skip the preceding items */
+        while (k > ID(cld +*chn)) chn++; /* skip preceding items */
       if ((k <= c)              /* if the corresp. child node exists, */
-      &&  (k == ID(*chn)))      /* recursively report the subtree */
-        n += _report(ist, rep, *chn, supp);
+      &&  (k == ID(cld +*chn))) /* recursively report the subtree */
+        n += _report(ist, rep, lvl+1, cld +*chn, supp);
       else if ((supp >= 0)      /* if the item set is not marked */
       &&       (supp <= ist->smax))
         n += isr_report(rep);   /* report the current item set */
@@ -1442,7 +3283,7 @@ static int _report (ISTREE *ist, ISREPORT *rep, ISNODE *node, int supp)
 int ist_report (ISTREE *ist, ISREPORT *rep)
 {                               /* --- recursive item set reporting */
   assert(ist && rep);           /* check the function arguments */
-  return _report(ist, rep, ist->lvls[0], ist->wgt);
+  return _report(ist, rep, ist->lvls, ist->lvls->nodes, ist->wgt);
 }  /* ist_report() */           /* recursively report item sets */
 
 /*--------------------------------------------------------------------*/
@@ -1471,26 +3312,27 @@ double ist_evalx (ISREPORT *rep, void *data)
 /*--------------------------------------------------------------------*/
 #ifndef NDEBUG
 
-static void _showtree (ISNODE *node, ITEMBASE *base, int level)
+static void _showtree (ISLEVEL *lvl, ISNODE *node,
+                       ITEMBASE *base, int level)
 {                               /* --- show subtree */
-  int    i, k, cnt;             /* loop variables, number of children */
-  ISNODE **chn;                 /* child node array */
+  int i, k, cnt;                /* loop variables, number of children */
+  int *chn;                     /* child node array */
 
-  assert(node && (level >= 0)); /* check the function arguments */
-  i   = (node->offset < 0) ? node->size : PAD(node->size);
-  chn = (ISNODE**)(node->cnts +node->size +i);
-  cnt = CHCNT(node);            /* get the child node array */
+  assert(lvl && node && (level >= 0)); /* check the arguments */
+  chn = CHN(lvl, node);         /* get the child node array */
+  cnt = CHCNT(node);            /* and the number of children */
   for (i = 0; i < node->size; i++) {
     for (k = level; --k >= 0; ) /* indent and print */
       printf("   ");            /* item identifier and counter */
-    if (node->offset >= 0) k = node->offset +i;
-    else                   k = node->cnts[node->size +i];
-    printf("%s: %d\n", ib_name(base, k), COUNT(node->cnts[i]));
+    k = _item(lvl, node, i);    /* get the item identifier */
+    printf("%s: " SUPP_FMT "\n", ib_name(base, k),
+           COUNT(_getcnt(lvl, node->cnts +i)));
     if (cnt <= 0) continue;     /* check whether there are children */
-    if (node->offset >= 0) k -= ID(chn[0]);
-    else                   k  = _search(k, chn, cnt);
-    if ((k >= 0) && (k < cnt) && chn[k])
-      _showtree(chn[k], base, level +1);
+    if      (node->offset >= 0) k -= ID(lvl[1].nodes +chn[0]);
+    else if (BITMAP(node))      k  = i;
+    else                        k  = _search(k, chn, cnt, lvl[1].nodes);
+    if ((k >= 0) && (k < cnt) && (chn[k] >= 0))
+      _showtree(lvl+1, lvl[1].nodes +chn[k], base, level +1);
   }                             /* show subtree recursively */
 }  /* _showtree() */
 
@@ -1499,8 +3341,8 @@ static void _showtree (ISNODE *node, ITEMBASE *base, int level)
 void ist_show (ISTREE *ist)
 {                               /* --- show an item set tree */
   assert(ist);                  /* check the function argument */
-  _showtree(ist->lvls[0], ist->base, 0);
-  printf("total: %d\n", COUNT(ist->wgt));
+  _showtree(ist->lvls, ist->lvls->nodes, ist->base, 0);
+  printf("total: " SUPP_FMT "\n", COUNT(ist->wgt));
 }  /* ist_show() */             /* show the nodes recursively */
 
 #endif
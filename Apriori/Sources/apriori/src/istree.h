@@ -20,6 +20,7 @@ Instrutor: Luiz Camolesi
 
 /* --- operation modes --- */
 #define IST_PERFECT  INT_MIN    /* prune with perfect extensions */
+#define IST_WINDOW   0x1000     /* sliding window (counters may grow) */
 
 /* --- additional evaluation measures --- */
 #define IST_NONE       0        /* no measure */
@@ -40,6 +41,12 @@ Instrutor: Luiz Camolesi
 #define IST_MAX        2        /* maximum of measure values */
 #define IST_AVG        3        /* average of measure values */
 
+/* --- support counter widths --- */
+#define CW_CHAR        0        /* signed char counters */
+#define CW_SHORT       1        /* short int counters */
+#define CW_INT         2        /* int counters */
+#define CW_SUPP        3        /* full width (SUPP) counters */
+
 /* --- item set mark modes --- */
 #define IST_CLEAR      0        /* clear markers */
 #define IST_CLOSED     1        /* closed  item sets (mark complement)*/
@@ -49,44 +56,77 @@ Instrutor: Luiz Camolesi
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
-typedef struct _isnode {        /* --- item set node --- */
-  struct _isnode *parent;       /* parent node */
-  struct _isnode *succ;         /* successor node on same level */
-  int            id;            /* item id used in parent node */
-  int            size;          /* size   of counter array */
-  int            offset;        /* offset of counter array */
-  int            chcnt;         /* number of child nodes */
-  int            cnts[1];       /* counter array (weights) */
+typedef struct {                /* --- item set node --- */
+  int      parent;              /* parent node (index in prev. level) */
+  int      id;                  /* item id used in parent node */
+  int      size;                /* size   of counter array */
+  int      offset;              /* offset of counter array */
+  int      chcnt;               /* number of child nodes */
+  int      cnts;                /* index of counters in level array */
+  int      chn;                 /* index of child ids in level array */
 } ISNODE;                       /* (item set node) */
 
+typedef struct {                /* --- item set tree level --- */
+  int      cnt;                 /* number of nodes on the level */
+  int      nsz;                 /* size of the node array */
+  ISNODE   *nodes;              /* nodes (in traversal order) */
+  int      ccnt;                /* number of support counters */
+  int      csz;                 /* size of the counter array */
+  int      cw;                  /* width of the counters (CW_*) */
+  void     *cnts;               /* support counters of all nodes */
+  int      mcnt;                /* number of identifier map elements */
+  int      msz;                 /* size of the identifier map array */
+  int      *map;                /* identifier maps of all nodes */
+  int      kcnt;                /* number of child indices */
+  int      ksz;                 /* size of the child index array */
+  int      *chn;                /* child node indices (next level) */
+  int      hsz;                 /* size of the subset lookup table */
+  int      *hash;               /* subset lookup table (see _hfind()) */
+  int      spec;                /* whether counted with next level */
+} ISLEVEL;                      /* (item set tree level) */
+
 typedef struct {                /* --- item set tree --- */
   ITEMBASE *base;               /* underlying item base */
   int      mode;                /* search mode (e.g. support def.) */
-  int      wgt;                 /* total weight of transactions */
+  SUPP     wgt;                 /* total weight of transactions */
   int      height;              /* tree height (number of levels) */
   int      maxht;               /* max. height (size of level array) */
-  ISNODE   **lvls;              /* first node of each level */
-  int      rule;                /* minimal support of an assoc. rule */
-  int      supp;                /* minimal support of an item set */
-  int      smax;                /* maximal support of an item set */
+  ISLEVEL  *lvls;               /* node arrays of all levels */
+  SUPP     rule;                /* minimal support of an assoc. rule */
+  SUPP     supp;                /* minimal support of an item set */
+  SUPP     smax;                /* maximal support of an item set */
   double   conf;                /* minimal confidence of a rule */
   int      eval;                /* additional evaluation measure */
   int      agg;                 /* aggregation mode of measure values */
   double   minval;              /* minimal evaluation measure value */
   ISNODE   *curr;               /* current node for traversal */
+  int      clvl;                /* level of the current node */
   int      size;                /* current size of an item set */
   int      minsz;               /* minimal size of an item set */
   int      maxsz;               /* maximal size of an item set */
   int      dir;                 /* direction for output acc. to size */
   ISNODE   *node;               /* item set node for extraction */
   int      index;               /* index in item set node */
+  int      level;               /* level of the item set node */
   ISNODE   *head;               /* head item node for extraction */
+  int      hlvl;                /* level of the head item node */
   int      prune;               /* start level for evaluation pruning */
   int      item;                /* head item of previous rule */
   int      *buf;                /* buffer for paths (support check) */
   int      *path;               /* current path / (partial) item set */
   int      hdonly;              /* head only item in current set */
   int      *map;                /* to create identifier maps */
+  SUPP     *dhp;                /* hash bucket counters (DHP) */
+  int      dhpsz;               /* number of hash buckets */
+  int      dhpk;                /* size of the hashed item sets */
+  int      thcnt;               /* number of threads (addlvl()/mark()) */
+  size_t   maxmem;              /* memory budget for ist_addlvl() */
+  int      beg;                 /* first item of the grown subtrees */
+  int      end;                 /* end   item of the grown subtrees */
+  SUPP     *tops;               /* min-heap of the best supports */
+  int      topk;                /* number of item sets to find */
+  int      tcnt;                /* number of supports in the heap */
+  int      tlvl;                /* next level to add to the heap */
 #ifdef BENCH                    /* if benchmark version */
   int      ndcnt;               /* number of item set tree nodes */
   int      ndprn;               /* number of pruned tree nodes */
@@ -97,6 +137,9 @@ typedef struct {                /* --- item set tree --- */
   int      cpcnt;               /* number of created child pointers */
   int      cpnec;               /* number of necessary child pointers */
   int      cpprn;               /* number of pruned child pointers */
+  int      dhprn;               /* number of counters pruned by DHP */
+  size_t   memsz;               /* number of bytes used by the tree */
+  size_t   cntsz;               /* number of bytes used by counters */
 #endif
 } ISTREE;                       /* (item set tree) */
 
@@ -104,30 +147,53 @@ typedef struct {                /* --- item set tree --- */
   Functions
 ----------------------------------------------------------------------*/
 extern ISTREE* ist_create  (ITEMBASE *base, int mode,
-                            int supp, int smax, double conf);
+                            SUPP supp, SUPP smax, double conf);
 extern void    ist_delete  (ISTREE *ist);
 extern int     ist_itemcnt (ISTREE *ist);
+extern int     ist_dhp     (ISTREE *ist, int size);
+extern void    ist_setsupp (ISTREE *ist, SUPP supp);
+extern int     ist_topk    (ISTREE *ist, int k, int min);
+extern SUPP    ist_raise   (ISTREE *ist);
 
 extern void    ist_count   (ISTREE *ist,
-                            const int *items, int n, int wgt);
+                            const int *items, int n, SUPP wgt);
 extern void    ist_countt  (ISTREE *ist, const TRACT  *tract);
-extern void    ist_countb  (ISTREE *ist, const TABAG  *bag);
+extern void    ist_countb  (ISTREE *ist, TABAG  *bag, int trim);
 extern void    ist_countx  (ISTREE *ist, const TATREE *tree);
+extern void    ist_countall(ISTREE *ist,
+                            const int *items, int n, SUPP wgt);
+extern void    ist_slide   (ISTREE *ist,
+                            const int *items, int n, SUPP wgt);
+extern int     ist_window  (ISTREE *ist, int flag);
+extern int     ist_cands   (ISTREE *ist, TABAG *bag);
+extern void    ist_clear   (ISTREE *ist);
+extern int     ist_border  (ISTREE *ist);
+extern int     ist_fup     (ISTREE *ist, TABAG *bag, SUPP bound,
+                            const TATREE *tree, TABAG *old);
+extern int     ist_save    (ISTREE *ist, FILE *file);
 
 extern void    ist_prune   (ISTREE *ist);
 extern int     ist_check   (ISTREE *ist, int *marks);
 extern int     ist_addlvl  (ISTREE *ist);
+extern int     ist_addspec (ISTREE *ist, int max);
+extern void    ist_commit  (ISTREE *ist);
 
 extern int     ist_height  (ISTREE *ist);
-extern int     ist_getwgt  (ISTREE *ist);
-extern int     ist_setwgt  (ISTREE *ist, int wgt);
-extern int     ist_incwgt  (ISTREE *ist, int wgt);
+extern int     ist_nodecnt (ISTREE *ist, int lvl);
+extern int     ist_ccnt    (ISTREE *ist, int lvl);
+extern SUPP    ist_getwgt  (ISTREE *ist);
+extern SUPP    ist_setwgt  (ISTREE *ist, SUPP wgt);
+extern SUPP    ist_incwgt  (ISTREE *ist, SUPP wgt);
+extern int     ist_setthcnt(ISTREE *ist, int cnt);
+extern size_t  ist_setmaxmem(ISTREE *ist, size_t size);
+extern SUPP    ist_getsupp (ISTREE *ist);
+extern void    ist_setroot (ISTREE *ist, int beg, int end);
 
 extern void    ist_up      (ISTREE *ist, int root);
 extern int     ist_down    (ISTREE *ist, int item);
 extern int     ist_next    (ISTREE *ist, int item);
-extern int     ist_supp    (ISTREE *ist, int item);
-extern int     ist_suppx   (ISTREE *ist, int *items, int cnt);
+extern SUPP    ist_supp    (ISTREE *ist, int item);
+extern SUPP    ist_suppx   (ISTREE *ist, int *items, int cnt);
 
 extern void    ist_mark    (ISTREE *ist, int mode);
 extern void    ist_setsize (ISTREE *ist, int min, int max, int dir);
@@ -135,10 +201,10 @@ extern void    ist_seteval (ISTREE *ist, int eval, int agg, double min,
                             int prune);
 
 extern void    ist_init    (ISTREE *ist);
-extern int     ist_set     (ISTREE *ist, int *items, int *supp,
+extern int     ist_set     (ISTREE *ist, int *items, SUPP *supp,
                             double *eval);
-extern int     ist_rule    (ISTREE *ist, int *rule,  int *supp,
-                            int *body, int *head, double *eval);
+extern int     ist_rule    (ISTREE *ist, int *rule,  SUPP *supp,
+                            SUPP *body, SUPP *head, double *eval);
 
 extern int     ist_report  (ISTREE *ist, ISREPORT *rep);
 extern double  ist_eval    (ISTREE *ist);
@@ -151,10 +217,15 @@ extern void    ist_show    (ISTREE *ist);
 /*----------------------------------------------------------------------
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
-#define ist_itemcnt(t)     ((t)->levels[0]->size)
+#define ist_itemcnt(t)     ((t)->lvls[0].nodes->size)
 #define ist_height(t)      ((t)->height)
-#define ist_getwgt(t)      ((t)->wgt & ~INT_MIN)
+#define ist_nodecnt(t,l)   ((t)->lvls[l].cnt)
+#define ist_ccnt(t,l)      ((t)->lvls[l].ccnt)
+#define ist_getwgt(t)      ((t)->wgt & ~SUPP_MIN)
 #define ist_setwgt(t,n)    ((t)->wgt = (n))
-#define ist_incwgt(t,n)    ((t)->wgt = ((t)->wgt & ~INT_MIN) +(n))
+#define ist_incwgt(t,n)    ((t)->wgt = ((t)->wgt & ~SUPP_MIN) +(n))
+#define ist_setthcnt(t,n)  ((t)->thcnt = (n))
+#define ist_setmaxmem(t,n) ((t)->maxmem = (n))
+#define ist_getsupp(t)     ((t)->rule)
 
 #endif
@@ -0,0 +1,335 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "lcm.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+
+/* LCM finds the closed item sets directly, without enumerating the  */
+/* other frequent item sets (T. Uno, M. Kiyomi and H. Arimura, "LCM  */
+/* ver. 2: Efficient Mining Algorithms for Frequent/Closed/Maximal   */
+/* Itemsets", 2004). Each closed set Q is extended only by items e   */
+/* greater than its core item (the item that was added to create Q) */
+/* and is replaced by the closure of Q u {e}, that is, by the set of */
+/* items contained in all transactions that contain Q u {e}. This    */
+/* closure is kept only if it adds no item less than e (prefix       */
+/* preserving closure extension), which ensures that every closed    */
+/* set is generated exactly once and that the search space is a tree */
+/* on the closed sets. The transactions containing a set are found  */
+/* with occurrence lists (lists of transaction indices), which are   */
+/* distributed to the extension items with one pass over the         */
+/* transactions of the set (occurrence deliver). For each closed set */
+/* that is extended further, a conditional database is built from   */
+/* the transactions containing it, from which all items are removed */
+/* that are infrequent or in the closure, and transactions that have */
+/* the same items after the new core item are merged (their weights */
+/* are added and their items before the core item are intersected,  */
+/* which is all the prefix preservation test needs). The items of   */
+/* the closure (apart from the core item) are passed to the reporter */
+/* as perfect extensions.                                            */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- projected transaction --- */
+  SUPP     wgt;                 /* weight (number of occurrences) */
+  int      size;                /* number of items */
+  int      pfx;                 /* number of items before the core */
+  int      *items;              /* items (in ascending order) */
+} LCTRACT;                      /* (projected transaction) */
+
+typedef struct {                /* --- LCM miner --- */
+  SUPP     supp;                /* minimum support of an item set */
+  ISREPORT *rep;                /* item set reporter */
+  SUPP     *frqs;               /* support counters of the items */
+  int      *cnts;               /* occurrence counters of the items */
+  int      *its;                /* buffer for the occurring items */
+  int      *clo;                /* buffer for the closure items */
+  int      mask;                /* bit mask for the hash table size */
+  int      *htab;               /* hash table for merging suffixes */
+} LCM;                          /* (LCM miner) */
+
+/*----------------------------------------------------------------------
+  Conditional Database Functions
+----------------------------------------------------------------------*/
+
+static int _count (LCM *lcm, LCTRACT **tras, const int *occ, int k,
+                   int e)
+{                               /* --- count items in transactions */
+  int     i, m = 0;             /* loop variables, number of items */
+  int     *p;                   /* to traverse the items */
+  LCTRACT *t;                   /* to traverse the transactions */
+
+  assert(lcm && tras && occ);   /* check the function arguments */
+  while (--k >= 0) {            /* traverse the transactions */
+    t = tras[occ[k]];           /* and the items in them */
+    for (p = t->items +t->size; --p >= t->items; ) {
+      i = *p;                   /* skip the added item and */
+      if ((i == e) || isr_uses(lcm->rep, i)) continue;
+      if (lcm->cnts[i]++ <= 0) lcm->its[m++] = i;
+      lcm->frqs[i] += t->wgt;   /* count the transactions and */
+    }                           /* sum the transaction weights */
+  }
+  return m;                     /* return the number of items */
+}  /* _count() */
+
+/*--------------------------------------------------------------------*/
+
+static void _clear (LCM *lcm, int m)
+{                               /* --- clear the item counters */
+  int i;                        /* item to clear */
+
+  assert(lcm);                  /* check the function argument */
+  while (--m >= 0) {            /* traverse the counted items */
+    i = lcm->its[m]; lcm->cnts[i] = 0; lcm->frqs[i] = 0; }
+}  /* _clear() */
+
+/*--------------------------------------------------------------------*/
+
+static int _same (const LCTRACT *a, const LCTRACT *b)
+{                               /* --- compare transaction suffixes */
+  int       n;                  /* number of items after the core */
+  const int *p, *q;             /* to traverse the items */
+
+  assert(a && b);               /* check the function arguments */
+  n = a->size -a->pfx;          /* compare the number of items */
+  if (n != b->size -b->pfx) return 0;
+  p = a->items +a->pfx; q = b->items +b->pfx;
+  while (--n >= 0)              /* compare the items after the core */
+    if (*p++ != *q++) return 0; /* (the suffixes of the transactions) */
+  return -1;                    /* return whether they are the same */
+}  /* _same() */
+
+/*--------------------------------------------------------------------*/
+
+static int _inter (int *a, int n, const int *b, int m)
+{                               /* --- intersect item lists in place */
+  int i = 0, j = 0, k = 0;      /* loop variables, result size */
+
+  assert(a && b);               /* check the function arguments */
+  while ((i < n) && (j < m)) {  /* while both lists are not empty */
+    if      (a[i] < b[j]) i++;  /* skip items that are */
+    else if (a[i] > b[j]) j++;  /* only in one of the lists */
+    else { a[k++] = a[i++]; j++; }
+  }                             /* keep the items in both lists */
+  return k;                     /* return the size of the result */
+}  /* _inter() */
+
+/*--------------------------------------------------------------------*/
+
+static LCTRACT** _project (LCM *lcm, LCTRACT **tras, const int *occ,
+                           int k, int e, int *cnt)
+{                               /* --- build a conditional database */
+  int          i, n, x, y;      /* loop variables, buffers */
+  int          *d, *p;          /* to traverse the items */
+  int          *slots;          /* used slots of the hash table */
+  unsigned int h;               /* hash value of a suffix */
+  size_t       z;               /* total number of items */
+  LCTRACT      **res;           /* created conditional database */
+  LCTRACT      *t, *u, *v;      /* to traverse the transactions */
+
+  assert(lcm && tras && occ && cnt);  /* check the function arguments */
+  for (z = 0, x = 0; x < k; x++)/* sum the transaction sizes */
+    z += (size_t)tras[occ[x]]->size;
+  res = (LCTRACT**)malloc((size_t)k *(sizeof(LCTRACT*)+sizeof(LCTRACT)
+                                     +sizeof(int)) +z *sizeof(int));
+  if (!res) return NULL;        /* allocate the database */
+  u     = (LCTRACT*)(res +k);   /* organize the memory block */
+  slots = (int*)(u +k); d = slots +k;
+  for (n = x = 0; x < k; x++, u++) {
+    t = tras[occ[x]];           /* traverse the transactions */
+    u->wgt = t->wgt;            /* copy the weight and the items */
+    u->items = d; u->pfx = 0;   /* that can be in later closures */
+    for (h = 0, p = t->items, y = t->size; --y >= 0; p++) {
+      i = *p;                   /* or extensions: frequent items */
+      if ((i == e) || isr_uses(lcm->rep, i)
+      ||  (lcm->frqs[i] < lcm->supp) || (lcm->cnts[i] >= k))
+        continue;               /* skip items in the set or closure */
+      *d++ = i;                 /* and infrequent items */
+      if (i < e) u->pfx++;      /* count the items before the core */
+      else h = h *33 +(unsigned int)i;
+    }                           /* and hash the items after it */
+    u->size = (int)(d -u->items);
+    if (u->size <= u->pfx) {    /* skip transactions without items */
+      d = u->items; continue; } /* after the core item */
+    for (y = (int)((h ^ (h >> 16)) & lcm->mask);
+         (i = lcm->htab[y]) > 0; y = (y+1) & lcm->mask)
+      if (_same(u, v = res[i-1])) break;
+    if (i <= 0) {               /* if the suffix is new, */
+      lcm->htab[y] = n+1;       /* add the transaction to the */
+      slots[n] = y; res[n++] = u; continue;
+    }                           /* hash table and the database */
+    v->wgt += u->wgt;           /* otherwise merge the transactions */
+    y = _inter(v->items, v->pfx, u->items, u->pfx);
+    if (y < v->pfx) {           /* intersect the prefixes and */
+      for (i = 0; i < v->size -v->pfx; i++)
+        v->items[y+i] = v->items[v->pfx+i];
+      v->size -= v->pfx -y; v->pfx = y;
+    }                           /* move the suffix to the prefix */
+    d = u->items;               /* reuse the items of the merged */
+  }                             /* transaction */
+  for (x = 0; x < n; x++)       /* clear the hash table */
+    lcm->htab[slots[x]] = 0;
+  *cnt = n;                     /* return the number of transactions */
+  return res;                   /* and the conditional database */
+}  /* _project() */
+
+/*----------------------------------------------------------------------
+  LCM Functions
+----------------------------------------------------------------------*/
+
+static int _rec (LCM *lcm, LCTRACT **tras, int cnt, int core)
+{                               /* --- mine closed sets recursively */
+  int     i, j, k, m, n, x;     /* loop variables, buffers */
+  int     c, ppc, ext;          /* closure size and flags */
+  int     r = 0;                /* number of reported item sets */
+  int     total;                /* total number of occurrences */
+  SUPP    *supps;               /* supports of the extension items */
+  int     *exts;                /* extension items */
+  int     *offs, *ends;         /* occurrence list offsets and ends */
+  int     *list;                /* occurrence lists of the extensions */
+  int     *p;                   /* to traverse the items */
+  LCTRACT *t;                   /* to traverse the transactions */
+  LCTRACT **sub;                /* conditional database */
+
+  assert(lcm && tras && (cnt > 0));   /* check the function arguments */
+  for (m = x = 0; x < cnt; x++){/* traverse the transactions */
+    t = tras[x];                /* and the items after the core */
+    for (p = t->items +t->size; (--p >= t->items) && (*p > core); ) {
+      i = *p;                   /* (items are in ascending order) */
+      if (isr_uses(lcm->rep, i)) continue;
+      if (lcm->cnts[i]++ <= 0) lcm->its[m++] = i;
+      lcm->frqs[i] += t->wgt;   /* count the occurrences and the */
+    }                           /* support of the items following */
+  }                             /* the core item (extension items) */
+  for (n = total = j = 0; j < m; j++) {
+    i = lcm->its[j];            /* traverse the occurring items */
+    if (lcm->frqs[i] >= lcm->supp) {
+      lcm->its[n++] = i; total += lcm->cnts[i]; }
+    else { lcm->cnts[i] = 0; lcm->frqs[i] = 0; }
+  }                             /* collect the frequent items */
+  if (n <= 0) return 0;         /* and clear the other counters */
+  supps = (SUPP*)malloc((size_t)n *sizeof(SUPP)
+                       +(size_t)(3*n +total) *sizeof(int));
+  if (!supps) { _clear(lcm, n); return -1; }
+  exts = (int*)(supps +n); offs = exts +n; ends = offs +n;
+  list = ends +n;               /* organize the memory block */
+  for (total = j = 0; j < n; j++) {
+    exts[j] = i = lcm->its[j];  /* traverse the frequent items */
+    supps[j]   = lcm->frqs[i];  /* and note the item, its support */
+    offs[j]    = ends[j] = total;  /* and its occurrence list */
+    total     += lcm->cnts[i];  /* compute the list offsets */
+    lcm->cnts[i] = j+1;         /* and map the items to the lists */
+    lcm->frqs[i] = 0;           /* (clear the support counter) */
+  }
+  for (x = 0; x < cnt; x++) {   /* deliver the occurrences */
+    t = tras[x];                /* (add the transaction index to the */
+    for (p = t->items +t->size; (--p >= t->items) && (*p > core); )
+      if ((j = lcm->cnts[*p]) > 0) list[ends[j-1]++] = x;
+  }                             /* occurrence lists of its items) */
+  for (j = 0; j < n; j++)       /* clear the item to list map */
+    lcm->cnts[exts[j]] = 0;     /* (the counters must be all zero) */
+  for (j = 0; j < n; j++) {     /* traverse the extension items */
+    k = ends[j] -offs[j];       /* count the items in the */
+    m = _count(lcm, tras, list +offs[j], k, exts[j]);
+    for (c = ext = 0, ppc = 1, x = 0; x < m; x++) {
+      i = lcm->its[x];          /* traverse the occurring items */
+      if      (lcm->cnts[i] >= k) {      /* if in all transactions, */
+        if (i < exts[j]) ppc = 0;        /* check for prefix pres. */
+        else lcm->clo[c++] = i; }        /* and collect the closure */
+      else if ((i > exts[j]) && (lcm->frqs[i] >= lcm->supp))
+        ext = 1;                /* check for a frequent extension */
+    }
+    if (!ppc) { _clear(lcm, m); continue; }
+    isr_add(lcm->rep, exts[j], supps[j]);
+    while (--c >= 0) isr_addpex(lcm->rep, lcm->clo[c]);
+    r += isr_report(lcm->rep);  /* add and report the closed set */
+    sub = NULL;                 /* if the set can be extended, */
+    if (ext && isr_xable(lcm->rep)) {   /* build a cond. database */
+      sub = _project(lcm, tras, list +offs[j], k, exts[j], &x);
+      if (!sub) r = -1;         /* (before clearing the counters, */
+    }                           /* which are needed for filtering) */
+    _clear(lcm, m);             /* clear the item counters */
+    if (sub) {                  /* find closed supersets recursively */
+      i = _rec(lcm, sub, x, exts[j]);
+      free(sub);                /* delete the conditional database */
+      r = (i < 0) ? -1 : r +i;  /* and sum the number of sets */
+    }
+    isr_remove(lcm->rep, 1);    /* remove the current item */
+    if (r < 0) break;           /* and its closure items */
+  }
+  free(supps);                  /* delete the occurrence lists */
+  return r;                     /* return number of reported sets */
+}  /* _rec() */
+
+/*--------------------------------------------------------------------*/
+
+int lcm_mine (TABAG *bag, SUPP supp, ISREPORT *rep)
+{                               /* --- mine closed sets with LCM */
+  int     i, k, m, n, r;        /* loop variables, number of sets */
+  int     *occ;                 /* occurrences of the empty set */
+  LCTRACT **tras, *t;           /* transactions of the database */
+  LCM     lcm;                  /* LCM miner */
+
+  assert(bag && rep);           /* check the function arguments */
+  k = tb_cnt(bag);              /* get the number of transactions */
+  if ((k <= 0) || (tb_wgt(bag) < supp))
+    return 0;                   /* check for a frequent empty set */
+  if (supp <= 0) supp = 1;      /* check the minimum support */
+  n = ib_cnt(tb_base(bag));     /* get the number of items */
+  for (lcm.mask = 1; lcm.mask < 2*k; ) lcm.mask <<= 1;
+  lcm.frqs = (SUPP*)calloc((size_t)n+1, sizeof(SUPP)+3*sizeof(int));
+  lcm.htab = (int*) calloc((size_t)lcm.mask, sizeof(int));
+  if (!lcm.frqs || !lcm.htab) { /* allocate the counter arrays */
+    if (lcm.htab) free(lcm.htab);  /* and the hash table */
+    if (lcm.frqs) free(lcm.frqs);
+    return -1;                  /* on failure delete the arrays */
+  }                             /* and abort the function */
+  lcm.mask -= 1;                /* get the bit mask for the table */
+  lcm.cnts = (int*)(lcm.frqs +n+1);
+  lcm.its  = lcm.cnts +n+1;     /* organize the memory block */
+  lcm.clo  = lcm.its  +n+1;
+  tras = (LCTRACT**)malloc((size_t)k *(sizeof(LCTRACT*)
+                          +sizeof(LCTRACT) +sizeof(int)));
+  if (!tras) { free(lcm.frqs); free(lcm.htab); return -1; }
+  t   = (LCTRACT*)(tras +k);    /* allocate the initial database */
+  occ = (int*)(t +k);           /* and the occurrence list */
+  for (i = 0; i < k; i++) {     /* traverse the transactions */
+    tras[i] = t +i; occ[i] = i; /* (all contain the empty set) */
+    t[i].wgt   = t_wgt (tb_tract(bag, i));
+    t[i].size  = t_size(tb_tract(bag, i));
+    t[i].pfx   = 0;             /* refer to the items of the */
+    t[i].items = (int*)t_items(tb_tract(bag, i));
+  }                             /* transactions of the bag */
+  lcm.supp = supp;              /* initialize the miner */
+  lcm.rep  = rep;
+  m = _count(&lcm, tras, occ, k, -1);
+  for (i = 0; i < m; i++)       /* add the closure of the empty set */
+    if (lcm.cnts[lcm.its[i]] >= k) isr_addpex(rep, lcm.its[i]);
+  _clear(&lcm, m);              /* and report it */
+  r = isr_report(rep);          /* (the items in all transactions) */
+  if (isr_xable(rep)) {         /* find the closed item sets */
+    i = _rec(&lcm, tras, k, -1);/* recursively */
+    r = (i < 0) ? -1 : r +i;    /* and sum the number of sets */
+  }
+  free(tras);                   /* delete the initial database */
+  free(lcm.htab);               /* the hash table */
+  free(lcm.frqs);               /* and the counter arrays */
+  return r;                     /* return number of reported sets */
+}  /* lcm_mine() */
@@ -0,0 +1,490 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "tidset.h"
+#ifdef STORAGE
+#include "storage.h"
+#endif
+
+
+#define GALLOP        32        /* size ratio for binary search */
+#define DATA(s)       ((unsigned int*)((s)->conts +(s)->cnt))
+
+/* A tid set is a compressed set of transaction indices (tids). The   */
+/* tids are split into chunks of TDS_CHUNK consecutive values, which  */
+/* share the upper bits of the tids (the key of a container). Each    */
+/* chunk is stored in the smallest of three representations: a sorted */
+/* array of the lower 16 bits (for at most TDS_MAXARR tids), a bitmap */
+/* of TDS_CHUNK bits or a list of runs of consecutive values (pairs   */
+/* of first and last value). Rare items thus need only two bytes per  */
+/* tid and frequent items at most one bit per transaction, while      */
+/* items that occur in long stretches of (sorted) transactions shrink */
+/* to a few runs (cf. the "Roaring" bitmaps by D. Lemire et al.,      */
+/* 2016). All containers and their data are stored in a single memory */
+/* block (containers first, data words after them), so that a tid set */
+/* can be deleted with a single free(). Intersections are computed    */
+/* per pair of containers with the same key by a kernel for each pair */
+/* of container types; the cardinality of an intersection can also be */
+/* computed without creating it.                                      */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef unsigned short VAL;     /* a value in a container (16 bits) */
+
+/*----------------------------------------------------------------------
+  Auxiliary Functions
+----------------------------------------------------------------------*/
+
+static size_t _size (int cnt, int words)
+{                               /* --- compute size of a tid set */
+  return sizeof(TIDSET) +(size_t)((cnt > 1) ? cnt-1 : 0) *sizeof(TDSCONT)
+       + (size_t)words *sizeof(unsigned int);
+}  /* _size() */
+
+/*--------------------------------------------------------------------*/
+
+static int _type (int card, int runs)
+{                               /* --- choose a container type */
+  if (2*runs < ((card < TDS_MAXARR) ? card : TDS_MAXARR))
+    return TDS_RUN;             /* runs need two values each, */
+  return (card <= TDS_MAXARR) ? TDS_ARRAY : TDS_BITMAP;
+}  /* _type() */                /* an array one value per tid */
+
+/*--------------------------------------------------------------------*/
+
+static int _words (int type, int n)
+{                               /* --- number of words of a container */
+  if (type == TDS_BITMAP) return TDS_WORDS;
+  if (type == TDS_RUN)    return n;
+  return (n+1)/2;               /* a run is a pair of values, */
+}  /* _words() */               /* an array value is half a word */
+
+/*--------------------------------------------------------------------*/
+
+static void _range (unsigned int *bits, int beg, int end)
+{                               /* --- set a range of bits */
+  int          w, e;            /* word indices */
+  unsigned int m;               /* bit mask */
+
+  for (w = beg >> 5, e = end >> 5; w <= e; w++) {
+    m = ~0u;                    /* traverse the words of the range */
+    if (w == beg >> 5) m &= ~0u << (beg & 31);
+    if (w == e)        m &= ~0u >> (31 -(end & 31));
+    bits[w] |= m;               /* mask the bits outside the range */
+  }                             /* and set the bits in the range */
+}  /* _range() */
+
+/*--------------------------------------------------------------------*/
+
+static int _frombits (TDSCONT *c, unsigned int *d,
+                      const unsigned int *bits, int card)
+{                               /* --- store a container from a bitmap */
+  int          i, n;            /* loop variable, number of values */
+  unsigned int b;               /* bits of a word */
+  VAL          *v;              /* to store the values */
+
+  c->card = card;               /* store the cardinality */
+  if (card > TDS_MAXARR) {      /* if an array would be larger, */
+    c->type = TDS_BITMAP; c->n = 0; /* store the bitmap */
+    memcpy(d, bits, TDS_WORDS *sizeof(unsigned int));
+    return TDS_WORDS;           /* return the number of words */
+  }
+  v = (VAL*)d;                  /* otherwise collect the values */
+  for (n = i = 0; i < TDS_WORDS; i++)
+    for (b = bits[i]; b; b &= b-1)
+      v[n++] = (VAL)((i << 5) +tds_popcnt((b & -b) -1));
+  c->type = TDS_ARRAY; c->n = n; /* store the array */
+  return (n+1)/2;               /* return the number of words */
+}  /* _frombits() */
+
+/*--------------------------------------------------------------------*/
+
+static int _fromruns (TDSCONT *c, unsigned int *d,
+                      const VAL *runs, int nr, int card)
+{                               /* --- store a container from runs */
+  int i, k, n;                  /* loop variables, number of values */
+  VAL *v;                       /* to store the values */
+
+  c->card = card;               /* store the cardinality */
+  c->type = _type(card, nr);    /* and choose the container type */
+  if      (c->type == TDS_RUN) { /* if to store runs */
+    c->n = nr; memcpy(d, runs, (size_t)nr *2 *sizeof(VAL)); }
+  else if (c->type == TDS_ARRAY) {
+    for (v = (VAL*)d, n = i = 0; i < nr; i++)
+      for (k = runs[2*i]; k <= runs[2*i+1]; k++) v[n++] = (VAL)k;
+    c->n = n; }                 /* expand the runs to values */
+  else {                        /* if to store a bitmap */
+    memset(d, 0, TDS_WORDS *sizeof(unsigned int));
+    for (i = 0; i < nr; i++) _range(d, runs[2*i], runs[2*i+1]);
+    c->n = 0;                   /* set the bits of the runs */
+  }
+  return _words(c->type, c->n); /* return the number of words */
+}  /* _fromruns() */
+
+/*----------------------------------------------------------------------
+  Intersection Kernels
+----------------------------------------------------------------------*/
+
+static int _aa (VAL *d, const VAL *a, int na, const VAL *b, int nb)
+{                               /* --- intersect array and array */
+  int       n = 0;              /* number of common values */
+  int       l, r, m;            /* binary search indices */
+  const VAL *t, *ea, *eb;       /* exchange buffer, end pointers */
+
+  if (na > nb) { t = a; a = b; b = t; m = na; na = nb; nb = m; }
+  if (na *GALLOP < nb) {        /* if one array is much smaller */
+    for (l = 0, ea = a +na; a < ea; a++) {
+      for (r = nb; l < r; ) {   /* binary search for each value */
+        m = (l+r) >> 1;         /* of the smaller array */
+        if (b[m] < *a) l = m+1; else r = m; }
+      if (l >= nb) break;       /* (the search range shrinks, */
+      if (b[l] == *a) { if (d) d[n++] = *a; else n++; }
+    }                           /* because the values are sorted) */
+    return n;                   /* return the number of values */
+  }
+  for (ea = a +na, eb = b +nb; (a < ea) && (b < eb); ) {
+    if      (*a < *b) a++;      /* merge the arrays */
+    else if (*a > *b) b++;      /* and collect */
+    else { if (d) d[n++] = *a; else n++; a++; b++; }
+  }                             /* the common values */
+  return n;                     /* return the number of values */
+}  /* _aa() */
+
+/*--------------------------------------------------------------------*/
+
+static int _ab (VAL *d, const VAL *a, int na, const unsigned int *bits)
+{                               /* --- intersect array and bitmap */
+  int i, n = 0;                 /* loop variable, number of values */
+
+  for (i = 0; i < na; i++)      /* test the bits of the array values */
+    if ((bits[a[i] >> 5] >> (a[i] & 31)) & 1) {
+      if (d) d[n++] = a[i]; else n++; }
+  return n;                     /* return the number of values */
+}  /* _ab() */
+
+/*--------------------------------------------------------------------*/
+
+static int _ar (VAL *d, const VAL *a, int na, const VAL *runs, int nr)
+{                               /* --- intersect array and runs */
+  int i, k, n = 0;              /* loop variables, number of values */
+
+  for (i = k = 0; (i < na) && (k < nr); i++) {
+    while ((k < nr) && (runs[2*k+1] < a[i])) k++;
+    if ((k < nr) && (runs[2*k] <= a[i])) {
+      if (d) d[n++] = a[i]; else n++; }
+  }                             /* find the run that may contain */
+  return n;                     /* the array value and test it */
+}  /* _ar() */
+
+/*--------------------------------------------------------------------*/
+
+static int _bb (unsigned int *d, const unsigned int *a,
+                const unsigned int *b)
+{                               /* --- intersect bitmap and bitmap */
+  int          i, n = 0;        /* loop variable, number of values */
+  unsigned int x;               /* bits of the intersection */
+
+  for (i = 0; i < TDS_WORDS; i++) {
+    x = a[i] & b[i]; n += tds_popcnt(x);
+    if (d) d[i] = x;            /* intersect the words */
+  }                             /* and count the common bits */
+  return n;                     /* return the number of values */
+}  /* _bb() */
+
+/*--------------------------------------------------------------------*/
+
+static int _br (unsigned int *d, const unsigned int *bits,
+                const VAL *runs, int nr)
+{                               /* --- intersect bitmap and runs */
+  int          i, w, e, n = 0;  /* loop variables, number of values */
+  unsigned int m;               /* bit mask for a word */
+
+  if (d) memset(d, 0, TDS_WORDS *sizeof(unsigned int));
+  for (i = 0; i < nr; i++) {    /* traverse the runs */
+    for (w = runs[2*i] >> 5, e = runs[2*i+1] >> 5; w <= e; w++) {
+      m = ~0u;                  /* traverse the words of the run */
+      if (w == runs[2*i] >> 5) m &= ~0u << (runs[2*i] & 31);
+      if (w == e)            m &= ~0u >> (31 -(runs[2*i+1] & 31));
+      m &= bits[w]; n += tds_popcnt(m);
+      if (d) d[w] |= m;         /* intersect the bits in the run */
+    }                           /* with the bitmap and count them */
+  }
+  return n;                     /* return the number of values */
+}  /* _br() */
+
+/*--------------------------------------------------------------------*/
+
+static int _rr (VAL *d, const VAL *a, int na, const VAL *b, int nb,
+                int *card)
+{                               /* --- intersect runs and runs */
+  int i, k, n = 0, c = 0;       /* loop variables, numbers of runs */
+  int lo, hi;                   /* bounds of common run */
+
+  for (i = k = 0; (i < na) && (k < nb); ) {
+    lo = (a[2*i]   > b[2*k])   ? a[2*i]   : b[2*k];
+    hi = (a[2*i+1] < b[2*k+1]) ? a[2*i+1] : b[2*k+1];
+    if (lo <= hi) {             /* if the runs overlap */
+      if (d) { d[2*n] = (VAL)lo; d[2*n+1] = (VAL)hi; }
+      n++; c += hi-lo+1;        /* store the common run */
+    }                           /* and sum the number of values */
+    if (a[2*i+1] < b[2*k+1]) i++; else k++;
+  }                             /* advance the run that ends first */
+  *card = c;                    /* store the number of values */
+  return n;                     /* and return the number of runs */
+}  /* _rr() */
+
+/*--------------------------------------------------------------------*/
+
+static int _isect (TDSCONT *c, unsigned int *d, unsigned int *work,
+                   const TDSCONT *x, const unsigned int *dx,
+                   const TDSCONT *y, const unsigned int *dy)
+{                               /* --- intersect two containers */
+  const TDSCONT      *t;        /* exchange buffer for containers */
+  const unsigned int *p;        /* exchange buffer for data */
+  int                n;         /* number of values or runs */
+
+  if (x->type > y->type) {      /* sort the containers by type */
+    t = x; x = y; y = t; p = dx; dx = dy; dy = p; }
+  if (x->type == TDS_ARRAY) {   /* if the first is an array, */
+    if      (y->type == TDS_ARRAY)   /* so is the result */
+      n = _aa((VAL*)d, (const VAL*)dx, x->n, (const VAL*)dy, y->n);
+    else if (y->type == TDS_BITMAP)
+      n = _ab((VAL*)d, (const VAL*)dx, x->n, dy);
+    else n = _ar((VAL*)d, (const VAL*)dx, x->n, (const VAL*)dy, y->n);
+    c->type = TDS_ARRAY; c->n = c->card = n;
+    return (n+1)/2;             /* return the number of words */
+  }
+  if (y->type == TDS_RUN) {     /* if the second consists of runs */
+    if (x->type == TDS_RUN) {   /* and so does the first */
+      n = _rr((VAL*)work, (const VAL*)dx, x->n, (const VAL*)dy, y->n,
+              &c->card);        /* intersect the runs */
+      return (c->card > 0) ? _fromruns(c, d, (VAL*)work, n, c->card) : 0;
+    }                           /* store the result container */
+    n = _br(work, dx, (const VAL*)dy, y->n); }
+  else                          /* intersect the bitmaps */
+    n = _bb(work, dx, dy);      /* (with a run container) */
+  return (n > 0) ? _frombits(c, d, work, n) : (c->card = 0);
+}  /* _isect() */
+
+/*--------------------------------------------------------------------*/
+
+static int _icnt (const TDSCONT *x, const unsigned int *dx,
+                  const TDSCONT *y, const unsigned int *dy)
+{                               /* --- count intersection values */
+  const TDSCONT      *t;        /* exchange buffer for containers */
+  const unsigned int *p;        /* exchange buffer for data */
+  int                n;         /* number of common values */
+
+  if (x->type > y->type) {      /* sort the containers by type */
+    t = x; x = y; y = t; p = dx; dx = dy; dy = p; }
+  if (x->type == TDS_ARRAY) {   /* if the first is an array */
+    if (y->type == TDS_ARRAY)
+      return _aa(NULL, (const VAL*)dx, x->n, (const VAL*)dy, y->n);
+    if (y->type == TDS_BITMAP)
+      return _ab(NULL, (const VAL*)dx, x->n, dy);
+    return _ar(NULL, (const VAL*)dx, x->n, (const VAL*)dy, y->n);
+  }
+  if (y->type == TDS_BITMAP)    /* if both are bitmaps */
+    return _bb(NULL, dx, dy);   /* count the common bits */
+  if (x->type == TDS_BITMAP)    /* if a bitmap and runs */
+    return _br(NULL, dx, (const VAL*)dy, y->n);
+  _rr(NULL, (const VAL*)dx, x->n, (const VAL*)dy, y->n, &n);
+  return n;                     /* count the common run values */
+}  /* _icnt() */
+
+/*----------------------------------------------------------------------
+  Main Functions
+----------------------------------------------------------------------*/
+
+int tds_popcnt (unsigned int b)
+{                               /* --- count the set bits of a word */
+  b = b -((b >> 1) & 0x55555555);
+  b = (b & 0x33333333) +((b >> 2) & 0x33333333);
+  b = (b +(b >> 4)) & 0x0f0f0f0f;
+  return (int)(((b *0x01010101) & 0xffffffff) >> 24);
+}  /* tds_popcnt() */           /* (parallel bit counting) */
+
+/*--------------------------------------------------------------------*/
+
+TIDSET* tds_create (const int *tids, int n)
+{                               /* --- create a tid set */
+  int          i, k, r;         /* loop variables, number of runs */
+  int          cnt, words;      /* number of containers and words */
+  TIDSET       *set;            /* created tid set */
+  TDSCONT      *c;              /* to traverse the containers */
+  unsigned int *d;              /* data of the containers */
+  VAL          *v;              /* to store the values */
+
+  assert(tids || (n <= 0));     /* check the function arguments */
+  for (cnt = words = i = 0; i < n; i = k) {
+    for (r = 1, k = i+1; (k < n) && ((tids[k] >> 16) == (tids[i] >> 16));
+         k++) if (tids[k] != tids[k-1]+1) r++;
+    words += _words(_type(k-i, r), (_type(k-i, r) == TDS_RUN) ? r : k-i);
+    cnt++;                      /* count the containers, the runs */
+  }                             /* and the data words */
+  set = (TIDSET*)malloc(_size(cnt, words));
+  if (!set) return NULL;        /* allocate the tid set */
+  set->cnt = cnt; set->card = (n > 0) ? n : 0;
+  d = DATA(set);                /* get the container data */
+  for (c = set->conts, words = i = 0; i < n; i = k, c++) {
+    for (r = 1, k = i+1; (k < n) && ((tids[k] >> 16) == (tids[i] >> 16));
+         k++) if (tids[k] != tids[k-1]+1) r++;
+    c->key  = tids[i] >> 16;    /* get the key of the container */
+    c->card = k-i;              /* and the number of tids */
+    c->type = _type(k-i, r);    /* choose the container type */
+    c->off  = words;            /* and note the data offset */
+    v = (VAL*)(d +words);       /* get the container data */
+    if      (c->type == TDS_ARRAY) {
+      for (c->n = 0; i < k; i++) v[c->n++] = (VAL)(tids[i] & 0xffff); }
+    else if (c->type == TDS_RUN) {
+      for (c->n = 0; i < k; i++) {
+        if ((c->n <= 0) || (v[2*c->n-1]+1 != (tids[i] & 0xffff))) {
+          v[2*c->n] = (VAL)(tids[i] & 0xffff); c->n++; }
+        v[2*c->n-1] = (VAL)(tids[i] & 0xffff);
+      } }                       /* start a new run or extend it */
+    else {                      /* if to store a bitmap */
+      memset(d +words, 0, TDS_WORDS *sizeof(unsigned int));
+      for (c->n = 0; i < k; i++)
+        d[words +((tids[i] & 0xffff) >> 5)] |= 1u << (tids[i] & 31);
+    }                           /* set the bits of the tids */
+    words += _words(c->type, c->n);
+  }                             /* advance the data offset */
+  return set;                   /* return the created tid set */
+}  /* tds_create() */
+
+/*--------------------------------------------------------------------*/
+
+TIDSET* tds_inter (const TIDSET *a, const TIDSET *b, unsigned int *work)
+{                               /* --- intersect two tid sets */
+  int           i, k, n, m;     /* loop variables, number of values */
+  int           cnt, words;     /* number of containers and words */
+  TIDSET        *set, *p;       /* created tid set, reallocated set */
+  const TDSCONT *x, *y;         /* to traverse the containers */
+  TDSCONT       *c;             /* to store the result containers */
+  unsigned int  *d;             /* data of the result containers */
+
+  assert(a && b && work);       /* check the function arguments */
+  for (cnt = words = i = k = 0; (i < a->cnt) && (k < b->cnt); ) {
+    x = a->conts +i; y = b->conts +k;
+    if      (x->key < y->key) i++;
+    else if (x->key > y->key) k++;
+    else {                      /* if the containers have the same key */
+      m = (x->card < y->card) ? x->card : y->card;
+      if (m > TDS_MAXARR) m = TDS_MAXARR;
+      words += (m+1)/2; cnt++; i++; k++;
+    }                           /* a result container is never larger */
+  }                             /* than an array of the smaller card. */
+  set = (TIDSET*)malloc(_size(cnt, words));
+  if (!set) return NULL;        /* allocate the tid set */
+  d = (unsigned int*)(set->conts +cnt);
+  for (n = m = words = i = k = 0; (i < a->cnt) && (k < b->cnt); ) {
+    x = a->conts +i; y = b->conts +k;
+    if      (x->key < y->key) { i++; continue; }
+    else if (x->key > y->key) { k++; continue; }
+    c = set->conts +n;          /* intersect containers with same key */
+    c->key = x->key; c->off = words;
+    words += _isect(c, d +words, work, x, DATA(a) +x->off,
+                                       y, DATA(b) +y->off);
+    if (c->card > 0) { m += c->card; n++; }
+    i++; k++;                   /* keep only non-empty containers */
+  }                             /* and sum their cardinalities */
+  if (n < cnt)                  /* move the data to the containers */
+    memmove(set->conts +n, d, (size_t)words *sizeof(unsigned int));
+  set->cnt = n; set->card = m;  /* store the container counters */
+  p = (TIDSET*)realloc(set, _size(n, words));
+  return (p) ? p : set;         /* shrink the tid set to its size */
+}  /* tds_inter() */
+
+/*--------------------------------------------------------------------*/
+
+int tds_intercnt (const TIDSET *a, const TIDSET *b)
+{                               /* --- count tids of an intersection */
+  int           i, k, n;        /* loop variables, number of tids */
+  const TDSCONT *x, *y;         /* to traverse the containers */
+
+  assert(a && b);               /* check the function arguments */
+  for (n = i = k = 0; (i < a->cnt) && (k < b->cnt); ) {
+    x = a->conts +i; y = b->conts +k;
+    if      (x->key < y->key) i++;
+    else if (x->key > y->key) k++;
+    else {                      /* if the containers have the same key */
+      n += _icnt(x, DATA(a) +x->off, y, DATA(b) +y->off);
+      i++; k++;                 /* sum the cardinalities */
+    }                           /* of the container intersections */
+  }
+  return n;                     /* return the number of tids */
+}  /* tds_intercnt() */
+
+/*--------------------------------------------------------------------*/
+
+int tds_tids (const TIDSET *set, int *tids)
+{                               /* --- get the tids of a tid set */
+  int           i, k, j, b;     /* loop variables, upper tid bits */
+  int           *p = tids;      /* to store the tids */
+  const TDSCONT *c;             /* to traverse the containers */
+  const VAL     *v;             /* to traverse the values */
+  unsigned int  w;              /* bits of a bitmap word */
+
+  assert(set && tids);          /* check the function arguments */
+  for (i = 0; i < set->cnt; i++) {
+    c = set->conts +i;          /* traverse the containers */
+    b = c->key << 16;           /* get the upper bits of the tids */
+    v = (const VAL*)(DATA(set) +c->off);
+    if      (c->type == TDS_ARRAY)
+      for (k = 0; k < c->n; k++) *p++ = b +v[k];
+    else if (c->type == TDS_RUN)
+      for (k = 0; k < c->n; k++)
+        for (j = v[2*k]; j <= v[2*k+1]; j++) *p++ = b +j;
+    else {                      /* if the container is a bitmap */
+      for (k = 0; k < TDS_WORDS; k++)
+        for (w = DATA(set)[c->off +k]; w; w &= w-1)
+          *p++ = b +(k << 5) +tds_popcnt((w & -w) -1);
+    }                           /* collect the tids */
+  }                             /* in ascending order */
+  return (int)(p -tids);        /* return the number of tids */
+}  /* tds_tids() */
+
+/*--------------------------------------------------------------------*/
+
+SUPP tds_wgt (const TIDSET *set, const SUPP *wgts)
+{                               /* --- sum the weights of the tids */
+  int           i, k, j, b;     /* loop variables, upper tid bits */
+  SUPP          s = 0;          /* sum of the transaction weights */
+  const TDSCONT *c;             /* to traverse the containers */
+  const VAL     *v;             /* to traverse the values */
+  unsigned int  w;              /* bits of a bitmap word */
+
+  assert(set);                  /* check the function arguments */
+  if (!wgts) return (SUPP)set->card;
+  for (i = 0; i < set->cnt; i++) {
+    c = set->conts +i;          /* traverse the containers */
+    b = c->key << 16;           /* get the upper bits of the tids */
+    v = (const VAL*)(DATA(set) +c->off);
+    if      (c->type == TDS_ARRAY)
+      for (k = 0; k < c->n; k++) s += wgts[b +v[k]];
+    else if (c->type == TDS_RUN)
+      for (k = 0; k < c->n; k++)
+        for (j = v[2*k]; j <= v[2*k+1]; j++) s += wgts[b +j];
+    else {                      /* if the container is a bitmap */
+      for (k = 0; k < TDS_WORDS; k++)
+        for (w = DATA(set)[c->off +k]; w; w &= w-1)
+          s += wgts[b +(k << 5) +tds_popcnt((w & -w) -1)];
+    }                           /* sum the weights */
+  }                             /* of the transactions */
+  return s;                     /* return the sum of the weights */
+}  /* tds_wgt() */
@@ -0,0 +1,67 @@
+/*
+Projeto de Organização e recuperação da Informação (ORI)
+Escola de Engenharia de Piracicaba
+Authors: Adilson Perecin(a.perecin(at)hotmail.com) & Cristiano Benato(benato(at)hst.com.br)
+
+Tema: Organização e verificação de itemsets e ordenação de coincidencias através
+do algoritmo de ordenação Apriori
+
+Instrutor: Luiz Camolesi
+
+
+
+*/
+
+#ifndef __TIDSET__
+#define __TIDSET__
+#include "tract.h"
+
+
+/* --- container types --- */
+#define TDS_ARRAY       0       /* sorted array of 16 bit values */
+#define TDS_BITMAP      1       /* bitmap of 65536 bits */
+#define TDS_RUN         2       /* runs of consecutive values */
+
+/* --- sizes --- */
+#define TDS_CHUNK   65536       /* number of tids per container */
+#define TDS_MAXARR   4096       /* maximal size of an array container */
+#define TDS_WORDS    2048       /* number of words of a bitmap */
+#define TDS_WORKSIZE (TDS_WORDS +TDS_CHUNK/2)  /* size of a work buffer */
+
+/*----------------------------------------------------------------------
+  Type Definitions
+----------------------------------------------------------------------*/
+typedef struct {                /* --- tid set container --- */
+  int      key;                 /* upper bits of the tids (tid >> 16) */
+  int      type;                /* container type (e.g. TDS_ARRAY) */
+  int      card;                /* number of tids in the container */
+  int      n;                   /* number of array values or runs */
+  int      off;                 /* offset of the data (in words) */
+} TDSCONT;                      /* (tid set container) */
+
+typedef struct {                /* --- tid set --- */
+  int      cnt;                 /* number of containers */
+  int      card;                /* number of tids (cardinality) */
+  TDSCONT   conts[1];           /* containers (sorted by key), */
+} TIDSET;                       /* followed by the container data */
+
+/*----------------------------------------------------------------------
+  Functions
+----------------------------------------------------------------------*/
+extern int     tds_popcnt   (unsigned int b);
+extern TIDSET* tds_create   (const int *tids, int n);
+extern void    tds_delete   (TIDSET *set);
+extern int     tds_card     (const TIDSET *set);
+extern TIDSET* tds_inter    (const TIDSET *a, const TIDSET *b,
+                             unsigned int *work);
+extern int     tds_intercnt (const TIDSET *a, const TIDSET *b);
+extern int     tds_tids     (const TIDSET *set, int *tids);
+extern SUPP    tds_wgt      (const TIDSET *set, const SUPP *wgts);
+
+/*----------------------------------------------------------------------
+  Preprocessor Definitions
+----------------------------------------------------------------------*/
+#define tds_delete(s)      free(s)
+#define tds_card(s)        ((s)->card)
+
+#endif
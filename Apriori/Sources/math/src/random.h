@@ -36,7 +36,7 @@ extern int          rng_rand   (void);
 /*----------------------------------------------------------------------
   Preprocessor Definitions
 ----------------------------------------------------------------------*/
-#define rng_double(r)  (rng_unit(r) /((double)UINT_MAX +1.0));
+#define rng_double(r)  (rng_uint(r) /((double)UINT_MAX +1.0))
 
 #define rng_get()      (rng_curr)
 #define rng_set(r)     (rng_curr = (r))
@@ -43,19 +43,19 @@ ISREPORT* isr_create (ITEMBASE *base, FILE *file, int mode,
   rep->names  = (const char**)(rep->apos +n+1);
   *rep->apos  = NULL;           /* organize the pointer arrays */
   rep->logs   = rep->sums = NULL;
-  k = (!(mode & ISR_DOUBLE)) ? n+1 : 0;
-  rep->items  = (int*)malloc((n+n+n+1+k) *sizeof(int));
+  rep->supps  = NULL;           /* clear the support arrays */
+  rep->sdbls  = NULL;           /* (integer and double precision) */
+  rep->items  = (int*)malloc((n+n+n+1) *sizeof(int));
   if (!rep->items) { isr_delete(rep, 0); return NULL; }
   rep->pexs   = rep->items + n; /* allocate memory for the arrays */
   rep->pxpp   = rep->pexs += n; /* and organize it (split it) */
   for (i = n; --i >= 0; )       /* clear the item usage flags */
     rep->pxpp[i] = 0;           /* (sign bits) for all items */
-  if (k) {                      /* if to use integer support values */
-    rep->sdbls = NULL;          /* clear the double prec. array */
-    rep->supps = rep->pxpp +k;  /* set pointer to integer array */
-    rep->supps[0] = base->wgt;} /* and store the empty set support */
+  if (!(mode & ISR_DOUBLE)) {   /* if to use integer support values */
+    rep->supps = (SUPP*)malloc((n+1) *sizeof(SUPP));
+    if (!rep->supps) { isr_delete(rep, 0); return NULL; }
+    rep->supps[0] = base->wgt;} /* create an integer array */
   else {                        /* if to use double precision support */
-    rep->supps = NULL;          /* clear the integer array */
     rep->sdbls = (double*)malloc((n+1) *sizeof(double));
     if (!rep->sdbls) { isr_delete(rep, 0); return NULL; }
     rep->sdbls[0] = base->wgt;  /* create a double prec. array */
@@ -105,6 +105,8 @@ void isr_delete (ISREPORT *rep, int delis)
     if (rep->names[i] != ib_name(rep->base, i))
       free((void*)rep->names[i]);    /* delete all cloned names */
   if (rep->logs)  free(rep->logs);   /* delete the arrays */
+  if (rep->supps) free(rep->supps);  /* (if they are present) */
+  if (rep->sdbls) free(rep->sdbls);
   if (rep->items) free(rep->items);  /* (if they are present) */
   if (delis) ib_delete(rep->base);   /* delete the item base */
   free(rep);                    /* delete the base structure */
@@ -133,7 +135,7 @@ void isr_seteval (ISREPORT *rep, ISEVALFN eval,
 
 /*--------------------------------------------------------------------*/
 
-int isr_add (ISREPORT *rep, int item, int supp)
+int isr_add (ISREPORT *rep, int item, SUPP supp)
 {                               /* --- add an item (integer support) */
   assert(rep && (item >= 0)     /* check the function arguments */
              && (item < (int)(rep->names -(const char**)rep->apos)));
@@ -195,25 +197,24 @@ int isr_remove (ISREPORT *rep, int cnt)
 
 /*--------------------------------------------------------------------*/
 
-int isr_intout (ISREPORT *rep, int num)
+int isr_intout (ISREPORT *rep, SUPP num)
 {                               /* --- print an integer number */
-  int  i, s;                    /* loop variable, sign flag */
-  char buf[BS_INT];             /* output buffer */
+  int           i, s;           /* loop variable, sign flag */
+  unsigned long u;              /* absolute value of the number */
+  char          buf[BS_INT];    /* output buffer */
 
   assert(rep && rep->file);     /* check the function arguments */
   if (num == 0) {               /* treat zero as a special case */
     fputc('0', rep->file); return 1; }
-  if (num <= INT_MIN)           /* treat INT_MIN as a special case */
-    return fwrite("-2147483648", sizeof(char), 11, rep->file);
   s = 0;                        /* default: no sign printed */
   if (num < 0) {                /* if the number is negative, */
     fputc('-', rep->file); s = 1; }   /* print a leading sign */
-  num = abs(num);               /* remove the sign (just printed) */
-  i   = BS_INT;                 /* start at the end of the buffer */
+  u = (num < 0) ? -(unsigned long)num : (unsigned long)num;
+  i = BS_INT;                   /* remove the sign (just printed) */
   do {                          /* digit output loop */
-    buf[--i] = (num % 10) +'0'; /* store the next digit and */
-    num /= 10;                  /* remove it from the number */
-  } while (num > 0);            /* while there are more digits */
+    buf[--i] = (char)(u % 10 +'0'); /* store the next digit */
+    u /= 10;                    /* and remove it from the number */
+  } while (u > 0);              /* while there are more digits */
   fwrite(buf+i, sizeof(char), BS_INT-i, rep->file);
   return BS_INT -i +s;          /* print the digits and */
 }  /* isr_intout() */           /* return the number of characters */
@@ -415,7 +416,7 @@ static int _getdec (const char *s, const char **end)
 
 /*--------------------------------------------------------------------*/
 
-int isr_sinfo (ISREPORT *rep, int supp, double eval)
+int isr_sinfo (ISREPORT *rep, SUPP supp, double eval)
 {                               /* --- print item set information */
   int        k, n = 0;          /* number of decimals, char. counter */
   double     wgt;               /* total transaction weight */
@@ -473,7 +474,8 @@ int isr_sinfox (ISREPORT *rep, double supp, double eval)
 
 /*--------------------------------------------------------------------*/
 
-int isr_rinfo (ISREPORT *rep, int supp, int body, int head, double eval)
+int isr_rinfo (ISREPORT *rep, SUPP supp, SUPP body, SUPP head,
+               double eval)
 {                               /* --- print ass. rule information */
   int        k, n = 0;          /* number of decimals, char. counter */
   double     wgt;               /* total transaction weight */
@@ -507,7 +509,7 @@ int isr_rinfo (ISREPORT *rep, int supp, int body, int head, double eval)
                      ? (supp*wgt) /(body*(double)head) : 0;
                 n += isr_dblout(rep,      lift,      k);       break;
       case 'L': lift = ((body > 0) && (head > 0))
-                     ? (supp*wgt) /(body*head) : 0;
+                     ? (supp*wgt) /(body*(double)head) : 0;
                 n += isr_dblout(rep, 100* lift,      k);       break;
       case 'e': n += isr_dblout(rep,      eval,      k);       break;
       case 'E': n += isr_dblout(rep, 100* eval,      k);       break;
@@ -28,7 +28,7 @@ typedef struct _isreport {      /* --- an item set reporter --- */
   int        cnt;               /* current number of items in set */
   int        pfx;               /* number of items in valid prefix */
   int        *items;            /* current item set (array of items) */
-  int        *supps;            /* (prefix) item sets support values */
+  SUPP       *supps;            /* (prefix) item sets support values */
   double     *sdbls;            /* ditto, as double precision values */
   int        *pexs;             /* perfect extension items */
   int        *pxpp;             /* number of perfect exts. per prefix */
@@ -64,18 +64,19 @@ extern void        isr_seteval (ISREPORT *rep, ISEVALFN eval,
 extern void        isr_setftid (ISREPORT *rep, FILE *ftid);
 extern FILE*       isr_getftid (ISREPORT *rep);
 
-extern int         isr_add     (ISREPORT *rep, int item, int supp);
+extern int         isr_add     (ISREPORT *rep, int item, SUPP supp);
 extern int         isr_addx    (ISREPORT *rep, int item, double supp);
 extern int         isr_addpex  (ISREPORT *rep, int item);
 extern int         isr_uses    (ISREPORT *rep, int item);
 extern int         isr_remove  (ISREPORT *rep, int cnt);
 extern int         isr_xable   (ISREPORT *rep);
+extern int         isr_max     (ISREPORT *rep);
 
 extern int         isr_cnt     (ISREPORT *rep);
 extern int         isr_item    (ISREPORT *rep);
 extern int         isr_itemx   (ISREPORT *rep, int index);
-extern int         isr_supp    (ISREPORT *rep);
-extern int         isr_suppx   (ISREPORT *rep, int index);
+extern SUPP        isr_supp    (ISREPORT *rep);
+extern SUPP        isr_suppx   (ISREPORT *rep, int index);
 extern double      isr_logsum  (ISREPORT *rep);
 extern double      isr_logsumx (ISREPORT *rep, int index);
 
@@ -89,10 +90,10 @@ extern double      isr_logq    (ISREPORT *rep, void *data);
 
 extern int         isr_report  (ISREPORT *rep);
 extern int         isr_reportx (ISREPORT *rep, int *tids, int n);
-extern int         isr_sinfo   (ISREPORT *rep, int supp, double eval);
+extern int         isr_sinfo   (ISREPORT *rep, SUPP supp, double eval);
 extern int         isr_sinfox  (ISREPORT *rep, double supp,double eval);
-extern int         isr_rinfo   (ISREPORT *rep, int supp,
-                                int body, int head, double eval);
+extern int         isr_rinfo   (ISREPORT *rep, SUPP supp,
+                                SUPP body, SUPP head, double eval);
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -105,6 +106,7 @@ extern int         isr_rinfo   (ISREPORT *rep, int supp,
 
 #define isr_uses(r,i)     ((r)->pxpp[i] < 0)
 #define isr_xable(r)      ((r)->cnt < (r)->max)
+#define isr_max(r)        ((r)->max)
 
 #define isr_cnt(r)        ((r)->cnt)
 #define isr_item(r)       ((r)->items[(r)->cnt -1])
@@ -115,7 +117,7 @@ extern int         isr_rinfo   (ISREPORT *rep, int supp,
 #define isr_logsumx(r,i)  ((r)->sums [i])
 
 #define isr_pexcnt(r)     ((int)((r)->pxpp -(r)->pexs))
-#define isr_pex(r,t)      ((r)->pexs [i])
+#define isr_pex(r,i)      ((r)->pexs [i])
 
 #define isr_name(r,i)     ((r)->names[i])
 #define isr_log(r,i)      ((r)->logs [i])
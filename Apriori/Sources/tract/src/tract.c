@@ -14,13 +14,14 @@
 #define BLKSIZE     256         /* block size for enlarging arrays */
 
 #ifdef ARCH64
-#define CHOFF(n)    ((n) +1 -((n) & 1))
+#define CHOFF(n)    ((n) +((n) & 1))
 #else
 #define CHOFF(n)    (n)
 #endif
-/* The item array offset to the child node array must be odd for */
-/* a 64 bit architecture, because this offset +3 must be an even */
-/* number, as there are three int fields before the items array. */
+/* The item array offset to the child node array must be even for */
+/* a 64 bit architecture, because this offset +4 must be an even  */
+/* number, as the weight (SUPP, which occupies two int slots) and */
+/* two int fields precede the items array.                        */
 
 /*----------------------------------------------------------------------
   Constants
@@ -116,8 +117,8 @@ static int _nocmp (const void *p1, const void *p2, void *data)
   const ITEM *a = p1, *b = p2;  /* type the item pointers */
   if (a->app == APP_NONE)   return (b->app == APP_NONE)   ? 0 : 1;
   if (b->app == APP_NONE)   return -1;
-  if (a->frq < *(int*)data) return (b->frq < *(int*)data) ? 0 : 1;
-  if (b->frq < *(int*)data) return -1;
+  if (a->frq < *(SUPP*)data)return (b->frq < *(SUPP*)data)? 0 : 1;
+  if (b->frq < *(SUPP*)data)return -1;
   return a->id -b->id;          /* return sign of identifier diff. */
 }  /* _nocmp() */
 
@@ -128,9 +129,10 @@ static int _asccmp (const void *p1, const void *p2, void *data)
   const ITEM *a = p1, *b = p2;  /* type the item pointers */
   if (a->app == APP_NONE)   return (b->app == APP_NONE)   ? 0 : 1;
   if (b->app == APP_NONE)   return -1;
-  if (a->frq < *(int*)data) return (b->frq < *(int*)data) ? 0 : 1;
-  if (b->frq < *(int*)data) return -1;
-  return a->frq -b->frq;        /* return sign of frequency diff. */
+  if (a->frq < *(SUPP*)data)return (b->frq < *(SUPP*)data)? 0 : 1;
+  if (b->frq < *(SUPP*)data)return -1;
+  if (a->frq > b->frq) return  1; /* return sign of frequency diff. */
+  return (a->frq < b->frq) ? -1 : 0;
 }  /* _asccmp() */
 
 /*--------------------------------------------------------------------*/
@@ -140,9 +142,10 @@ static int _descmp (const void *p1, const void *p2, void *data)
   const ITEM *a = p1, *b = p2;  /* type the item pointers */
   if (a->app == APP_NONE)   return (b->app == APP_NONE)   ? 0 : 1;
   if (b->app == APP_NONE)   return -1;
-  if (a->frq < *(int*)data) return (b->frq < *(int*)data) ? 0 : 1;
-  if (b->frq < *(int*)data) return -1;
-  return b->frq -a->frq;        /* return sign of frequency diff. */
+  if (a->frq < *(SUPP*)data)return (b->frq < *(SUPP*)data)? 0 : 1;
+  if (b->frq < *(SUPP*)data)return -1;
+  if (a->frq < b->frq) return  1; /* return sign of frequency diff. */
+  return (a->frq > b->frq) ? -1 : 0;
 }  /* _descmp() */
 
 /*--------------------------------------------------------------------*/
@@ -152,9 +155,10 @@ static int _asccmpx (const void *p1, const void *p2, void *data)
   const ITEM *a = p1, *b = p2;  /* type the item pointers */
   if (a->app == APP_NONE)   return (b->app == APP_NONE)   ? 0 : 1;
   if (b->app == APP_NONE)   return -1;
-  if (a->frq < *(int*)data) return (b->frq < *(int*)data) ? 0 : 1;
-  if (b->frq < *(int*)data) return -1;
-  return a->xfq -b->xfq;        /* return sign of frequency diff. */
+  if (a->frq < *(SUPP*)data)return (b->frq < *(SUPP*)data)? 0 : 1;
+  if (b->frq < *(SUPP*)data)return -1;
+  if (a->xfq > b->xfq) return  1; /* return sign of frequency diff. */
+  return (a->xfq < b->xfq) ? -1 : 0;
 }  /* _asccmpx() */
 
 /*--------------------------------------------------------------------*/
@@ -164,9 +168,10 @@ static int _descmpx (const void *p1, const void *p2, void *data)
   const ITEM *a = p1, *b = p2;  /* type the pointers */
   if (a->app == APP_NONE)   return (b->app == APP_NONE)   ? 0 : 1;
   if (b->app == APP_NONE)   return -1;
-  if (a->frq < *(int*)data) return (b->frq < *(int*)data) ? 0 : 1;
-  if (b->frq < *(int*)data) return -1;
-  return b->xfq -a->xfq;        /* return sign of frequency diff. */
+  if (a->frq < *(SUPP*)data)return (b->frq < *(SUPP*)data)? 0 : 1;
+  if (b->frq < *(SUPP*)data)return -1;
+  if (a->xfq < b->xfq) return  1; /* return sign of frequency diff. */
+  return (a->xfq > b->xfq) ? -1 : 0;
 }  /* _descmpx() */
 
 /*----------------------------------------------------------------------
@@ -317,7 +322,8 @@ int ib_readpen (ITEMBASE *base, FILE *file)
 
 int ib_read (ITEMBASE *base, FILE *file)
 {                               /* --- read a transaction */
-  int   i, d, x;                /* loop variable, delimiter, buffer */
+  int   i, d;                   /* loop variable, delimiter */
+  SUPP  x;                      /* extended frequency weight */
   char  *buf;                   /* read buffer */
   ITEM  *item;                  /* pointer to an item */
   TRACT *t;                     /* to access the transaction buffer */
@@ -359,13 +365,13 @@ void ib_penfrq (ITEMBASE *base)
   assert(base);                 /* check the function argument */
   for (i = nim_cnt(base->nimap); --i >= 0; ) {
     item = (ITEM*)nim_byid(base->nimap, i);
-    item->frq += (int)ceil(item->pen *base->wgt);
+    item->frq += (SUPP)ceil(item->pen *base->wgt);
   }                             /* recompute item frequencies */
 }  /* ib_penfrq() */
 
 /*--------------------------------------------------------------------*/
 
-int ib_recode (ITEMBASE *base, int minfrq, int dir, int *map)
+int ib_recode (ITEMBASE *base, SUPP minfrq, int dir, int *map)
 {                               /* --- recode items w.r.t. frequency */
   int   i, n, x;                /* loop variables, item buffer */
   ITEM  *item;                  /* to traverse the items */
@@ -422,7 +428,7 @@ void ib_trunc (ITEMBASE *base, int cnt)
   Transaction Functions
 ----------------------------------------------------------------------*/
 
-TRACT* t_create (const int *items, int n, int wgt)
+TRACT* t_create (const int *items, int n, SUPP wgt)
 {                               /* --- create a transaction */
   TRACT *t;                     /* created transaction */
 
@@ -631,9 +637,10 @@ int tb_reduce (TABAG *bag)
 
 /*--------------------------------------------------------------------*/
 
-int tb_occur (TABAG *bag, const int *items, int n)
+SUPP tb_occur (TABAG *bag, const int *items, int n)
 {                               /* --- count transaction occurrences */
-  int l, r, m, k;               /* index and loop variables */
+  int  l, r, m, k;              /* index and loop variables */
+  SUPP s;                       /* sum of transaction weights */
 
   assert(bag && items);         /* check the function arguments */
   k = bag->cnt;                 /* get the number of transactions */
@@ -647,9 +654,9 @@ int tb_occur (TABAG *bag, const int *items, int n)
     if (t_cmpx(bag->tracts[m], items, n) < 0) l = m+1;
     else                                      k = m;
   }
-  for (k = 0; l < r; l++)       /* traverse the found section and */
-    k += bag->tracts[l]->wgt;   /* sum the transaction weights */
-  return k;                     /* return the number of occurrences */
+  for (s = 0; l < r; l++)       /* traverse the found section and */
+    s += bag->tracts[l]->wgt;   /* sum the transaction weights */
+  return s;                     /* return the number of occurrences */
 }  /* tb_occur() */
 
 /*--------------------------------------------------------------------*/
@@ -668,10 +675,10 @@ void tb_show (TABAG *bag, int wgt)
       printf(ib_name(bag->base, t->items[k]));
     }                           /* print the next item */
     if (wgt)                    /* print the transaction weight */
-      printf("%c[%d]", bag->base->chars[1], t->wgt);
+      printf("%c[" SUPP_FMT "]", bag->base->chars[1], t->wgt);
     fputc(bag->base->chars[2], stdout);
   }                             /* terminate the transaction */
-  printf("%d/%d transaction(s)\n", bag->cnt, bag->wgt);
+  printf("%d/" SUPP_FMT " transaction(s)\n", bag->cnt, bag->wgt);
 }  /* tb_show() */              /* finally print the number of t.a. */
 
 #endif
@@ -695,8 +702,9 @@ void _delete (TTNODE *root)
 
 TTNODE* _create (TRACT **tracts, int cnt, int index)
 {                               /* --- recursive part of tt_create() */
-  int    i, k, t, w;            /* loop variables, buffers */
+  int    i, k, t;               /* loop variables, buffers */
   int    item, n;               /* item and item counter */
+  SUPP   w;                     /* total weight of transactions */
   TTNODE *root;                 /* root of created transaction tree */
   TTNODE **cnds;                /* array of child nodes */
   int    *s, *d;                /* to traverse the items */
@@ -823,7 +831,7 @@ int tt_extcnt (TATREE *tree)
 /*--------------------------------------------------------------------*/
 #ifdef ARCH64
 
-TTNODE* ttn_child (TTNODE *node, int index)
+TTNODE* ttn_child (const TTNODE *node, int index)
 {                               /* --- go to a child node */
   assert(node                   /* check the function arguments */
      && (index >= 0) && (index < node->size));
@@ -843,10 +851,10 @@ void _show (TTNODE *node, ITEMBASE *base, int ind)
   if (node->size <= 0) {        /* if this is a leaf node */
     for (i = 0; i < node->max; i++)
       printf("%s ", ib_name(base, node->items[i]));
-    printf("[%d]\n", node->wgt);
+    printf("[" SUPP_FMT "]\n", node->wgt);
     return;                     /* print the items in the */
   }                             /* (rest of) the transaction */
-  cnds = (TTNODE**)(node->items +node->size);
+  cnds = (TTNODE**)(node->items +CHOFF(node->size));
   for (i = 0; i < node->size; i++) {
     if (i > 0) for (k = ind; --k >= 0; ) printf("  ");
     printf("%s ", ib_name(base, node->items[i]));
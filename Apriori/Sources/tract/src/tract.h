@@ -4,6 +4,7 @@
 #ifndef NIMAPFN
 #define NIMAPFN
 #endif
+#include <limits.h>
 #include "arrays.h"
 #include "symtab.h"
 #include "tabscan.h"
@@ -17,6 +18,25 @@
 #define APP_HEAD    0x02        /* item may appear in rule head */
 #define APP_BOTH    (APP_HEAD|APP_BODY)
 
+/* --- support values --- */
+/* SUPP has 64 bits: a long on LP64 platforms, otherwise (32 bit and */
+/* LLP64, i.e. 64 bit Windows) long long or __int64, which are not    */
+/* ANSI C89, so gcc -ansi -pedantic warns about SUPP_FMT there.       */
+#if   LONG_MAX > 0x7fffffffL    /* if a long has 64 bits */
+#define SUPP_TYPE   long        /* type for support values */
+#define SUPP_MAX    LONG_MAX    /* maximal support value */
+#define SUPP_FMT    "%ld"       /* printf() format for support values */
+#elif defined _WIN32            /* if LLP64 or 32 bit Windows */
+#define SUPP_TYPE   __int64     /* type for support values */
+#define SUPP_MAX    ((SUPP)((((SUPP)1 << 62) -1) *2 +1))
+#define SUPP_FMT    "%I64d"     /* printf() format for support values */
+#else                           /* if other 32 bit systems */
+#define SUPP_TYPE   long long   /* type for support values */
+#define SUPP_MAX    ((SUPP)((((SUPP)1 << 62) -1) *2 +1))
+#define SUPP_FMT    "%lld"      /* printf() format for support values */
+#endif
+#define SUPP_MIN    (-SUPP_MAX-1) /* minimal support value (sign bit) */
+
 /* --- error codes --- */
 #define E_NONE         0        /* no error */
 #define E_NOMEM      (-1)       /* not enough memory */
@@ -35,17 +55,22 @@
 /*----------------------------------------------------------------------
   Type Definitions
 ----------------------------------------------------------------------*/
+#if defined __GNUC__ && (LONG_MAX <= 0x7fffffffL)
+__extension__                   /* long long is not ANSI C89 */
+#endif
+typedef SUPP_TYPE SUPP;         /* support values and weights */
+
 typedef struct {                /* --- an item --- */
   int      id;                  /* item identifier */
-  int      frq;                 /* frequency in transactions */
-  int      xfq;                 /* extended frequency (trans. sizes) */
+  SUPP     frq;                 /* frequency in transactions */
+  SUPP     xfq;                 /* extended frequency (trans. sizes) */
   int      app;                 /* appearance indicator */
   double   pen;                 /* insertion penalty */
 } ITEM;                         /* (item) */
 
 typedef struct {                /* --- a transaction --- */
   int      size;                /* size   (number of items) */
-  int      wgt;                 /* weight (number of occurrences) */
+  SUPP     wgt;                 /* weight (number of occurrences) */
   int      items[1];            /* items in the transaction */
 } TRACT;                        /* (transaction) */
 
@@ -53,7 +78,7 @@ typedef struct {                /* --- an item base --- */
   NIMAP    *nimap;              /* name/identifier map */
   TABSCAN  *tscan;              /* table scanner */
   char     chars[4];            /* special characters */
-  int      wgt;                 /* total weight of transactions */
+  SUPP     wgt;                 /* total weight of transactions */
   int      app;                 /* default appearance indicator */
   double   pen;                 /* default insertion penalty */
   int      size;                /* size of the transaction buffer */
@@ -63,14 +88,14 @@ typedef struct {                /* --- an item base --- */
 typedef struct {                /* --- a transaction bag/multiset --- */
   ITEMBASE *base;               /* underlying item base */
   int      max;                 /* number of items in largest trans. */
-  int      wgt;                 /* total weight of transactions */
+  SUPP     wgt;                 /* total weight of transactions */
   int      size;                /* size of the transaction array */
   int      cnt;                 /* number of transactions */
   TRACT    **tracts;            /* transaction array */
 } TABAG;                        /* (transaction bag/multiset) */
 
 typedef struct {                /* --- a transaction tree node --- */
-  int      wgt;                 /* weight (number of transactions) */
+  SUPP     wgt;                 /* weight (number of transactions) */
   int      max;                 /* number of items in largest trans. */
   int      size;                /* node size (number of children) */
   int      items[1];            /* next items in rep. transactions */
@@ -97,16 +122,16 @@ extern int         ib_add     (ITEMBASE *base, const char *name);
 extern int         ib_item    (ITEMBASE *base, const char *name);
 extern const char* ib_name    (ITEMBASE *base, int item);
 
-extern int         ib_getwgt  (ITEMBASE *base);
-extern int         ib_setwgt  (ITEMBASE *base, int cnt);
-extern int         ib_incwgt  (ITEMBASE *base, int cnt);
+extern SUPP        ib_getwgt  (ITEMBASE *base);
+extern SUPP        ib_setwgt  (ITEMBASE *base, SUPP cnt);
+extern SUPP        ib_incwgt  (ITEMBASE *base, SUPP cnt);
 
-extern int         ib_getfrq  (ITEMBASE *base, int item);
-extern int         ib_setfrq  (ITEMBASE *base, int item, int frq);
-extern int         ib_incfrq  (ITEMBASE *base, int item, int frq);
-extern int         ib_getxfq  (ITEMBASE *base, int item);
-extern int         ib_setxfq  (ITEMBASE *base, int item, int frq);
-extern int         ib_incxfq  (ITEMBASE *base, int item, int frq);
+extern SUPP        ib_getfrq  (ITEMBASE *base, int item);
+extern SUPP        ib_setfrq  (ITEMBASE *base, int item, SUPP frq);
+extern SUPP        ib_incfrq  (ITEMBASE *base, int item, SUPP frq);
+extern SUPP        ib_getxfq  (ITEMBASE *base, int item);
+extern SUPP        ib_setxfq  (ITEMBASE *base, int item, SUPP frq);
+extern SUPP        ib_incxfq  (ITEMBASE *base, int item, SUPP frq);
 extern int         ib_getapp  (ITEMBASE *base, int item);
 extern int         ib_setapp  (ITEMBASE *base, int item, int app);
 extern double      ib_getpen  (ITEMBASE *base, int item);
@@ -117,7 +142,7 @@ extern int         ib_readpen (ITEMBASE *base, FILE *file);
 extern int         ib_read    (ITEMBASE *base, FILE *file);
 
 extern void        ib_penfrq  (ITEMBASE *base);
-extern int         ib_recode  (ITEMBASE *base, int minfrq,
+extern int         ib_recode  (ITEMBASE *base, SUPP minfrq,
                                int dir, int *map);
 extern void        ib_trunc   (ITEMBASE *base, int cnt);
 
@@ -126,13 +151,13 @@ extern TRACT*      ib_tract   (ITEMBASE *base);
 /*----------------------------------------------------------------------
   Transaction Functions
 ----------------------------------------------------------------------*/
-extern TRACT*      t_create   (const int *items, int n, int wgt);
+extern TRACT*      t_create   (const int *items, int n, SUPP wgt);
 extern void        t_delete   (TRACT *t);
 extern TRACT*      t_clone    (const TRACT *t);
 
 extern const int*  t_items    (const TRACT *t);
 extern int         t_size     (const TRACT *t);
-extern int         t_wgt      (const TRACT *t);
+extern SUPP        t_wgt      (const TRACT *t);
 
 extern void        t_sort     (TRACT *t);
 extern void        t_reverse  (TRACT *t);
@@ -149,12 +174,12 @@ extern void        tb_delete  (TABAG *bag, int delis);
 extern ITEMBASE*   tb_base    (TABAG *bag);
 
 extern int         tb_cnt     (TABAG *bag);
-extern int         tb_wgt     (TABAG *bag);
+extern SUPP        tb_wgt     (TABAG *bag);
 extern int         tb_max     (TABAG *bag);
 
 extern int         tb_add     (TABAG *bag, TRACT *t);
 extern int         tb_addx    (TABAG *bag,
-                               const int *items, int n, int wgt);
+                               const int *items, int n, SUPP wgt);
 extern TRACT*      tb_tract   (TABAG *bag, int index);
 
 extern void        tb_recode  (TABAG *bag, int *map);
@@ -163,7 +188,8 @@ extern void        tb_itsort  (TABAG *bag, int dir, int heap);
 extern void        tb_sort    (TABAG *bag, int dir, int heap);
 extern int         tb_reduce  (TABAG *bag);
 extern void        tb_shuffle (TABAG *bag, double randfn(void));
-extern int         tb_occur   (TABAG *bag, const int *items, int n);
+extern void        tb_select  (TABAG *bag, int k, double randfn(void));
+extern SUPP        tb_occur   (TABAG *bag, const int *items, int n);
 
 #ifndef NDEBUG
 extern void        tb_show    (TABAG *bag, int wgt);
@@ -179,7 +205,7 @@ extern ITEMBASE*   tt_base    (TATREE *tree);
 extern TTNODE*     tt_root    (TATREE *tree);
 extern int         tt_nodecnt (TATREE *tree);
 extern int         tt_extcnt  (TATREE *tree);
-extern int         tt_wgt     (TATREE *tree);
+extern SUPP        tt_wgt     (TATREE *tree);
 extern int         tt_max     (TATREE *tree);
 
 #ifndef NDEBUG
@@ -189,12 +215,12 @@ extern void        tt_show    (TATREE *tree);
 /*----------------------------------------------------------------------
   Transaction Tree Node Functions
 ----------------------------------------------------------------------*/
-extern int         ttn_wgt    (TATREE *tree);
+extern SUPP        ttn_wgt    (TATREE *tree);
 extern int         ttn_max    (TATREE *tree);
 extern int         ttn_size   (TATREE *tree);
 extern int*        ttn_items  (TATREE *tree);
 extern int         ttn_item   (TATREE *tree, int index);
-extern TTNODE*     ttn_child  (TATREE *tree, int index);
+extern TTNODE*     ttn_child  (const TTNODE *node, int index);
 
 /*----------------------------------------------------------------------
   Preprocessor Definitions
@@ -241,6 +267,7 @@ extern TTNODE*     ttn_child  (TATREE *tree, int index);
 #define tb_tract(b,i)     ((b)->tracts[i])
 
 #define tb_shuffle(b,f)   ptr_shuffle((b)->tracts, (b)->cnt, f)
+#define tb_select(b,k,f)  ptr_select ((b)->tracts, (b)->cnt, k, f)
 
 /*--------------------------------------------------------------------*/
 #define tt_base(t)        ((t)->base)